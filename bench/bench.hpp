@@ -0,0 +1,54 @@
+#ifndef PMIGSVHINDCVFNMGBGQG
+#define PMIGSVHINDCVFNMGBGQG
+// Timing harness shared by the benchmarks.
+#include <chrono>
+#include <cstdio>
+
+// Returns the wall-clock time of a single call to `f`, in seconds.
+template<class F>
+double seconds(F f) {
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    f();
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - start).count()) / 1e9;
+}
+
+// Prints one result line: the time per call, in whichever unit keeps it
+// readable, and the throughput if each call processes `bytes` bytes.
+inline void report(const char* name, double s, double calls,
+                   double bytes = 0) {
+    double t = s / calls;
+    const char* unit = "s ";
+    if (t < 1e-6) {
+        t *= 1e9;
+        unit = "ns";
+    } else if (t < 1e-3) {
+        t *= 1e6;
+        unit = "us";
+    } else if (t < 1) {
+        t *= 1e3;
+        unit = "ms";
+    }
+    if (bytes)
+        std::printf("%-40s %8.1f %s %8.3f GB/s\n", name, t, unit,
+                    bytes * calls / s / 1e9);
+    else
+        std::printf("%-40s %8.1f %s\n", name, t, unit);
+}
+
+// Calls `f(i)` for each `i` in `[0, calls)` and reports the time per call.
+// `f` must fold its results into a global so that the work is not
+// optimized away.  Returns the total time in seconds.
+template<class F>
+double run(const char* name, long calls, F f, double bytes = 0) {
+    const double s = seconds([&] {
+        for (long i = 0; i != calls; ++i)
+            f(i);
+    });
+    report(name, s, static_cast<double>(calls), bytes);
+    return s;
+}
+
+#endif
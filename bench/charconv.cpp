@@ -0,0 +1,76 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include <calico/charconv.hpp>
+#include <calico/string.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Prevents the optimizer from discarding the results.
+std::size_t sink;
+
+// Times `repeats` calls of `f(text)`.
+template<class F>
+void run_on(const char* name, const std::string& text, long repeats, F f) {
+    run(name, repeats, [&](long) { sink += f(text); },
+        static_cast<double>(text.size()));
+}
+
+// One stream extraction per field, as with the original `parse`.
+template<class T>
+std::size_t per_field_stream(const std::string& text) {
+    std::vector<T> values;
+    for (string_ref field : tokenize(text, ",\n")) {
+        std::istringstream stream(field.str());
+        T value;
+        stream >> value;
+        values.push_back(value);
+    }
+    return values.size();
+}
+
+// One `from_chars` per field with a separate delimiter scan.
+template<class T>
+std::size_t per_field(const std::string& text) {
+    std::vector<T> values;
+    for (string_ref field : tokenize(text, ",\n")) {
+        T value;
+        from_chars(field.begin(), field.end(), value);
+        values.push_back(value);
+    }
+    return values.size();
+}
+
+template<class T>
+std::size_t column(const std::string& text) {
+    std::vector<T> values;
+    parse_column(text.data(), text.data() + text.size(), values);
+    return values.size();
+}
+
+int main() {
+    std::string ints, uints, doubles;
+    std::uint64_t state = 1;
+    for (int i = 0; i != 1000000; ++i) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        const char sep = i % 8 == 7 ? '\n' : ',';
+        to_chars_append(ints, static_cast<int>(state >> 33) >> (state & 31));
+        ints += sep;
+        to_chars_append(uints, static_cast<std::uint32_t>(state >> 32));
+        uints += sep;
+        to_chars_append(doubles,
+                        static_cast<double>(state >> 11) / 9007199254740992.0
+                        * 1000.0);
+        doubles += sep;
+    }
+
+    run_on("int: stream per field", ints, 1, per_field_stream<int>);
+    run_on("int: from_chars per field", ints, 10, per_field<int>);
+    run_on("int: parse_column", ints, 10, column<int>);
+    run_on("uint32: from_chars per field", uints, 10, per_field<unsigned>);
+    run_on("uint32: parse_column", uints, 10, column<unsigned>);
+    run_on("double: stream per field", doubles, 1, per_field_stream<double>);
+    run_on("double: from_chars per field", doubles, 5, per_field<double>);
+    run_on("double: parse_column", doubles, 5, column<double>);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <calico/csv.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Prevents the optimizer from discarding the results.
+double sink;
+
+int main() {
+    std::string text;
+    for (int i = 0; text.size() < 50000000; ++i) {
+        text += to_string(i);
+        text += ",\"item ";
+        text += to_string(i % 1000);
+        text += "\",";
+        text += to_string(i * 0.25);
+        text += ',';
+        text += to_string(i % 7 - 3);
+        text += '\n';
+    }
+    std::printf("%zu bytes\n", text.size());
+    const double bytes = static_cast<double>(text.size());
+
+    // The previous approach: split each line and parse each field.
+    run("getline + split + parse", 1, [&](long) {
+        std::istringstream stream(text);
+        std::string line;
+        double total = 0;
+        while (std::getline(stream, line)) {
+            std::vector<std::string> fields;
+            for (string_ref field : split(line, ','))
+                fields.push_back(field.str());
+            std::tuple<int, std::string, double, int> row(
+                parse<int>(fields[0]), fields[1],
+                parse<double>(fields[2]), parse<int>(fields[3]));
+            total += std::get<2>(row);
+        }
+        sink += total;
+    }, bytes);
+    run("csv_reader (rows)", 1, [&](long) {
+        csv_reader<int, std::string, double, int> reader(text);
+        double total = 0;
+        for (const auto& row : reader)
+            total += std::get<2>(row);
+        sink += total;
+    }, bytes);
+    run("csv_reader (string_ref rows)", 1, [&](long) {
+        csv_reader<int, string_ref, double, int> reader(text);
+        double total = 0;
+        for (const auto& row : reader)
+            total += std::get<2>(row);
+        sink += total;
+    }, bytes);
+    run("csv_reader (read_columns)", 1, [&](long) {
+        csv_reader<int, std::string, double, int> reader(text);
+        csv_reader<int, std::string, double, int>::columns_type columns;
+        reader.read_columns(columns);
+        double total = 0;
+        for (double x : std::get<2>(columns))
+            total += x;
+        sink += total;
+    }, bytes);
+    return sink == 0;
+}
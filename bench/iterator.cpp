@@ -0,0 +1,54 @@
+#include <string>
+#include <tuple>
+#include <vector>
+#include <calico/iterator.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Prevents the optimizer from discarding the results.
+double sink;
+
+int main() {
+    const long reps = 20;
+    const std::size_t n = 1 << 22;
+    std::vector<float> x(n), y(n);
+    for (std::size_t i = 0; i != n; ++i)
+        x[i] = static_cast<float>(i % 100);
+
+    // y += a * x, which should cost the same however it is written
+    const float a = 0.5f;
+    run("saxpy: indexed", reps, [&](long) {
+        for (std::size_t i = 0; i != n; ++i)
+            y[i] += a * x[i];
+        sink += y[n / 2];
+    });
+    run("saxpy: zip", reps, [&](long) {
+        for (auto&& t : zip(x, y))
+            std::get<1>(t) += a * std::get<0>(t);
+        sink += y[n / 2];
+    });
+
+    // A search that looks at each result twice, with a function whose calls
+    // the compiler cannot merge.
+    auto label = [](float v) {
+        return std::string(static_cast<std::size_t>(v) % 64 + 16, 'x');
+    };
+    const std::vector<float> small(x.begin(), x.begin() + (n >> 4));
+    run("max search: transform", reps, [&](long) {
+        const auto r = transform(small, label);
+        std::size_t best = 0;
+        for (auto i = r.begin(); i != r.end(); ++i)
+            if (i->size() > best)
+                best = i->size();
+        sink += static_cast<double>(best);
+    });
+    run("max search: cached transform", reps, [&](long) {
+        const auto r = transform(small, label, cache_tag());
+        std::size_t best = 0;
+        for (auto i = r.begin(); i != r.end(); ++i)
+            if (i->size() > best)
+                best = i->size();
+        sink += static_cast<double>(best);
+    });
+    return sink == 0;
+}
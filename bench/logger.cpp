@@ -0,0 +1,74 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <calico/format.hpp>
+#include <calico/logger.hpp>
+#include <calico/string.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Prevents the optimizer from discarding the results.
+std::size_t sink;
+
+int main() {
+    const long n = 1000000;
+    const std::string path = "/api/v1/items";
+    std::string buf;
+
+    // What the request thread pays when formatting synchronously.
+    run("format_str (synchronous)", n, [&](long i) {
+        sink += format_str("request %ld %s took %.3f ms", i, path.c_str(),
+                           0.25 * i).size();
+    });
+    run("format_append (synchronous)", n, [&](long i) {
+        buf.clear();
+        format_append(buf, "request {} {} took {} ms", i, path, 0.25 * i);
+        sink += buf.size();
+    });
+
+    // The producer side of the logger, measured over bursts that fit in the
+    // ring so that the producer never waits for the background thread.  The
+    // sink discards the output.
+    std::size_t written = 0;
+    {
+        logger log([&](string_ref s) { written += s.size(); }, 1 << 26,
+                   log_overflow::block);
+        log.log("warm-up");
+        log.flush();
+        run("logger::log (producer)", n, [&](long i) {
+            log.log("request {} {} took {} ms", i, path, 0.25 * i);
+        });
+        log.flush();
+        run("logger::log (producer, no args)", n, [&](long) {
+            log.log("request finished");
+        });
+        report("  flush (background formatting)",
+               seconds([&] { log.flush(); }), 1);
+    }
+
+    // Four producers at once, each with its own ring.
+    {
+        logger log([&](string_ref s) { written += s.size(); }, 1 << 25,
+                   log_overflow::block);
+        std::vector<std::thread> threads;
+        // give each thread its ring before starting the clock
+        for (int t = 0; t != 4; ++t)
+            threads.emplace_back([&log] { log.log("warm-up"); });
+        for (std::thread& thread : threads)
+            thread.join();
+        threads.clear();
+        const double s = seconds([&] {
+            for (int t = 0; t != 4; ++t)
+                threads.emplace_back([&log, &path, n] {
+                    for (long i = 0; i != n / 4; ++i)
+                        log.log("request {} {} took {} ms", i, path,
+                                0.25 * i);
+                });
+            for (std::thread& thread : threads)
+                thread.join();
+        });
+        report("logger::log (4 threads, wall)", s, static_cast<double>(n));
+    }
+    sink += written;
+    return sink == 0;
+}
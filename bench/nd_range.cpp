@@ -0,0 +1,70 @@
+#include <vector>
+#include <calico/nd_range.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Prevents the optimizer from discarding the results.
+double sink;
+
+int main() {
+    const long reps = 5;
+    const std::size_t n = 4096;
+    std::vector<double> a(n * n), b(n * n);
+    for (std::size_t k = 0; k != a.size(); ++k)
+        a[k] = static_cast<double>(k % 1000);
+
+    // Row-major traversal should cost the same as the nested loops.
+    run("sum: nested loops", reps, [&](long) {
+        double s = 0;
+        for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+                s += a[i * n + j];
+        sink += s;
+    });
+    run("sum: nd_range", reps, [&](long) {
+        double s = 0;
+        for (const auto& i : nd_range<2>({n, n}))
+            s += a[i[0] * n + i[1]];
+        sink += s;
+    });
+    run("sum: nd_range::for_each", reps, [&](long) {
+        double s = 0;
+        nd_range<2>({n, n}).for_each([&](
+            const std::array<std::size_t, 2>& i) {
+            s += a[i[0] * n + i[1]];
+        });
+        sink += s;
+    });
+
+    // A transpose reads one matrix along rows and writes the other along
+    // columns, so one of the two always misses the cache without tiling.
+    run("transpose: nested loops", reps, [&](long) {
+        for (std::size_t i = 0; i != n; ++i)
+            for (std::size_t j = 0; j != n; ++j)
+                b[j * n + i] = a[i * n + j];
+        sink += b[n + 3];
+    });
+    run("transpose: nd_range", reps, [&](long) {
+        for (const auto& i : nd_range<2>({n, n}))
+            b[i[1] * n + i[0]] = a[i[0] * n + i[1]];
+        sink += b[n + 3];
+    });
+    run("transpose: nd_range (tiled)", reps, [&](long) {
+        for (const auto& i : nd_range<2>({n, n}).tiled())
+            b[i[1] * n + i[0]] = a[i[0] * n + i[1]];
+        sink += b[n + 3];
+    });
+    run("transpose: nd_range::for_each (tiled)", reps, [&](long) {
+        nd_range<2>({n, n}).tiled().for_each([&](
+            const std::array<std::size_t, 2>& i) {
+            b[i[1] * n + i[0]] = a[i[0] * n + i[1]];
+        });
+        sink += b[n + 3];
+    });
+    run("transpose: collapse (tiled)", reps, [&](long) {
+        for (const auto& i : nd_range<2>({n, n}).tiled().collapse())
+            b[i[1] * n + i[0]] = a[i[0] * n + i[1]];
+        sink += b[n + 3];
+    });
+    return sink == 0;
+}
@@ -0,0 +1,70 @@
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <calico/parallel.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Prevents the optimizer from discarding the results.
+double sink;
+
+// A compute-bound kernel whose cost varies with the index, so that static
+// partitioning would leave threads idle.
+double kernel(long i) {
+    double x = static_cast<double>(i);
+    const long n = 16 + (i % 64);
+    for (long k = 0; k != n; ++k)
+        x = std::sqrt(x + static_cast<double>(k));
+    return x;
+}
+
+int main() {
+    const long n = 2000000;
+    std::vector<double> out(static_cast<std::size_t>(n));
+    const double serial = seconds([&] {
+        for (long i = 0; i != n; ++i)
+            out[static_cast<std::size_t>(i)] = kernel(i);
+    });
+    sink += out[12345];
+    report("serial loop", serial, 1);
+
+    unsigned max_threads = std::thread::hardware_concurrency();
+    if (max_threads < 1)
+        max_threads = 1;
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < max_threads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(max_threads);
+    for (unsigned threads : counts) {
+        thread_pool pool(threads);
+        const double s = seconds([&] {
+            parallel_for(pool, integer_range(n), [&](
+                const iterator_range<integer_iterator<long> >& piece) {
+                for (long i : piece)
+                    out[static_cast<std::size_t>(i)] = kernel(i);
+            });
+        });
+        sink += out[54321];
+        char name[40];
+        std::snprintf(name, sizeof(name), "parallel_for, %2u threads (%.2fx)",
+                      threads, serial / s);
+        report(name, s, 1);
+    }
+
+    // The overhead of a loop that is too small to be worth splitting.
+    thread_pool& pool = thread_pool::default_pool();
+    std::atomic<long> total(0);
+    const int loops = 100000;
+    const double s = seconds([&] {
+        for (int k = 0; k != loops; ++k)
+            parallel_for(pool, integer_range(16L), [&](
+                const iterator_range<integer_iterator<long> >& piece) {
+                total += static_cast<long>(piece.size());
+            }, 16);
+    });
+    sink += static_cast<double>(total);
+    report("empty parallel_for", s, loops);
+    return sink == 0;
+}
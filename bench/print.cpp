@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <unistd.h>
+#include <calico/format.hpp>
+#include <calico/print.hpp>
+#include <calico/string.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Times one call of `f` that writes `lines` lines.
+template<class F>
+void run_lines(const char* name, long lines, F f) {
+    report(name, seconds(f), static_cast<double>(lines));
+}
+
+// Writes lines of the form "<id> GET /index.html <status> <ms>" to
+// /dev/null.  The number of lines can be given as an argument (the default
+// is 10 million; pass 100000000 for the full comparison).
+int main(int argc, char** argv) {
+    const long n = argc > 1 ? std::atol(argv[1]) : 10000000;
+    const char* path = "/index.html";
+
+    run_lines("ofstream << format_str", n / 10, [&] {
+        std::ofstream out("/dev/null");
+        for (long i = 0; i != n / 10; ++i)
+            out << format_str("%ld GET %s %d %.3f\n", i, path, 200,
+                              0.125 * static_cast<double>(i % 1000));
+    });
+    run_lines("ofstream << format", n, [&] {
+        std::ofstream out("/dev/null");
+        for (long i = 0; i != n; ++i)
+            out << format("{} GET {} {} {}\n", i, path, 200,
+                          0.125 * static_cast<double>(i % 1000));
+    });
+    run_lines("ofstream <<", n, [&] {
+        std::ofstream out("/dev/null");
+        for (long i = 0; i != n; ++i)
+            out << i << " GET " << path << ' ' << 200 << ' '
+                << 0.125 * static_cast<double>(i % 1000) << '\n';
+    });
+    const int fd = ::open("/dev/null", O_WRONLY);
+    run_lines("print(fd_writer&)", n, [&] {
+        fd_writer out(fd);
+        for (long i = 0; i != n; ++i)
+            print(out, "{} GET {} {} {}\n", i, path, 200,
+                  0.125 * static_cast<double>(i % 1000));
+    });
+    run_lines("print(fd_writer&), line flush", n / 10, [&] {
+        fd_writer out(fd, print_flush::line);
+        for (long i = 0; i != n / 10; ++i)
+            print(out, "{} GET {} {} {}\n", i, path, 200,
+                  0.125 * static_cast<double>(i % 1000));
+    });
+    ::close(fd);
+    return 0;
+}
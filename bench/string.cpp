@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <calico/format.hpp>
+#include <calico/string.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// The previous implementation: size with one `snprintf`, then format again.
+template<class ...T>
+std::string format_str_two_pass(const char* format, T&&... t) {
+    int n = std::snprintf(0, 0, format, t...) + 1;
+    if (n <= 0)
+        throw std::runtime_error("format_str_two_pass: 1st snprintf failed");
+    std::string s(static_cast<std::size_t>(n), 0);
+    n = std::snprintf(&s[0], static_cast<std::size_t>(n), format, t...);
+    if (n < 0)
+        throw std::runtime_error("format_str_two_pass: 2nd snprintf failed");
+    s.resize(static_cast<std::size_t>(n));
+    return s;
+}
+
+// Prevents the optimizer from discarding the results.
+std::size_t sink;
+
+int main() {
+    const long n = 2000000;
+    const char* fmt = "request %ld took %.3f ms (status %s)";
+    std::string buf;
+
+    run("format_str (two-pass)", n, [&](long i) {
+        sink += format_str_two_pass(fmt, i, 0.25 * i, "ok").size();
+    });
+    run("format_str", n, [&](long i) {
+        sink += format_str(fmt, i, 0.25 * i, "ok").size();
+    });
+    run("format_str_to (reused)", n, [&](long i) {
+        format_str_to(buf, fmt, i, 0.25 * i, "ok");
+        sink += buf.size();
+    });
+
+    const std::string big(300, 'x');
+    run("format_str (two-pass, long)", n / 4, [&](long i) {
+        sink += format_str_two_pass("%ld %s", i, big.c_str()).size();
+    });
+    run("format_str (long)", n / 4, [&](long i) {
+        sink += format_str("%ld %s", i, big.c_str()).size();
+    });
+
+    // Building a record out of 20 numeric fields.
+    run("record (to_string)", n / 10, [&](long i) {
+        std::string s;
+        for (long j = 0; j != 20; ++j) {
+            s += to_string(i + j);
+            s += ',';
+        }
+        sink += s.size();
+    });
+    run("record (to_chars_append)", n / 10, [&](long i) {
+        buf.clear();
+        for (long j = 0; j != 20; ++j) {
+            to_chars_append(buf, i + j);
+            buf += ',';
+        }
+        sink += buf.size();
+    });
+    run("record (format_append)", n / 10, [&](long i) {
+        buf.clear();
+        buf.reserve(20 * formatted_size("{},", i));
+        for (long j = 0; j != 20; ++j)
+            format_append(buf, "{},", i + j);
+        sink += buf.size();
+    });
+
+    // Building a message out of a handful of pieces.
+    const std::string user = "someone@example.com";
+    run("message (operator+)", n, [&](long i) {
+        sink += ("user " + user + " sent " + to_string(i) + " bytes in "
+                 + to_string(0.25 * i) + " ms").size();
+    });
+    run("message (concat)", n, [&](long i) {
+        sink += concat("user ", user, " sent ", i, " bytes in ", 0.25 * i,
+                       " ms").size();
+    });
+    run("message (format)", n, [&](long i) {
+        sink += format("user {} sent {} bytes in {:.3f} ms",
+                       user, i, 0.25 * i).size();
+    });
+    run("message (CALICO_FORMAT)", n, [&](long i) {
+        sink += CALICO_FORMAT("user {} sent {} bytes in {:.3f} ms",
+                              user, i, 0.25 * i).size();
+    });
+
+    // Rendering 100 numbers as a comma-separated list.
+    std::vector<long> values(100);
+    for (std::size_t j = 0; j != values.size(); ++j)
+        values[j] = static_cast<long>(j * j * 7919);
+    run("list (to_string loop)", n / 100, [&](long) {
+        std::string s;
+        for (std::size_t j = 0; j != values.size(); ++j) {
+            if (j)
+                s += ", ";
+            s += to_string(values[j]);
+        }
+        sink += s.size();
+    });
+    run("list (join)", n / 100, [&](long) {
+        sink += join(values, ", ").size();
+    });
+
+    // Scanning 64 KiB of text for rare delimiters.
+    std::string text(65536, 'a');
+    text[60000] = ';';
+    run("delimiters (loop)", n / 1000, [&](long) {
+        const char* p = text.data();
+        const char* last = p + text.size();
+        while (p != last && *p != ';' && *p != '\n' && *p != '"')
+            ++p;
+        sink += static_cast<std::size_t>(p - text.data());
+    });
+    run("delimiters (find_first_of)", n / 1000, [&](long) {
+        sink += static_cast<std::size_t>(
+            find_first_of(text, ";\n\"") - text.data());
+    });
+    run("substring (std::search)", n / 1000, [&](long) {
+        const char needle[] = "a;";
+        sink += static_cast<std::size_t>(
+            std::search(text.data(), text.data() + text.size(),
+                        needle, needle + 2) - text.data());
+    });
+    run("substring (search)", n / 1000, [&](long) {
+        sink += static_cast<std::size_t>(search(text, "a;") - text.data());
+    });
+
+    // Normalizing a typical header key: trim, then lowercase.
+    const std::string header = "  Accept-Encoding-Preferences-For-Proxy  ";
+    std::string key;
+    run("normalize (scalar loops)", n, [&](long) {
+        std::size_t first = 0, last = header.size();
+        while (first != last && std::isspace(
+                   static_cast<unsigned char>(header[first])))
+            ++first;
+        while (last != first && std::isspace(
+                   static_cast<unsigned char>(header[last - 1])))
+            --last;
+        key.assign(header, first, last - first);
+        for (char& c : key)
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        sink += key.size();
+    });
+    run("normalize (trim, to_lower)", n, [&](long) {
+        key.assign(header);
+        to_lower_in_place(trim_in_place(key));
+        sink += key.size();
+    });
+    const std::string shouted = to_upper(header);
+    run("compare (scalar loop)", n, [&](long) {
+        std::size_t i = 0;
+        while (i != header.size()
+               && std::tolower(static_cast<unsigned char>(header[i]))
+                  == std::tolower(static_cast<unsigned char>(shouted[i])))
+            ++i;
+        sink += i;
+    });
+    run("compare (compare_ignore_case)", n, [&](long) {
+        sink += static_cast<std::size_t>(
+            compare_ignore_case(header, shouted) + 1);
+    });
+    return sink == 0;
+}
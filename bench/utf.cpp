@@ -0,0 +1,77 @@
+#include <codecvt>
+#include <cstdio>
+#include <iterator>
+#include <locale>
+#include <string>
+#include <calico/utf.hpp>
+#include "bench.hpp"
+using namespace cal;
+
+// Prevents the optimizer from discarding the results.
+std::size_t sink;
+
+void bench(const char* label, const std::u32string& sample) {
+    std::u32string text;
+    while (text.size() < 1000000)
+        text += sample;
+    const std::string utf8 = utf32_to_utf8(text);
+    const std::u16string utf16 = utf8_to_utf16(utf8);
+    const char* first = utf8.data();
+    const char* last = first + utf8.size();
+    std::u16string buf16(utf8.size(), u'\0');
+    std::string buf8(3 * utf16.size(), '\0');
+    std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> cvt;
+
+    const double bytes = static_cast<double>(utf8.size());
+    std::printf("%s (%zu bytes of UTF-8)\n", label, utf8.size());
+    run("  validate: scalar", 20, [&](long) {
+        sink += static_cast<std::size_t>(
+            _priv::scalar_utf8_find_invalid(first, last) - first);
+    }, bytes);
+    run("  validate: utf8_find_invalid", 20, [&](long) {
+        sink += static_cast<std::size_t>(
+            utf8_find_invalid(first, last) - first);
+    }, bytes);
+    run("  count: byte loop", 20, [&](long) {
+        std::size_t n = 0;
+        for (const char* p = first; p != last; ++p)
+            n += (static_cast<unsigned char>(*p) & 0xc0) != 0x80;
+        sink += n;
+    }, bytes);
+    run("  count: utf8_iterator", 20, [&](long) {
+        const utf8_range r = utf8_chars(utf8);
+        sink += static_cast<std::size_t>(std::distance(r.begin(), r.end()));
+    }, bytes);
+    run("  count: utf8_length", 20, [&](long) {
+        sink += utf8_length(utf8);
+    }, bytes);
+    run("  offset: utf8_advance", 20, [&](long) {
+        sink += static_cast<std::size_t>(
+            utf8_advance(first, last, text.size() - 1) - first);
+    }, bytes);
+    run("  utf8 -> utf16: codecvt", 5, [&](long) {
+        sink += cvt.from_bytes(utf8).size();
+    }, bytes);
+    run("  utf8 -> utf16: utf8_to_utf16", 20, [&](long) {
+        sink += static_cast<std::size_t>(
+            utf8_to_utf16(first, last, &buf16[0]).out - &buf16[0]);
+    }, bytes);
+    run("  utf16 -> utf8: codecvt", 5, [&](long) {
+        sink += cvt.to_bytes(utf16).size();
+    }, bytes);
+    run("  utf16 -> utf8: utf16_to_utf8", 20, [&](long) {
+        sink += static_cast<std::size_t>(
+            utf16_to_utf8(utf16.data(), utf16.data() + utf16.size(),
+                          &buf8[0]).out - &buf8[0]);
+    }, bytes);
+}
+
+int main() {
+    bench("ASCII", U"The quick brown fox jumps over the lazy dog. ");
+    bench("Latin", U"Größenverhältnisse außerhalb der Straße, "
+                   U"é à ç. ");
+    bench("CJK", U"日本語のテキストと中文文本"
+                 U"以及한국어 텍스트。");
+    bench("Emoji", U"\U0001f600\U0001f680 ok \U0001f44d ");
+    return 0;
+}
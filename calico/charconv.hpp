@@ -0,0 +1,2050 @@
+#ifndef VQCWUDCQAZCIQPKTRLFR
+#define VQCWUDCQAZCIQPKTRLFR
+/// @file
+///
+/// This header implements locale-independent replacements for
+/// `std::to_chars` and `std::from_chars`.
+///
+/// Unlike the stream-based conversions, none of the functions here allocate
+/// memory, consult the locale, or throw exceptions.
+///
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <iterator>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "simd.hpp"
+#include "utility.hpp"
+namespace cal {
+
+/// The result of `to_chars`.
+struct to_chars_result {
+
+    /// One past the last character written.  If the conversion failed, this
+    /// is equal to `last`.
+    char* ptr;
+
+    /// `std::errc()` on success, or `std::errc::value_too_large` if the
+    /// output range is too small.
+    std::errc ec;
+};
+
+/// The result of `from_chars`.
+struct from_chars_result {
+
+    /// One past the last character that is part of the parsed value.  If no
+    /// value could be parsed, this is equal to `first`.
+    const char* ptr;
+
+    /// `std::errc()` on success, `std::errc::invalid_argument` if the input
+    /// does not start with a value, or `std::errc::result_out_of_range` if
+    /// the value does not fit in the type.
+    std::errc ec;
+};
+
+namespace _priv {
+
+// Two-digit decimal strings "00" to "99", used to emit two digits at a time.
+template<class = void>
+struct digit_pairs {
+    static const char value[201];
+};
+template<class T>
+const char digit_pairs<T>::value[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Leading 128 bits of 5^q for q in [-342, 325], stored as (high, low) pairs.
+// For q >= 0 the value is truncated; for q < 0 it is the reciprocal 2^b /
+// 5^-q rounded up.  The parsers use it directly (Eisel-Lemire) while the
+// formatters derive their 125-bit Ryu multipliers from it.
+template<class = void>
+struct pow5_table {
+    static const int min_exponent = -342;
+    static const int max_exponent = 325;
+    static const std::uint64_t value[668][2];
+};
+template<class T>
+const std::uint64_t pow5_table<T>::value[668][2] = {
+    {0xeef453d6923bd65au, 0x113faa2906a13b3fu}, // 5^-342
+    {0x9558b4661b6565f8u, 0x4ac7ca59a424c507u}, // 5^-341
+    {0xbaaee17fa23ebf76u, 0x5d79bcf00d2df649u}, // 5^-340
+    {0xe95a99df8ace6f53u, 0xf4d82c2c107973dcu}, // 5^-339
+    {0x91d8a02bb6c10594u, 0x79071b9b8a4be869u}, // 5^-338
+    {0xb64ec836a47146f9u, 0x9748e2826cdee284u}, // 5^-337
+    {0xe3e27a444d8d98b7u, 0xfd1b1b2308169b25u}, // 5^-336
+    {0x8e6d8c6ab0787f72u, 0xfe30f0f5e50e20f7u}, // 5^-335
+    {0xb208ef855c969f4fu, 0xbdbd2d335e51a935u}, // 5^-334
+    {0xde8b2b66b3bc4723u, 0xad2c788035e61382u}, // 5^-333
+    {0x8b16fb203055ac76u, 0x4c3bcb5021afcc31u}, // 5^-332
+    {0xaddcb9e83c6b1793u, 0xdf4abe242a1bbf3du}, // 5^-331
+    {0xd953e8624b85dd78u, 0xd71d6dad34a2af0du}, // 5^-330
+    {0x87d4713d6f33aa6bu, 0x8672648c40e5ad68u}, // 5^-329
+    {0xa9c98d8ccb009506u, 0x680efdaf511f18c2u}, // 5^-328
+    {0xd43bf0effdc0ba48u, 0x0212bd1b2566def2u}, // 5^-327
+    {0x84a57695fe98746du, 0x014bb630f7604b57u}, // 5^-326
+    {0xa5ced43b7e3e9188u, 0x419ea3bd35385e2du}, // 5^-325
+    {0xcf42894a5dce35eau, 0x52064cac828675b9u}, // 5^-324
+    {0x818995ce7aa0e1b2u, 0x7343efebd1940993u}, // 5^-323
+    {0xa1ebfb4219491a1fu, 0x1014ebe6c5f90bf8u}, // 5^-322
+    {0xca66fa129f9b60a6u, 0xd41a26e077774ef6u}, // 5^-321
+    {0xfd00b897478238d0u, 0x8920b098955522b4u}, // 5^-320
+    {0x9e20735e8cb16382u, 0x55b46e5f5d5535b0u}, // 5^-319
+    {0xc5a890362fddbc62u, 0xeb2189f734aa831du}, // 5^-318
+    {0xf712b443bbd52b7bu, 0xa5e9ec7501d523e4u}, // 5^-317
+    {0x9a6bb0aa55653b2du, 0x47b233c92125366eu}, // 5^-316
+    {0xc1069cd4eabe89f8u, 0x999ec0bb696e840au}, // 5^-315
+    {0xf148440a256e2c76u, 0xc00670ea43ca250du}, // 5^-314
+    {0x96cd2a865764dbcau, 0x380406926a5e5728u}, // 5^-313
+    {0xbc807527ed3e12bcu, 0xc605083704f5ecf2u}, // 5^-312
+    {0xeba09271e88d976bu, 0xf7864a44c633682eu}, // 5^-311
+    {0x93445b8731587ea3u, 0x7ab3ee6afbe0211du}, // 5^-310
+    {0xb8157268fdae9e4cu, 0x5960ea05bad82964u}, // 5^-309
+    {0xe61acf033d1a45dfu, 0x6fb92487298e33bdu}, // 5^-308
+    {0x8fd0c16206306babu, 0xa5d3b6d479f8e056u}, // 5^-307
+    {0xb3c4f1ba87bc8696u, 0x8f48a4899877186cu}, // 5^-306
+    {0xe0b62e2929aba83cu, 0x331acdabfe94de87u}, // 5^-305
+    {0x8c71dcd9ba0b4925u, 0x9ff0c08b7f1d0b14u}, // 5^-304
+    {0xaf8e5410288e1b6fu, 0x07ecf0ae5ee44dd9u}, // 5^-303
+    {0xdb71e91432b1a24au, 0xc9e82cd9f69d6150u}, // 5^-302
+    {0x892731ac9faf056eu, 0xbe311c083a225cd2u}, // 5^-301
+    {0xab70fe17c79ac6cau, 0x6dbd630a48aaf406u}, // 5^-300
+    {0xd64d3d9db981787du, 0x092cbbccdad5b108u}, // 5^-299
+    {0x85f0468293f0eb4eu, 0x25bbf56008c58ea5u}, // 5^-298
+    {0xa76c582338ed2621u, 0xaf2af2b80af6f24eu}, // 5^-297
+    {0xd1476e2c07286faau, 0x1af5af660db4aee1u}, // 5^-296
+    {0x82cca4db847945cau, 0x50d98d9fc890ed4du}, // 5^-295
+    {0xa37fce126597973cu, 0xe50ff107bab528a0u}, // 5^-294
+    {0xcc5fc196fefd7d0cu, 0x1e53ed49a96272c8u}, // 5^-293
+    {0xff77b1fcbebcdc4fu, 0x25e8e89c13bb0f7au}, // 5^-292
+    {0x9faacf3df73609b1u, 0x77b191618c54e9acu}, // 5^-291
+    {0xc795830d75038c1du, 0xd59df5b9ef6a2417u}, // 5^-290
+    {0xf97ae3d0d2446f25u, 0x4b0573286b44ad1du}, // 5^-289
+    {0x9becce62836ac577u, 0x4ee367f9430aec32u}, // 5^-288
+    {0xc2e801fb244576d5u, 0x229c41f793cda73fu}, // 5^-287
+    {0xf3a20279ed56d48au, 0x6b43527578c1110fu}, // 5^-286
+    {0x9845418c345644d6u, 0x830a13896b78aaa9u}, // 5^-285
+    {0xbe5691ef416bd60cu, 0x23cc986bc656d553u}, // 5^-284
+    {0xedec366b11c6cb8fu, 0x2cbfbe86b7ec8aa8u}, // 5^-283
+    {0x94b3a202eb1c3f39u, 0x7bf7d71432f3d6a9u}, // 5^-282
+    {0xb9e08a83a5e34f07u, 0xdaf5ccd93fb0cc53u}, // 5^-281
+    {0xe858ad248f5c22c9u, 0xd1b3400f8f9cff68u}, // 5^-280
+    {0x91376c36d99995beu, 0x23100809b9c21fa1u}, // 5^-279
+    {0xb58547448ffffb2du, 0xabd40a0c2832a78au}, // 5^-278
+    {0xe2e69915b3fff9f9u, 0x16c90c8f323f516cu}, // 5^-277
+    {0x8dd01fad907ffc3bu, 0xae3da7d97f6792e3u}, // 5^-276
+    {0xb1442798f49ffb4au, 0x99cd11cfdf41779cu}, // 5^-275
+    {0xdd95317f31c7fa1du, 0x40405643d711d583u}, // 5^-274
+    {0x8a7d3eef7f1cfc52u, 0x482835ea666b2572u}, // 5^-273
+    {0xad1c8eab5ee43b66u, 0xda3243650005eecfu}, // 5^-272
+    {0xd863b256369d4a40u, 0x90bed43e40076a82u}, // 5^-271
+    {0x873e4f75e2224e68u, 0x5a7744a6e804a291u}, // 5^-270
+    {0xa90de3535aaae202u, 0x711515d0a205cb36u}, // 5^-269
+    {0xd3515c2831559a83u, 0x0d5a5b44ca873e03u}, // 5^-268
+    {0x8412d9991ed58091u, 0xe858790afe9486c2u}, // 5^-267
+    {0xa5178fff668ae0b6u, 0x626e974dbe39a872u}, // 5^-266
+    {0xce5d73ff402d98e3u, 0xfb0a3d212dc8128fu}, // 5^-265
+    {0x80fa687f881c7f8eu, 0x7ce66634bc9d0b99u}, // 5^-264
+    {0xa139029f6a239f72u, 0x1c1fffc1ebc44e80u}, // 5^-263
+    {0xc987434744ac874eu, 0xa327ffb266b56220u}, // 5^-262
+    {0xfbe9141915d7a922u, 0x4bf1ff9f0062baa8u}, // 5^-261
+    {0x9d71ac8fada6c9b5u, 0x6f773fc3603db4a9u}, // 5^-260
+    {0xc4ce17b399107c22u, 0xcb550fb4384d21d3u}, // 5^-259
+    {0xf6019da07f549b2bu, 0x7e2a53a146606a48u}, // 5^-258
+    {0x99c102844f94e0fbu, 0x2eda7444cbfc426du}, // 5^-257
+    {0xc0314325637a1939u, 0xfa911155fefb5308u}, // 5^-256
+    {0xf03d93eebc589f88u, 0x793555ab7eba27cau}, // 5^-255
+    {0x96267c7535b763b5u, 0x4bc1558b2f3458deu}, // 5^-254
+    {0xbbb01b9283253ca2u, 0x9eb1aaedfb016f16u}, // 5^-253
+    {0xea9c227723ee8bcbu, 0x465e15a979c1cadcu}, // 5^-252
+    {0x92a1958a7675175fu, 0x0bfacd89ec191ec9u}, // 5^-251
+    {0xb749faed14125d36u, 0xcef980ec671f667bu}, // 5^-250
+    {0xe51c79a85916f484u, 0x82b7e12780e7401au}, // 5^-249
+    {0x8f31cc0937ae58d2u, 0xd1b2ecb8b0908810u}, // 5^-248
+    {0xb2fe3f0b8599ef07u, 0x861fa7e6dcb4aa15u}, // 5^-247
+    {0xdfbdcece67006ac9u, 0x67a791e093e1d49au}, // 5^-246
+    {0x8bd6a141006042bdu, 0xe0c8bb2c5c6d24e0u}, // 5^-245
+    {0xaecc49914078536du, 0x58fae9f773886e18u}, // 5^-244
+    {0xda7f5bf590966848u, 0xaf39a475506a899eu}, // 5^-243
+    {0x888f99797a5e012du, 0x6d8406c952429603u}, // 5^-242
+    {0xaab37fd7d8f58178u, 0xc8e5087ba6d33b83u}, // 5^-241
+    {0xd5605fcdcf32e1d6u, 0xfb1e4a9a90880a64u}, // 5^-240
+    {0x855c3be0a17fcd26u, 0x5cf2eea09a55067fu}, // 5^-239
+    {0xa6b34ad8c9dfc06fu, 0xf42faa48c0ea481eu}, // 5^-238
+    {0xd0601d8efc57b08bu, 0xf13b94daf124da26u}, // 5^-237
+    {0x823c12795db6ce57u, 0x76c53d08d6b70858u}, // 5^-236
+    {0xa2cb1717b52481edu, 0x54768c4b0c64ca6eu}, // 5^-235
+    {0xcb7ddcdda26da268u, 0xa9942f5dcf7dfd09u}, // 5^-234
+    {0xfe5d54150b090b02u, 0xd3f93b35435d7c4cu}, // 5^-233
+    {0x9efa548d26e5a6e1u, 0xc47bc5014a1a6dafu}, // 5^-232
+    {0xc6b8e9b0709f109au, 0x359ab6419ca1091bu}, // 5^-231
+    {0xf867241c8cc6d4c0u, 0xc30163d203c94b62u}, // 5^-230
+    {0x9b407691d7fc44f8u, 0x79e0de63425dcf1du}, // 5^-229
+    {0xc21094364dfb5636u, 0x985915fc12f542e4u}, // 5^-228
+    {0xf294b943e17a2bc4u, 0x3e6f5b7b17b2939du}, // 5^-227
+    {0x979cf3ca6cec5b5au, 0xa705992ceecf9c42u}, // 5^-226
+    {0xbd8430bd08277231u, 0x50c6ff782a838353u}, // 5^-225
+    {0xece53cec4a314ebdu, 0xa4f8bf5635246428u}, // 5^-224
+    {0x940f4613ae5ed136u, 0x871b7795e136be99u}, // 5^-223
+    {0xb913179899f68584u, 0x28e2557b59846e3fu}, // 5^-222
+    {0xe757dd7ec07426e5u, 0x331aeada2fe589cfu}, // 5^-221
+    {0x9096ea6f3848984fu, 0x3ff0d2c85def7621u}, // 5^-220
+    {0xb4bca50b065abe63u, 0x0fed077a756b53a9u}, // 5^-219
+    {0xe1ebce4dc7f16dfbu, 0xd3e8495912c62894u}, // 5^-218
+    {0x8d3360f09cf6e4bdu, 0x64712dd7abbbd95cu}, // 5^-217
+    {0xb080392cc4349decu, 0xbd8d794d96aacfb3u}, // 5^-216
+    {0xdca04777f541c567u, 0xecf0d7a0fc5583a0u}, // 5^-215
+    {0x89e42caaf9491b60u, 0xf41686c49db57244u}, // 5^-214
+    {0xac5d37d5b79b6239u, 0x311c2875c522ced5u}, // 5^-213
+    {0xd77485cb25823ac7u, 0x7d633293366b828bu}, // 5^-212
+    {0x86a8d39ef77164bcu, 0xae5dff9c02033197u}, // 5^-211
+    {0xa8530886b54dbdebu, 0xd9f57f830283fdfcu}, // 5^-210
+    {0xd267caa862a12d66u, 0xd072df63c324fd7bu}, // 5^-209
+    {0x8380dea93da4bc60u, 0x4247cb9e59f71e6du}, // 5^-208
+    {0xa46116538d0deb78u, 0x52d9be85f074e608u}, // 5^-207
+    {0xcd795be870516656u, 0x67902e276c921f8bu}, // 5^-206
+    {0x806bd9714632dff6u, 0x00ba1cd8a3db53b6u}, // 5^-205
+    {0xa086cfcd97bf97f3u, 0x80e8a40eccd228a4u}, // 5^-204
+    {0xc8a883c0fdaf7df0u, 0x6122cd128006b2cdu}, // 5^-203
+    {0xfad2a4b13d1b5d6cu, 0x796b805720085f81u}, // 5^-202
+    {0x9cc3a6eec6311a63u, 0xcbe3303674053bb0u}, // 5^-201
+    {0xc3f490aa77bd60fcu, 0xbedbfc4411068a9cu}, // 5^-200
+    {0xf4f1b4d515acb93bu, 0xee92fb5515482d44u}, // 5^-199
+    {0x991711052d8bf3c5u, 0x751bdd152d4d1c4au}, // 5^-198
+    {0xbf5cd54678eef0b6u, 0xd262d45a78a0635du}, // 5^-197
+    {0xef340a98172aace4u, 0x86fb897116c87c34u}, // 5^-196
+    {0x9580869f0e7aac0eu, 0xd45d35e6ae3d4da0u}, // 5^-195
+    {0xbae0a846d2195712u, 0x8974836059cca109u}, // 5^-194
+    {0xe998d258869facd7u, 0x2bd1a438703fc94bu}, // 5^-193
+    {0x91ff83775423cc06u, 0x7b6306a34627ddcfu}, // 5^-192
+    {0xb67f6455292cbf08u, 0x1a3bc84c17b1d542u}, // 5^-191
+    {0xe41f3d6a7377eecau, 0x20caba5f1d9e4a93u}, // 5^-190
+    {0x8e938662882af53eu, 0x547eb47b7282ee9cu}, // 5^-189
+    {0xb23867fb2a35b28du, 0xe99e619a4f23aa43u}, // 5^-188
+    {0xdec681f9f4c31f31u, 0x6405fa00e2ec94d4u}, // 5^-187
+    {0x8b3c113c38f9f37eu, 0xde83bc408dd3dd04u}, // 5^-186
+    {0xae0b158b4738705eu, 0x9624ab50b148d445u}, // 5^-185
+    {0xd98ddaee19068c76u, 0x3badd624dd9b0957u}, // 5^-184
+    {0x87f8a8d4cfa417c9u, 0xe54ca5d70a80e5d6u}, // 5^-183
+    {0xa9f6d30a038d1dbcu, 0x5e9fcf4ccd211f4cu}, // 5^-182
+    {0xd47487cc8470652bu, 0x7647c3200069671fu}, // 5^-181
+    {0x84c8d4dfd2c63f3bu, 0x29ecd9f40041e073u}, // 5^-180
+    {0xa5fb0a17c777cf09u, 0xf468107100525890u}, // 5^-179
+    {0xcf79cc9db955c2ccu, 0x7182148d4066eeb4u}, // 5^-178
+    {0x81ac1fe293d599bfu, 0xc6f14cd848405530u}, // 5^-177
+    {0xa21727db38cb002fu, 0xb8ada00e5a506a7cu}, // 5^-176
+    {0xca9cf1d206fdc03bu, 0xa6d90811f0e4851cu}, // 5^-175
+    {0xfd442e4688bd304au, 0x908f4a166d1da663u}, // 5^-174
+    {0x9e4a9cec15763e2eu, 0x9a598e4e043287feu}, // 5^-173
+    {0xc5dd44271ad3cdbau, 0x40eff1e1853f29fdu}, // 5^-172
+    {0xf7549530e188c128u, 0xd12bee59e68ef47cu}, // 5^-171
+    {0x9a94dd3e8cf578b9u, 0x82bb74f8301958ceu}, // 5^-170
+    {0xc13a148e3032d6e7u, 0xe36a52363c1faf01u}, // 5^-169
+    {0xf18899b1bc3f8ca1u, 0xdc44e6c3cb279ac1u}, // 5^-168
+    {0x96f5600f15a7b7e5u, 0x29ab103a5ef8c0b9u}, // 5^-167
+    {0xbcb2b812db11a5deu, 0x7415d448f6b6f0e7u}, // 5^-166
+    {0xebdf661791d60f56u, 0x111b495b3464ad21u}, // 5^-165
+    {0x936b9fcebb25c995u, 0xcab10dd900beec34u}, // 5^-164
+    {0xb84687c269ef3bfbu, 0x3d5d514f40eea742u}, // 5^-163
+    {0xe65829b3046b0afau, 0x0cb4a5a3112a5112u}, // 5^-162
+    {0x8ff71a0fe2c2e6dcu, 0x47f0e785eaba72abu}, // 5^-161
+    {0xb3f4e093db73a093u, 0x59ed216765690f56u}, // 5^-160
+    {0xe0f218b8d25088b8u, 0x306869c13ec3532cu}, // 5^-159
+    {0x8c974f7383725573u, 0x1e414218c73a13fbu}, // 5^-158
+    {0xafbd2350644eeacfu, 0xe5d1929ef90898fau}, // 5^-157
+    {0xdbac6c247d62a583u, 0xdf45f746b74abf39u}, // 5^-156
+    {0x894bc396ce5da772u, 0x6b8bba8c328eb783u}, // 5^-155
+    {0xab9eb47c81f5114fu, 0x066ea92f3f326564u}, // 5^-154
+    {0xd686619ba27255a2u, 0xc80a537b0efefebdu}, // 5^-153
+    {0x8613fd0145877585u, 0xbd06742ce95f5f36u}, // 5^-152
+    {0xa798fc4196e952e7u, 0x2c48113823b73704u}, // 5^-151
+    {0xd17f3b51fca3a7a0u, 0xf75a15862ca504c5u}, // 5^-150
+    {0x82ef85133de648c4u, 0x9a984d73dbe722fbu}, // 5^-149
+    {0xa3ab66580d5fdaf5u, 0xc13e60d0d2e0ebbau}, // 5^-148
+    {0xcc963fee10b7d1b3u, 0x318df905079926a8u}, // 5^-147
+    {0xffbbcfe994e5c61fu, 0xfdf17746497f7052u}, // 5^-146
+    {0x9fd561f1fd0f9bd3u, 0xfeb6ea8bedefa633u}, // 5^-145
+    {0xc7caba6e7c5382c8u, 0xfe64a52ee96b8fc0u}, // 5^-144
+    {0xf9bd690a1b68637bu, 0x3dfdce7aa3c673b0u}, // 5^-143
+    {0x9c1661a651213e2du, 0x06bea10ca65c084eu}, // 5^-142
+    {0xc31bfa0fe5698db8u, 0x486e494fcff30a62u}, // 5^-141
+    {0xf3e2f893dec3f126u, 0x5a89dba3c3efccfau}, // 5^-140
+    {0x986ddb5c6b3a76b7u, 0xf89629465a75e01cu}, // 5^-139
+    {0xbe89523386091465u, 0xf6bbb397f1135823u}, // 5^-138
+    {0xee2ba6c0678b597fu, 0x746aa07ded582e2cu}, // 5^-137
+    {0x94db483840b717efu, 0xa8c2a44eb4571cdcu}, // 5^-136
+    {0xba121a4650e4ddebu, 0x92f34d62616ce413u}, // 5^-135
+    {0xe896a0d7e51e1566u, 0x77b020baf9c81d17u}, // 5^-134
+    {0x915e2486ef32cd60u, 0x0ace1474dc1d122eu}, // 5^-133
+    {0xb5b5ada8aaff80b8u, 0x0d819992132456bau}, // 5^-132
+    {0xe3231912d5bf60e6u, 0x10e1fff697ed6c69u}, // 5^-131
+    {0x8df5efabc5979c8fu, 0xca8d3ffa1ef463c1u}, // 5^-130
+    {0xb1736b96b6fd83b3u, 0xbd308ff8a6b17cb2u}, // 5^-129
+    {0xddd0467c64bce4a0u, 0xac7cb3f6d05ddbdeu}, // 5^-128
+    {0x8aa22c0dbef60ee4u, 0x6bcdf07a423aa96bu}, // 5^-127
+    {0xad4ab7112eb3929du, 0x86c16c98d2c953c6u}, // 5^-126
+    {0xd89d64d57a607744u, 0xe871c7bf077ba8b7u}, // 5^-125
+    {0x87625f056c7c4a8bu, 0x11471cd764ad4972u}, // 5^-124
+    {0xa93af6c6c79b5d2du, 0xd598e40d3dd89bcfu}, // 5^-123
+    {0xd389b47879823479u, 0x4aff1d108d4ec2c3u}, // 5^-122
+    {0x843610cb4bf160cbu, 0xcedf722a585139bau}, // 5^-121
+    {0xa54394fe1eedb8feu, 0xc2974eb4ee658828u}, // 5^-120
+    {0xce947a3da6a9273eu, 0x733d226229feea32u}, // 5^-119
+    {0x811ccc668829b887u, 0x0806357d5a3f525fu}, // 5^-118
+    {0xa163ff802a3426a8u, 0xca07c2dcb0cf26f7u}, // 5^-117
+    {0xc9bcff6034c13052u, 0xfc89b393dd02f0b5u}, // 5^-116
+    {0xfc2c3f3841f17c67u, 0xbbac2078d443ace2u}, // 5^-115
+    {0x9d9ba7832936edc0u, 0xd54b944b84aa4c0du}, // 5^-114
+    {0xc5029163f384a931u, 0x0a9e795e65d4df11u}, // 5^-113
+    {0xf64335bcf065d37du, 0x4d4617b5ff4a16d5u}, // 5^-112
+    {0x99ea0196163fa42eu, 0x504bced1bf8e4e45u}, // 5^-111
+    {0xc06481fb9bcf8d39u, 0xe45ec2862f71e1d6u}, // 5^-110
+    {0xf07da27a82c37088u, 0x5d767327bb4e5a4cu}, // 5^-109
+    {0x964e858c91ba2655u, 0x3a6a07f8d510f86fu}, // 5^-108
+    {0xbbe226efb628afeau, 0x890489f70a55368bu}, // 5^-107
+    {0xeadab0aba3b2dbe5u, 0x2b45ac74ccea842eu}, // 5^-106
+    {0x92c8ae6b464fc96fu, 0x3b0b8bc90012929du}, // 5^-105
+    {0xb77ada0617e3bbcbu, 0x09ce6ebb40173744u}, // 5^-104
+    {0xe55990879ddcaabdu, 0xcc420a6a101d0515u}, // 5^-103
+    {0x8f57fa54c2a9eab6u, 0x9fa946824a12232du}, // 5^-102
+    {0xb32df8e9f3546564u, 0x47939822dc96abf9u}, // 5^-101
+    {0xdff9772470297ebdu, 0x59787e2b93bc56f7u}, // 5^-100
+    {0x8bfbea76c619ef36u, 0x57eb4edb3c55b65au}, // 5^-99
+    {0xaefae51477a06b03u, 0xede622920b6b23f1u}, // 5^-98
+    {0xdab99e59958885c4u, 0xe95fab368e45ecedu}, // 5^-97
+    {0x88b402f7fd75539bu, 0x11dbcb0218ebb414u}, // 5^-96
+    {0xaae103b5fcd2a881u, 0xd652bdc29f26a119u}, // 5^-95
+    {0xd59944a37c0752a2u, 0x4be76d3346f0495fu}, // 5^-94
+    {0x857fcae62d8493a5u, 0x6f70a4400c562ddbu}, // 5^-93
+    {0xa6dfbd9fb8e5b88eu, 0xcb4ccd500f6bb952u}, // 5^-92
+    {0xd097ad07a71f26b2u, 0x7e2000a41346a7a7u}, // 5^-91
+    {0x825ecc24c873782fu, 0x8ed400668c0c28c8u}, // 5^-90
+    {0xa2f67f2dfa90563bu, 0x728900802f0f32fau}, // 5^-89
+    {0xcbb41ef979346bcau, 0x4f2b40a03ad2ffb9u}, // 5^-88
+    {0xfea126b7d78186bcu, 0xe2f610c84987bfa8u}, // 5^-87
+    {0x9f24b832e6b0f436u, 0x0dd9ca7d2df4d7c9u}, // 5^-86
+    {0xc6ede63fa05d3143u, 0x91503d1c79720dbbu}, // 5^-85
+    {0xf8a95fcf88747d94u, 0x75a44c6397ce912au}, // 5^-84
+    {0x9b69dbe1b548ce7cu, 0xc986afbe3ee11abau}, // 5^-83
+    {0xc24452da229b021bu, 0xfbe85badce996168u}, // 5^-82
+    {0xf2d56790ab41c2a2u, 0xfae27299423fb9c3u}, // 5^-81
+    {0x97c560ba6b0919a5u, 0xdccd879fc967d41au}, // 5^-80
+    {0xbdb6b8e905cb600fu, 0x5400e987bbc1c920u}, // 5^-79
+    {0xed246723473e3813u, 0x290123e9aab23b68u}, // 5^-78
+    {0x9436c0760c86e30bu, 0xf9a0b6720aaf6521u}, // 5^-77
+    {0xb94470938fa89bceu, 0xf808e40e8d5b3e69u}, // 5^-76
+    {0xe7958cb87392c2c2u, 0xb60b1d1230b20e04u}, // 5^-75
+    {0x90bd77f3483bb9b9u, 0xb1c6f22b5e6f48c2u}, // 5^-74
+    {0xb4ecd5f01a4aa828u, 0x1e38aeb6360b1af3u}, // 5^-73
+    {0xe2280b6c20dd5232u, 0x25c6da63c38de1b0u}, // 5^-72
+    {0x8d590723948a535fu, 0x579c487e5a38ad0eu}, // 5^-71
+    {0xb0af48ec79ace837u, 0x2d835a9df0c6d851u}, // 5^-70
+    {0xdcdb1b2798182244u, 0xf8e431456cf88e65u}, // 5^-69
+    {0x8a08f0f8bf0f156bu, 0x1b8e9ecb641b58ffu}, // 5^-68
+    {0xac8b2d36eed2dac5u, 0xe272467e3d222f3fu}, // 5^-67
+    {0xd7adf884aa879177u, 0x5b0ed81dcc6abb0fu}, // 5^-66
+    {0x86ccbb52ea94baeau, 0x98e947129fc2b4e9u}, // 5^-65
+    {0xa87fea27a539e9a5u, 0x3f2398d747b36224u}, // 5^-64
+    {0xd29fe4b18e88640eu, 0x8eec7f0d19a03aadu}, // 5^-63
+    {0x83a3eeeef9153e89u, 0x1953cf68300424acu}, // 5^-62
+    {0xa48ceaaab75a8e2bu, 0x5fa8c3423c052dd7u}, // 5^-61
+    {0xcdb02555653131b6u, 0x3792f412cb06794du}, // 5^-60
+    {0x808e17555f3ebf11u, 0xe2bbd88bbee40bd0u}, // 5^-59
+    {0xa0b19d2ab70e6ed6u, 0x5b6aceaeae9d0ec4u}, // 5^-58
+    {0xc8de047564d20a8bu, 0xf245825a5a445275u}, // 5^-57
+    {0xfb158592be068d2eu, 0xeed6e2f0f0d56712u}, // 5^-56
+    {0x9ced737bb6c4183du, 0x55464dd69685606bu}, // 5^-55
+    {0xc428d05aa4751e4cu, 0xaa97e14c3c26b886u}, // 5^-54
+    {0xf53304714d9265dfu, 0xd53dd99f4b3066a8u}, // 5^-53
+    {0x993fe2c6d07b7fabu, 0xe546a8038efe4029u}, // 5^-52
+    {0xbf8fdb78849a5f96u, 0xde98520472bdd033u}, // 5^-51
+    {0xef73d256a5c0f77cu, 0x963e66858f6d4440u}, // 5^-50
+    {0x95a8637627989aadu, 0xdde7001379a44aa8u}, // 5^-49
+    {0xbb127c53b17ec159u, 0x5560c018580d5d52u}, // 5^-48
+    {0xe9d71b689dde71afu, 0xaab8f01e6e10b4a6u}, // 5^-47
+    {0x9226712162ab070du, 0xcab3961304ca70e8u}, // 5^-46
+    {0xb6b00d69bb55c8d1u, 0x3d607b97c5fd0d22u}, // 5^-45
+    {0xe45c10c42a2b3b05u, 0x8cb89a7db77c506au}, // 5^-44
+    {0x8eb98a7a9a5b04e3u, 0x77f3608e92adb242u}, // 5^-43
+    {0xb267ed1940f1c61cu, 0x55f038b237591ed3u}, // 5^-42
+    {0xdf01e85f912e37a3u, 0x6b6c46dec52f6688u}, // 5^-41
+    {0x8b61313bbabce2c6u, 0x2323ac4b3b3da015u}, // 5^-40
+    {0xae397d8aa96c1b77u, 0xabec975e0a0d081au}, // 5^-39
+    {0xd9c7dced53c72255u, 0x96e7bd358c904a21u}, // 5^-38
+    {0x881cea14545c7575u, 0x7e50d64177da2e54u}, // 5^-37
+    {0xaa242499697392d2u, 0xdde50bd1d5d0b9e9u}, // 5^-36
+    {0xd4ad2dbfc3d07787u, 0x955e4ec64b44e864u}, // 5^-35
+    {0x84ec3c97da624ab4u, 0xbd5af13bef0b113eu}, // 5^-34
+    {0xa6274bbdd0fadd61u, 0xecb1ad8aeacdd58eu}, // 5^-33
+    {0xcfb11ead453994bau, 0x67de18eda5814af2u}, // 5^-32
+    {0x81ceb32c4b43fcf4u, 0x80eacf948770ced7u}, // 5^-31
+    {0xa2425ff75e14fc31u, 0xa1258379a94d028du}, // 5^-30
+    {0xcad2f7f5359a3b3eu, 0x096ee45813a04330u}, // 5^-29
+    {0xfd87b5f28300ca0du, 0x8bca9d6e188853fcu}, // 5^-28
+    {0x9e74d1b791e07e48u, 0x775ea264cf55347eu}, // 5^-27
+    {0xc612062576589ddau, 0x95364afe032a819eu}, // 5^-26
+    {0xf79687aed3eec551u, 0x3a83ddbd83f52205u}, // 5^-25
+    {0x9abe14cd44753b52u, 0xc4926a9672793543u}, // 5^-24
+    {0xc16d9a0095928a27u, 0x75b7053c0f178294u}, // 5^-23
+    {0xf1c90080baf72cb1u, 0x5324c68b12dd6339u}, // 5^-22
+    {0x971da05074da7beeu, 0xd3f6fc16ebca5e04u}, // 5^-21
+    {0xbce5086492111aeau, 0x88f4bb1ca6bcf585u}, // 5^-20
+    {0xec1e4a7db69561a5u, 0x2b31e9e3d06c32e6u}, // 5^-19
+    {0x9392ee8e921d5d07u, 0x3aff322e62439fd0u}, // 5^-18
+    {0xb877aa3236a4b449u, 0x09befeb9fad487c3u}, // 5^-17
+    {0xe69594bec44de15bu, 0x4c2ebe687989a9b4u}, // 5^-16
+    {0x901d7cf73ab0acd9u, 0x0f9d37014bf60a11u}, // 5^-15
+    {0xb424dc35095cd80fu, 0x538484c19ef38c95u}, // 5^-14
+    {0xe12e13424bb40e13u, 0x2865a5f206b06fbau}, // 5^-13
+    {0x8cbccc096f5088cbu, 0xf93f87b7442e45d4u}, // 5^-12
+    {0xafebff0bcb24aafeu, 0xf78f69a51539d749u}, // 5^-11
+    {0xdbe6fecebdedd5beu, 0xb573440e5a884d1cu}, // 5^-10
+    {0x89705f4136b4a597u, 0x31680a88f8953031u}, // 5^-9
+    {0xabcc77118461cefcu, 0xfdc20d2b36ba7c3eu}, // 5^-8
+    {0xd6bf94d5e57a42bcu, 0x3d32907604691b4du}, // 5^-7
+    {0x8637bd05af6c69b5u, 0xa63f9a49c2c1b110u}, // 5^-6
+    {0xa7c5ac471b478423u, 0x0fcf80dc33721d54u}, // 5^-5
+    {0xd1b71758e219652bu, 0xd3c36113404ea4a9u}, // 5^-4
+    {0x83126e978d4fdf3bu, 0x645a1cac083126eau}, // 5^-3
+    {0xa3d70a3d70a3d70au, 0x3d70a3d70a3d70a4u}, // 5^-2
+    {0xccccccccccccccccu, 0xcccccccccccccccdu}, // 5^-1
+    {0x8000000000000000u, 0x0000000000000000u}, // 5^0
+    {0xa000000000000000u, 0x0000000000000000u}, // 5^1
+    {0xc800000000000000u, 0x0000000000000000u}, // 5^2
+    {0xfa00000000000000u, 0x0000000000000000u}, // 5^3
+    {0x9c40000000000000u, 0x0000000000000000u}, // 5^4
+    {0xc350000000000000u, 0x0000000000000000u}, // 5^5
+    {0xf424000000000000u, 0x0000000000000000u}, // 5^6
+    {0x9896800000000000u, 0x0000000000000000u}, // 5^7
+    {0xbebc200000000000u, 0x0000000000000000u}, // 5^8
+    {0xee6b280000000000u, 0x0000000000000000u}, // 5^9
+    {0x9502f90000000000u, 0x0000000000000000u}, // 5^10
+    {0xba43b74000000000u, 0x0000000000000000u}, // 5^11
+    {0xe8d4a51000000000u, 0x0000000000000000u}, // 5^12
+    {0x9184e72a00000000u, 0x0000000000000000u}, // 5^13
+    {0xb5e620f480000000u, 0x0000000000000000u}, // 5^14
+    {0xe35fa931a0000000u, 0x0000000000000000u}, // 5^15
+    {0x8e1bc9bf04000000u, 0x0000000000000000u}, // 5^16
+    {0xb1a2bc2ec5000000u, 0x0000000000000000u}, // 5^17
+    {0xde0b6b3a76400000u, 0x0000000000000000u}, // 5^18
+    {0x8ac7230489e80000u, 0x0000000000000000u}, // 5^19
+    {0xad78ebc5ac620000u, 0x0000000000000000u}, // 5^20
+    {0xd8d726b7177a8000u, 0x0000000000000000u}, // 5^21
+    {0x878678326eac9000u, 0x0000000000000000u}, // 5^22
+    {0xa968163f0a57b400u, 0x0000000000000000u}, // 5^23
+    {0xd3c21bcecceda100u, 0x0000000000000000u}, // 5^24
+    {0x84595161401484a0u, 0x0000000000000000u}, // 5^25
+    {0xa56fa5b99019a5c8u, 0x0000000000000000u}, // 5^26
+    {0xcecb8f27f4200f3au, 0x0000000000000000u}, // 5^27
+    {0x813f3978f8940984u, 0x4000000000000000u}, // 5^28
+    {0xa18f07d736b90be5u, 0x5000000000000000u}, // 5^29
+    {0xc9f2c9cd04674edeu, 0xa400000000000000u}, // 5^30
+    {0xfc6f7c4045812296u, 0x4d00000000000000u}, // 5^31
+    {0x9dc5ada82b70b59du, 0xf020000000000000u}, // 5^32
+    {0xc5371912364ce305u, 0x6c28000000000000u}, // 5^33
+    {0xf684df56c3e01bc6u, 0xc732000000000000u}, // 5^34
+    {0x9a130b963a6c115cu, 0x3c7f400000000000u}, // 5^35
+    {0xc097ce7bc90715b3u, 0x4b9f100000000000u}, // 5^36
+    {0xf0bdc21abb48db20u, 0x1e86d40000000000u}, // 5^37
+    {0x96769950b50d88f4u, 0x1314448000000000u}, // 5^38
+    {0xbc143fa4e250eb31u, 0x17d955a000000000u}, // 5^39
+    {0xeb194f8e1ae525fdu, 0x5dcfab0800000000u}, // 5^40
+    {0x92efd1b8d0cf37beu, 0x5aa1cae500000000u}, // 5^41
+    {0xb7abc627050305adu, 0xf14a3d9e40000000u}, // 5^42
+    {0xe596b7b0c643c719u, 0x6d9ccd05d0000000u}, // 5^43
+    {0x8f7e32ce7bea5c6fu, 0xe4820023a2000000u}, // 5^44
+    {0xb35dbf821ae4f38bu, 0xdda2802c8a800000u}, // 5^45
+    {0xe0352f62a19e306eu, 0xd50b2037ad200000u}, // 5^46
+    {0x8c213d9da502de45u, 0x4526f422cc340000u}, // 5^47
+    {0xaf298d050e4395d6u, 0x9670b12b7f410000u}, // 5^48
+    {0xdaf3f04651d47b4cu, 0x3c0cdd765f114000u}, // 5^49
+    {0x88d8762bf324cd0fu, 0xa5880a69fb6ac800u}, // 5^50
+    {0xab0e93b6efee0053u, 0x8eea0d047a457a00u}, // 5^51
+    {0xd5d238a4abe98068u, 0x72a4904598d6d880u}, // 5^52
+    {0x85a36366eb71f041u, 0x47a6da2b7f864750u}, // 5^53
+    {0xa70c3c40a64e6c51u, 0x999090b65f67d924u}, // 5^54
+    {0xd0cf4b50cfe20765u, 0xfff4b4e3f741cf6du}, // 5^55
+    {0x82818f1281ed449fu, 0xbff8f10e7a8921a4u}, // 5^56
+    {0xa321f2d7226895c7u, 0xaff72d52192b6a0du}, // 5^57
+    {0xcbea6f8ceb02bb39u, 0x9bf4f8a69f764490u}, // 5^58
+    {0xfee50b7025c36a08u, 0x02f236d04753d5b4u}, // 5^59
+    {0x9f4f2726179a2245u, 0x01d762422c946590u}, // 5^60
+    {0xc722f0ef9d80aad6u, 0x424d3ad2b7b97ef5u}, // 5^61
+    {0xf8ebad2b84e0d58bu, 0xd2e0898765a7deb2u}, // 5^62
+    {0x9b934c3b330c8577u, 0x63cc55f49f88eb2fu}, // 5^63
+    {0xc2781f49ffcfa6d5u, 0x3cbf6b71c76b25fbu}, // 5^64
+    {0xf316271c7fc3908au, 0x8bef464e3945ef7au}, // 5^65
+    {0x97edd871cfda3a56u, 0x97758bf0e3cbb5acu}, // 5^66
+    {0xbde94e8e43d0c8ecu, 0x3d52eeed1cbea317u}, // 5^67
+    {0xed63a231d4c4fb27u, 0x4ca7aaa863ee4bddu}, // 5^68
+    {0x945e455f24fb1cf8u, 0x8fe8caa93e74ef6au}, // 5^69
+    {0xb975d6b6ee39e436u, 0xb3e2fd538e122b44u}, // 5^70
+    {0xe7d34c64a9c85d44u, 0x60dbbca87196b616u}, // 5^71
+    {0x90e40fbeea1d3a4au, 0xbc8955e946fe31cdu}, // 5^72
+    {0xb51d13aea4a488ddu, 0x6babab6398bdbe41u}, // 5^73
+    {0xe264589a4dcdab14u, 0xc696963c7eed2dd1u}, // 5^74
+    {0x8d7eb76070a08aecu, 0xfc1e1de5cf543ca2u}, // 5^75
+    {0xb0de65388cc8ada8u, 0x3b25a55f43294bcbu}, // 5^76
+    {0xdd15fe86affad912u, 0x49ef0eb713f39ebeu}, // 5^77
+    {0x8a2dbf142dfcc7abu, 0x6e3569326c784337u}, // 5^78
+    {0xacb92ed9397bf996u, 0x49c2c37f07965404u}, // 5^79
+    {0xd7e77a8f87daf7fbu, 0xdc33745ec97be906u}, // 5^80
+    {0x86f0ac99b4e8dafdu, 0x69a028bb3ded71a3u}, // 5^81
+    {0xa8acd7c0222311bcu, 0xc40832ea0d68ce0cu}, // 5^82
+    {0xd2d80db02aabd62bu, 0xf50a3fa490c30190u}, // 5^83
+    {0x83c7088e1aab65dbu, 0x792667c6da79e0fau}, // 5^84
+    {0xa4b8cab1a1563f52u, 0x577001b891185938u}, // 5^85
+    {0xcde6fd5e09abcf26u, 0xed4c0226b55e6f86u}, // 5^86
+    {0x80b05e5ac60b6178u, 0x544f8158315b05b4u}, // 5^87
+    {0xa0dc75f1778e39d6u, 0x696361ae3db1c721u}, // 5^88
+    {0xc913936dd571c84cu, 0x03bc3a19cd1e38e9u}, // 5^89
+    {0xfb5878494ace3a5fu, 0x04ab48a04065c723u}, // 5^90
+    {0x9d174b2dcec0e47bu, 0x62eb0d64283f9c76u}, // 5^91
+    {0xc45d1df942711d9au, 0x3ba5d0bd324f8394u}, // 5^92
+    {0xf5746577930d6500u, 0xca8f44ec7ee36479u}, // 5^93
+    {0x9968bf6abbe85f20u, 0x7e998b13cf4e1ecbu}, // 5^94
+    {0xbfc2ef456ae276e8u, 0x9e3fedd8c321a67eu}, // 5^95
+    {0xefb3ab16c59b14a2u, 0xc5cfe94ef3ea101eu}, // 5^96
+    {0x95d04aee3b80ece5u, 0xbba1f1d158724a12u}, // 5^97
+    {0xbb445da9ca61281fu, 0x2a8a6e45ae8edc97u}, // 5^98
+    {0xea1575143cf97226u, 0xf52d09d71a3293bdu}, // 5^99
+    {0x924d692ca61be758u, 0x593c2626705f9c56u}, // 5^100
+    {0xb6e0c377cfa2e12eu, 0x6f8b2fb00c77836cu}, // 5^101
+    {0xe498f455c38b997au, 0x0b6dfb9c0f956447u}, // 5^102
+    {0x8edf98b59a373fecu, 0x4724bd4189bd5eacu}, // 5^103
+    {0xb2977ee300c50fe7u, 0x58edec91ec2cb657u}, // 5^104
+    {0xdf3d5e9bc0f653e1u, 0x2f2967b66737e3edu}, // 5^105
+    {0x8b865b215899f46cu, 0xbd79e0d20082ee74u}, // 5^106
+    {0xae67f1e9aec07187u, 0xecd8590680a3aa11u}, // 5^107
+    {0xda01ee641a708de9u, 0xe80e6f4820cc9495u}, // 5^108
+    {0x884134fe908658b2u, 0x3109058d147fdcddu}, // 5^109
+    {0xaa51823e34a7eedeu, 0xbd4b46f0599fd415u}, // 5^110
+    {0xd4e5e2cdc1d1ea96u, 0x6c9e18ac7007c91au}, // 5^111
+    {0x850fadc09923329eu, 0x03e2cf6bc604ddb0u}, // 5^112
+    {0xa6539930bf6bff45u, 0x84db8346b786151cu}, // 5^113
+    {0xcfe87f7cef46ff16u, 0xe612641865679a63u}, // 5^114
+    {0x81f14fae158c5f6eu, 0x4fcb7e8f3f60c07eu}, // 5^115
+    {0xa26da3999aef7749u, 0xe3be5e330f38f09du}, // 5^116
+    {0xcb090c8001ab551cu, 0x5cadf5bfd3072cc5u}, // 5^117
+    {0xfdcb4fa002162a63u, 0x73d9732fc7c8f7f6u}, // 5^118
+    {0x9e9f11c4014dda7eu, 0x2867e7fddcdd9afau}, // 5^119
+    {0xc646d63501a1511du, 0xb281e1fd541501b8u}, // 5^120
+    {0xf7d88bc24209a565u, 0x1f225a7ca91a4226u}, // 5^121
+    {0x9ae757596946075fu, 0x3375788de9b06958u}, // 5^122
+    {0xc1a12d2fc3978937u, 0x0052d6b1641c83aeu}, // 5^123
+    {0xf209787bb47d6b84u, 0xc0678c5dbd23a49au}, // 5^124
+    {0x9745eb4d50ce6332u, 0xf840b7ba963646e0u}, // 5^125
+    {0xbd176620a501fbffu, 0xb650e5a93bc3d898u}, // 5^126
+    {0xec5d3fa8ce427affu, 0xa3e51f138ab4cebeu}, // 5^127
+    {0x93ba47c980e98cdfu, 0xc66f336c36b10137u}, // 5^128
+    {0xb8a8d9bbe123f017u, 0xb80b0047445d4184u}, // 5^129
+    {0xe6d3102ad96cec1du, 0xa60dc059157491e5u}, // 5^130
+    {0x9043ea1ac7e41392u, 0x87c89837ad68db2fu}, // 5^131
+    {0xb454e4a179dd1877u, 0x29babe4598c311fbu}, // 5^132
+    {0xe16a1dc9d8545e94u, 0xf4296dd6fef3d67au}, // 5^133
+    {0x8ce2529e2734bb1du, 0x1899e4a65f58660cu}, // 5^134
+    {0xb01ae745b101e9e4u, 0x5ec05dcff72e7f8fu}, // 5^135
+    {0xdc21a1171d42645du, 0x76707543f4fa1f73u}, // 5^136
+    {0x899504ae72497ebau, 0x6a06494a791c53a8u}, // 5^137
+    {0xabfa45da0edbde69u, 0x0487db9d17636892u}, // 5^138
+    {0xd6f8d7509292d603u, 0x45a9d2845d3c42b6u}, // 5^139
+    {0x865b86925b9bc5c2u, 0x0b8a2392ba45a9b2u}, // 5^140
+    {0xa7f26836f282b732u, 0x8e6cac7768d7141eu}, // 5^141
+    {0xd1ef0244af2364ffu, 0x3207d795430cd926u}, // 5^142
+    {0x8335616aed761f1fu, 0x7f44e6bd49e807b8u}, // 5^143
+    {0xa402b9c5a8d3a6e7u, 0x5f16206c9c6209a6u}, // 5^144
+    {0xcd036837130890a1u, 0x36dba887c37a8c0fu}, // 5^145
+    {0x802221226be55a64u, 0xc2494954da2c9789u}, // 5^146
+    {0xa02aa96b06deb0fdu, 0xf2db9baa10b7bd6cu}, // 5^147
+    {0xc83553c5c8965d3du, 0x6f92829494e5acc7u}, // 5^148
+    {0xfa42a8b73abbf48cu, 0xcb772339ba1f17f9u}, // 5^149
+    {0x9c69a97284b578d7u, 0xff2a760414536efbu}, // 5^150
+    {0xc38413cf25e2d70du, 0xfef5138519684abau}, // 5^151
+    {0xf46518c2ef5b8cd1u, 0x7eb258665fc25d69u}, // 5^152
+    {0x98bf2f79d5993802u, 0xef2f773ffbd97a61u}, // 5^153
+    {0xbeeefb584aff8603u, 0xaafb550ffacfd8fau}, // 5^154
+    {0xeeaaba2e5dbf6784u, 0x95ba2a53f983cf38u}, // 5^155
+    {0x952ab45cfa97a0b2u, 0xdd945a747bf26183u}, // 5^156
+    {0xba756174393d88dfu, 0x94f971119aeef9e4u}, // 5^157
+    {0xe912b9d1478ceb17u, 0x7a37cd5601aab85du}, // 5^158
+    {0x91abb422ccb812eeu, 0xac62e055c10ab33au}, // 5^159
+    {0xb616a12b7fe617aau, 0x577b986b314d6009u}, // 5^160
+    {0xe39c49765fdf9d94u, 0xed5a7e85fda0b80bu}, // 5^161
+    {0x8e41ade9fbebc27du, 0x14588f13be847307u}, // 5^162
+    {0xb1d219647ae6b31cu, 0x596eb2d8ae258fc8u}, // 5^163
+    {0xde469fbd99a05fe3u, 0x6fca5f8ed9aef3bbu}, // 5^164
+    {0x8aec23d680043beeu, 0x25de7bb9480d5854u}, // 5^165
+    {0xada72ccc20054ae9u, 0xaf561aa79a10ae6au}, // 5^166
+    {0xd910f7ff28069da4u, 0x1b2ba1518094da04u}, // 5^167
+    {0x87aa9aff79042286u, 0x90fb44d2f05d0842u}, // 5^168
+    {0xa99541bf57452b28u, 0x353a1607ac744a53u}, // 5^169
+    {0xd3fa922f2d1675f2u, 0x42889b8997915ce8u}, // 5^170
+    {0x847c9b5d7c2e09b7u, 0x69956135febada11u}, // 5^171
+    {0xa59bc234db398c25u, 0x43fab9837e699095u}, // 5^172
+    {0xcf02b2c21207ef2eu, 0x94f967e45e03f4bbu}, // 5^173
+    {0x8161afb94b44f57du, 0x1d1be0eebac278f5u}, // 5^174
+    {0xa1ba1ba79e1632dcu, 0x6462d92a69731732u}, // 5^175
+    {0xca28a291859bbf93u, 0x7d7b8f7503cfdcfeu}, // 5^176
+    {0xfcb2cb35e702af78u, 0x5cda735244c3d43eu}, // 5^177
+    {0x9defbf01b061adabu, 0x3a0888136afa64a7u}, // 5^178
+    {0xc56baec21c7a1916u, 0x088aaa1845b8fdd0u}, // 5^179
+    {0xf6c69a72a3989f5bu, 0x8aad549e57273d45u}, // 5^180
+    {0x9a3c2087a63f6399u, 0x36ac54e2f678864bu}, // 5^181
+    {0xc0cb28a98fcf3c7fu, 0x84576a1bb416a7ddu}, // 5^182
+    {0xf0fdf2d3f3c30b9fu, 0x656d44a2a11c51d5u}, // 5^183
+    {0x969eb7c47859e743u, 0x9f644ae5a4b1b325u}, // 5^184
+    {0xbc4665b596706114u, 0x873d5d9f0dde1feeu}, // 5^185
+    {0xeb57ff22fc0c7959u, 0xa90cb506d155a7eau}, // 5^186
+    {0x9316ff75dd87cbd8u, 0x09a7f12442d588f2u}, // 5^187
+    {0xb7dcbf5354e9beceu, 0x0c11ed6d538aeb2fu}, // 5^188
+    {0xe5d3ef282a242e81u, 0x8f1668c8a86da5fau}, // 5^189
+    {0x8fa475791a569d10u, 0xf96e017d694487bcu}, // 5^190
+    {0xb38d92d760ec4455u, 0x37c981dcc395a9acu}, // 5^191
+    {0xe070f78d3927556au, 0x85bbe253f47b1417u}, // 5^192
+    {0x8c469ab843b89562u, 0x93956d7478ccec8eu}, // 5^193
+    {0xaf58416654a6babbu, 0x387ac8d1970027b2u}, // 5^194
+    {0xdb2e51bfe9d0696au, 0x06997b05fcc0319eu}, // 5^195
+    {0x88fcf317f22241e2u, 0x441fece3bdf81f03u}, // 5^196
+    {0xab3c2fddeeaad25au, 0xd527e81cad7626c3u}, // 5^197
+    {0xd60b3bd56a5586f1u, 0x8a71e223d8d3b074u}, // 5^198
+    {0x85c7056562757456u, 0xf6872d5667844e49u}, // 5^199
+    {0xa738c6bebb12d16cu, 0xb428f8ac016561dbu}, // 5^200
+    {0xd106f86e69d785c7u, 0xe13336d701beba52u}, // 5^201
+    {0x82a45b450226b39cu, 0xecc0024661173473u}, // 5^202
+    {0xa34d721642b06084u, 0x27f002d7f95d0190u}, // 5^203
+    {0xcc20ce9bd35c78a5u, 0x31ec038df7b441f4u}, // 5^204
+    {0xff290242c83396ceu, 0x7e67047175a15271u}, // 5^205
+    {0x9f79a169bd203e41u, 0x0f0062c6e984d386u}, // 5^206
+    {0xc75809c42c684dd1u, 0x52c07b78a3e60868u}, // 5^207
+    {0xf92e0c3537826145u, 0xa7709a56ccdf8a82u}, // 5^208
+    {0x9bbcc7a142b17ccbu, 0x88a66076400bb691u}, // 5^209
+    {0xc2abf989935ddbfeu, 0x6acff893d00ea435u}, // 5^210
+    {0xf356f7ebf83552feu, 0x0583f6b8c4124d43u}, // 5^211
+    {0x98165af37b2153deu, 0xc3727a337a8b704au}, // 5^212
+    {0xbe1bf1b059e9a8d6u, 0x744f18c0592e4c5cu}, // 5^213
+    {0xeda2ee1c7064130cu, 0x1162def06f79df73u}, // 5^214
+    {0x9485d4d1c63e8be7u, 0x8addcb5645ac2ba8u}, // 5^215
+    {0xb9a74a0637ce2ee1u, 0x6d953e2bd7173692u}, // 5^216
+    {0xe8111c87c5c1ba99u, 0xc8fa8db6ccdd0437u}, // 5^217
+    {0x910ab1d4db9914a0u, 0x1d9c9892400a22a2u}, // 5^218
+    {0xb54d5e4a127f59c8u, 0x2503beb6d00cab4bu}, // 5^219
+    {0xe2a0b5dc971f303au, 0x2e44ae64840fd61du}, // 5^220
+    {0x8da471a9de737e24u, 0x5ceaecfed289e5d2u}, // 5^221
+    {0xb10d8e1456105dadu, 0x7425a83e872c5f47u}, // 5^222
+    {0xdd50f1996b947518u, 0xd12f124e28f77719u}, // 5^223
+    {0x8a5296ffe33cc92fu, 0x82bd6b70d99aaa6fu}, // 5^224
+    {0xace73cbfdc0bfb7bu, 0x636cc64d1001550bu}, // 5^225
+    {0xd8210befd30efa5au, 0x3c47f7e05401aa4eu}, // 5^226
+    {0x8714a775e3e95c78u, 0x65acfaec34810a71u}, // 5^227
+    {0xa8d9d1535ce3b396u, 0x7f1839a741a14d0du}, // 5^228
+    {0xd31045a8341ca07cu, 0x1ede48111209a050u}, // 5^229
+    {0x83ea2b892091e44du, 0x934aed0aab460432u}, // 5^230
+    {0xa4e4b66b68b65d60u, 0xf81da84d5617853fu}, // 5^231
+    {0xce1de40642e3f4b9u, 0x36251260ab9d668eu}, // 5^232
+    {0x80d2ae83e9ce78f3u, 0xc1d72b7c6b426019u}, // 5^233
+    {0xa1075a24e4421730u, 0xb24cf65b8612f81fu}, // 5^234
+    {0xc94930ae1d529cfcu, 0xdee033f26797b627u}, // 5^235
+    {0xfb9b7cd9a4a7443cu, 0x169840ef017da3b1u}, // 5^236
+    {0x9d412e0806e88aa5u, 0x8e1f289560ee864eu}, // 5^237
+    {0xc491798a08a2ad4eu, 0xf1a6f2bab92a27e2u}, // 5^238
+    {0xf5b5d7ec8acb58a2u, 0xae10af696774b1dbu}, // 5^239
+    {0x9991a6f3d6bf1765u, 0xacca6da1e0a8ef29u}, // 5^240
+    {0xbff610b0cc6edd3fu, 0x17fd090a58d32af3u}, // 5^241
+    {0xeff394dcff8a948eu, 0xddfc4b4cef07f5b0u}, // 5^242
+    {0x95f83d0a1fb69cd9u, 0x4abdaf101564f98eu}, // 5^243
+    {0xbb764c4ca7a4440fu, 0x9d6d1ad41abe37f1u}, // 5^244
+    {0xea53df5fd18d5513u, 0x84c86189216dc5edu}, // 5^245
+    {0x92746b9be2f8552cu, 0x32fd3cf5b4e49bb4u}, // 5^246
+    {0xb7118682dbb66a77u, 0x3fbc8c33221dc2a1u}, // 5^247
+    {0xe4d5e82392a40515u, 0x0fabaf3feaa5334au}, // 5^248
+    {0x8f05b1163ba6832du, 0x29cb4d87f2a7400eu}, // 5^249
+    {0xb2c71d5bca9023f8u, 0x743e20e9ef511012u}, // 5^250
+    {0xdf78e4b2bd342cf6u, 0x914da9246b255416u}, // 5^251
+    {0x8bab8eefb6409c1au, 0x1ad089b6c2f7548eu}, // 5^252
+    {0xae9672aba3d0c320u, 0xa184ac2473b529b1u}, // 5^253
+    {0xda3c0f568cc4f3e8u, 0xc9e5d72d90a2741eu}, // 5^254
+    {0x8865899617fb1871u, 0x7e2fa67c7a658892u}, // 5^255
+    {0xaa7eebfb9df9de8du, 0xddbb901b98feeab7u}, // 5^256
+    {0xd51ea6fa85785631u, 0x552a74227f3ea565u}, // 5^257
+    {0x8533285c936b35deu, 0xd53a88958f87275fu}, // 5^258
+    {0xa67ff273b8460356u, 0x8a892abaf368f137u}, // 5^259
+    {0xd01fef10a657842cu, 0x2d2b7569b0432d85u}, // 5^260
+    {0x8213f56a67f6b29bu, 0x9c3b29620e29fc73u}, // 5^261
+    {0xa298f2c501f45f42u, 0x8349f3ba91b47b8fu}, // 5^262
+    {0xcb3f2f7642717713u, 0x241c70a936219a73u}, // 5^263
+    {0xfe0efb53d30dd4d7u, 0xed238cd383aa0110u}, // 5^264
+    {0x9ec95d1463e8a506u, 0xf4363804324a40aau}, // 5^265
+    {0xc67bb4597ce2ce48u, 0xb143c6053edcd0d5u}, // 5^266
+    {0xf81aa16fdc1b81dau, 0xdd94b7868e94050au}, // 5^267
+    {0x9b10a4e5e9913128u, 0xca7cf2b4191c8326u}, // 5^268
+    {0xc1d4ce1f63f57d72u, 0xfd1c2f611f63a3f0u}, // 5^269
+    {0xf24a01a73cf2dccfu, 0xbc633b39673c8cecu}, // 5^270
+    {0x976e41088617ca01u, 0xd5be0503e085d813u}, // 5^271
+    {0xbd49d14aa79dbc82u, 0x4b2d8644d8a74e18u}, // 5^272
+    {0xec9c459d51852ba2u, 0xddf8e7d60ed1219eu}, // 5^273
+    {0x93e1ab8252f33b45u, 0xcabb90e5c942b503u}, // 5^274
+    {0xb8da1662e7b00a17u, 0x3d6a751f3b936243u}, // 5^275
+    {0xe7109bfba19c0c9du, 0x0cc512670a783ad4u}, // 5^276
+    {0x906a617d450187e2u, 0x27fb2b80668b24c5u}, // 5^277
+    {0xb484f9dc9641e9dau, 0xb1f9f660802dedf6u}, // 5^278
+    {0xe1a63853bbd26451u, 0x5e7873f8a0396973u}, // 5^279
+    {0x8d07e33455637eb2u, 0xdb0b487b6423e1e8u}, // 5^280
+    {0xb049dc016abc5e5fu, 0x91ce1a9a3d2cda62u}, // 5^281
+    {0xdc5c5301c56b75f7u, 0x7641a140cc7810fbu}, // 5^282
+    {0x89b9b3e11b6329bau, 0xa9e904c87fcb0a9du}, // 5^283
+    {0xac2820d9623bf429u, 0x546345fa9fbdcd44u}, // 5^284
+    {0xd732290fbacaf133u, 0xa97c177947ad4095u}, // 5^285
+    {0x867f59a9d4bed6c0u, 0x49ed8eabcccc485du}, // 5^286
+    {0xa81f301449ee8c70u, 0x5c68f256bfff5a74u}, // 5^287
+    {0xd226fc195c6a2f8cu, 0x73832eec6fff3111u}, // 5^288
+    {0x83585d8fd9c25db7u, 0xc831fd53c5ff7eabu}, // 5^289
+    {0xa42e74f3d032f525u, 0xba3e7ca8b77f5e55u}, // 5^290
+    {0xcd3a1230c43fb26fu, 0x28ce1bd2e55f35ebu}, // 5^291
+    {0x80444b5e7aa7cf85u, 0x7980d163cf5b81b3u}, // 5^292
+    {0xa0555e361951c366u, 0xd7e105bcc332621fu}, // 5^293
+    {0xc86ab5c39fa63440u, 0x8dd9472bf3fefaa7u}, // 5^294
+    {0xfa856334878fc150u, 0xb14f98f6f0feb951u}, // 5^295
+    {0x9c935e00d4b9d8d2u, 0x6ed1bf9a569f33d3u}, // 5^296
+    {0xc3b8358109e84f07u, 0x0a862f80ec4700c8u}, // 5^297
+    {0xf4a642e14c6262c8u, 0xcd27bb612758c0fau}, // 5^298
+    {0x98e7e9cccfbd7dbdu, 0x8038d51cb897789cu}, // 5^299
+    {0xbf21e44003acdd2cu, 0xe0470a63e6bd56c3u}, // 5^300
+    {0xeeea5d5004981478u, 0x1858ccfce06cac74u}, // 5^301
+    {0x95527a5202df0ccbu, 0x0f37801e0c43ebc8u}, // 5^302
+    {0xbaa718e68396cffdu, 0xd30560258f54e6bau}, // 5^303
+    {0xe950df20247c83fdu, 0x47c6b82ef32a2069u}, // 5^304
+    {0x91d28b7416cdd27eu, 0x4cdc331d57fa5441u}, // 5^305
+    {0xb6472e511c81471du, 0xe0133fe4adf8e952u}, // 5^306
+    {0xe3d8f9e563a198e5u, 0x58180fddd97723a6u}, // 5^307
+    {0x8e679c2f5e44ff8fu, 0x570f09eaa7ea7648u}, // 5^308
+    {0xb201833b35d63f73u, 0x2cd2cc6551e513dau}, // 5^309
+    {0xde81e40a034bcf4fu, 0xf8077f7ea65e58d1u}, // 5^310
+    {0x8b112e86420f6191u, 0xfb04afaf27faf782u}, // 5^311
+    {0xadd57a27d29339f6u, 0x79c5db9af1f9b563u}, // 5^312
+    {0xd94ad8b1c7380874u, 0x18375281ae7822bcu}, // 5^313
+    {0x87cec76f1c830548u, 0x8f2293910d0b15b5u}, // 5^314
+    {0xa9c2794ae3a3c69au, 0xb2eb3875504ddb22u}, // 5^315
+    {0xd433179d9c8cb841u, 0x5fa60692a46151ebu}, // 5^316
+    {0x849feec281d7f328u, 0xdbc7c41ba6bcd333u}, // 5^317
+    {0xa5c7ea73224deff3u, 0x12b9b522906c0800u}, // 5^318
+    {0xcf39e50feae16befu, 0xd768226b34870a00u}, // 5^319
+    {0x81842f29f2cce375u, 0xe6a1158300d46640u}, // 5^320
+    {0xa1e53af46f801c53u, 0x60495ae3c1097fd0u}, // 5^321
+    {0xca5e89b18b602368u, 0x385bb19cb14bdfc4u}, // 5^322
+    {0xfcf62c1dee382c42u, 0x46729e03dd9ed7b5u}, // 5^323
+    {0x9e19db92b4e31ba9u, 0x6c07a2c26a8346d1u}, // 5^324
+    {0xc5a05277621be293u, 0xc7098b7305241885u}  // 5^325
+};
+
+// Computes the full 128-bit product of two 64-bit integers.  The low half is
+// returned and the high half is stored in `hi`.
+inline std::uint64_t umul128(std::uint64_t a,
+                             std::uint64_t b,
+                             std::uint64_t& hi) {
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 uint128;
+    const uint128 p = static_cast<uint128>(a) * b;
+    hi = static_cast<std::uint64_t>(p >> 64);
+    return static_cast<std::uint64_t>(p);
+#else
+    const std::uint64_t a0 = a & 0xffffffffu, a1 = a >> 32;
+    const std::uint64_t b0 = b & 0xffffffffu, b1 = b >> 32;
+    const std::uint64_t p00 = a0 * b0, p01 = a0 * b1;
+    const std::uint64_t p10 = a1 * b0, p11 = a1 * b1;
+    const std::uint64_t mid = (p00 >> 32) + (p01 & 0xffffffffu)
+                            + (p10 & 0xffffffffu);
+    hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    return (mid << 32) | (p00 & 0xffffffffu);
+#endif
+}
+
+// Returns the number of decimal digits in `v` (at least 1).
+inline int decimal_length(std::uint64_t v) {
+    int n = 1;
+    for (;;) {
+        if (v < 10u)    return n;
+        if (v < 100u)   return n + 1;
+        if (v < 1000u)  return n + 2;
+        if (v < 10000u) return n + 3;
+        v /= 10000u;
+        n += 4;
+    }
+}
+
+// Writes the decimal digits of `v` so that they end just before `last` and
+// returns a pointer to the first digit.
+template<class UInt>
+inline char* write_digits_backward(char* last, UInt v) {
+    const char* pairs = digit_pairs<>::value;
+    while (v >= 100u) {
+        const std::size_t i = static_cast<std::size_t>(v % 100u) * 2;
+        v /= 100u;
+        *--last = pairs[i + 1];
+        *--last = pairs[i];
+    }
+    if (v >= 10u) {
+        const std::size_t i = static_cast<std::size_t>(v) * 2;
+        *--last = pairs[i + 1];
+        *--last = pairs[i];
+    } else {
+        *--last = static_cast<char>('0' + v);
+    }
+    return last;
+}
+
+// The unsigned type used to format an integer of type `T`.  Narrow types are
+// widened so that the arithmetic is done at native width.
+template<class T>
+struct to_chars_uint {
+    typedef typename std::conditional<
+        (sizeof(T) <= sizeof(unsigned)),
+        unsigned,
+        unsigned long long
+    >::type type;
+};
+
+inline to_chars_result to_chars_overflow(char* last) {
+    to_chars_result r = {last, std::errc::value_too_large};
+    return r;
+}
+
+inline to_chars_result to_chars_success(char* ptr) {
+    to_chars_result r = {ptr, std::errc()};
+    return r;
+}
+
+// Ryu helpers.  See: Ulf Adams, "Ryu: fast float-to-string conversion",
+// PLDI 2018.  The approximations are valid for all exponents of `double`.
+
+inline int pow5_bits(int e) {
+    return static_cast<int>(
+        (static_cast<std::uint32_t>(e) * 1217359u) >> 19) + 1;
+}
+
+inline int log10_pow2(int e) {
+    return static_cast<int>((static_cast<std::uint32_t>(e) * 78913u) >> 18);
+}
+
+inline int log10_pow5(int e) {
+    return static_cast<int>((static_cast<std::uint32_t>(e) * 732923u) >> 20);
+}
+
+inline bool multiple_of_pow5(std::uint64_t v, int p) {
+    int n = 0;
+    while (v % 5u == 0) {
+        v /= 5u;
+        ++n;
+    }
+    return n >= p;
+}
+
+inline bool multiple_of_pow2(std::uint64_t v, int p) {
+    return (v & ((std::uint64_t(1) << p) - 1)) == 0;
+}
+
+// 5^i truncated to 125 bits.
+inline void ryu_pow5(int i, std::uint64_t& lo, std::uint64_t& hi) {
+    const std::uint64_t* p =
+        pow5_table<>::value[i - pow5_table<>::min_exponent];
+    hi = p[0] >> 3;
+    lo = (p[0] << 61) | (p[1] >> 3);
+}
+
+// 2^k / 5^q rounded down plus one, where k is chosen to give 125 bits.
+inline void ryu_pow5_inv(int q, std::uint64_t& lo, std::uint64_t& hi) {
+    if (q == 0) {
+        hi = std::uint64_t(1) << 61;
+        lo = 1;
+        return;
+    }
+    const std::uint64_t* p =
+        pow5_table<>::value[-q - pow5_table<>::min_exponent];
+    std::uint64_t h = p[0], l = p[1];
+    // Small reciprocals are stored exactly rounded up rather than truncated.
+    if (q <= 27 && l-- == 0)
+        --h;
+    hi = h >> 3;
+    lo = (h << 61) | (l >> 3);
+    if (++lo == 0)
+        ++hi;
+}
+
+// Computes (m * mul) >> j where mul is a 128-bit multiplier and 64 < j < 128.
+inline std::uint64_t ryu_mul_shift(std::uint64_t m,
+                                   std::uint64_t mul_lo,
+                                   std::uint64_t mul_hi,
+                                   int j) {
+    std::uint64_t high0, high1;
+    umul128(m, mul_lo, high0);
+    const std::uint64_t low1 = umul128(m, mul_hi, high1);
+    const std::uint64_t sum = high0 + low1;
+    if (sum < high0)
+        ++high1;
+    const int shift = j - 64;
+    return (high1 << (64 - shift)) | (sum >> shift);
+}
+
+// A decimal floating-point number `digits * 10^exponent`.
+struct decimal_fp {
+    std::uint64_t digits;
+    int exponent;
+};
+
+// Finds the shortest decimal that rounds to the given binary floating-point
+// number, which must be finite and nonzero.  Works for any IEEE format no
+// wider than `double`.
+inline decimal_fp shortest_decimal(std::uint64_t ieee_mantissa,
+                                   std::uint32_t ieee_exponent,
+                                   int mantissa_bits,
+                                   int bias) {
+    decimal_fp r;
+
+    // Fast path for integers that fit in the mantissa.
+    if (ieee_exponent != 0) {
+        const std::uint64_t m = (std::uint64_t(1) << mantissa_bits)
+                              | ieee_mantissa;
+        const int e = static_cast<int>(ieee_exponent) - bias - mantissa_bits;
+        if (e <= 0 && e >= -mantissa_bits
+            && (m & ((std::uint64_t(1) << -e) - 1)) == 0) {
+            r.digits = m >> -e;
+            r.exponent = 0;
+            while (r.digits % 10u == 0) {
+                r.digits /= 10u;
+                ++r.exponent;
+            }
+            return r;
+        }
+    }
+
+    int e2;
+    std::uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - bias - mantissa_bits - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<int>(ieee_exponent) - bias - mantissa_bits - 2;
+        m2 = (std::uint64_t(1) << mantissa_bits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    // Determine the interval of valid decimal representations.
+    const std::uint64_t mv = 4 * m2;
+    const std::uint64_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    // Convert to a decimal power base using 128-bit arithmetic.
+    std::uint64_t vr, vp, vm, mul_lo, mul_hi;
+    int e10;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+    if (e2 >= 0) {
+        const int q = log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        const int k = 125 + pow5_bits(q) - 1;
+        const int i = -e2 + q + k;
+        ryu_pow5_inv(q, mul_lo, mul_hi);
+        vr = ryu_mul_shift(mv, mul_lo, mul_hi, i);
+        vp = ryu_mul_shift(mv + 2, mul_lo, mul_hi, i);
+        vm = ryu_mul_shift(mv - 1 - mm_shift, mul_lo, mul_hi, i);
+        if (q <= 21) {
+            // Only one of mp, mv, and mm can be a multiple of 5, if any.
+            if (mv % 5u == 0)
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            else if (accept_bounds)
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            else
+                vp -= multiple_of_pow5(mv + 2, q);
+        }
+    } else {
+        const int q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = pow5_bits(i) - 125;
+        const int j = q - k;
+        ryu_pow5(i, mul_lo, mul_hi);
+        vr = ryu_mul_shift(mv, mul_lo, mul_hi, j);
+        vp = ryu_mul_shift(mv + 2, mul_lo, mul_hi, j);
+        vm = ryu_mul_shift(mv - 1 - mm_shift, mul_lo, mul_hi, j);
+        if (q <= 1) {
+            // mv = 4 * m2 always has at least two trailing zero bits.
+            vr_trailing_zeros = true;
+            if (accept_bounds)
+                vm_trailing_zeros = mm_shift == 1;
+            else
+                --vp;
+        } else if (q < 63) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // Find the shortest representation in the interval.
+    int removed = 0;
+    unsigned last_removed_digit = 0;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        // General case, which happens rarely (~0.7%).
+        while (vp / 10u > vm / 10u) {
+            vm_trailing_zeros &= vm % 10u == 0;
+            vr_trailing_zeros &= last_removed_digit == 0;
+            last_removed_digit = static_cast<unsigned>(vr % 10u);
+            vr /= 10u;
+            vp /= 10u;
+            vm /= 10u;
+            ++removed;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10u == 0) {
+                vr_trailing_zeros &= last_removed_digit == 0;
+                last_removed_digit = static_cast<unsigned>(vr % 10u);
+                vr /= 10u;
+                vp /= 10u;
+                vm /= 10u;
+                ++removed;
+            }
+        }
+        // Round to even if the exact number is .....50..0.
+        if (vr_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0)
+            last_removed_digit = 4;
+        r.digits = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros))
+                         || last_removed_digit >= 5);
+    } else {
+        // Specialized for the common case (~99.3%).
+        bool round_up = false;
+        if (vp / 100u > vm / 100u) {
+            // Optimization: remove two digits at a time (~86.2%).
+            round_up = vr % 100u >= 50u;
+            vr /= 100u;
+            vp /= 100u;
+            vm /= 100u;
+            removed += 2;
+        }
+        while (vp / 10u > vm / 10u) {
+            round_up = vr % 10u >= 5u;
+            vr /= 10u;
+            vp /= 10u;
+            vm /= 10u;
+            ++removed;
+        }
+        r.digits = vr + (vr == vm || round_up);
+    }
+    r.exponent = e10 + removed;
+    return r;
+}
+
+// Copies `n` characters and returns the end of the destination.
+inline char* copy_chars(char* dest, const char* src, int n) {
+    std::memcpy(dest, src, static_cast<std::size_t>(n));
+    return dest + n;
+}
+
+// Fills `n` characters with '0' and returns the end of the destination.
+inline char* fill_zeros(char* dest, int n) {
+    std::memset(dest, '0', static_cast<std::size_t>(n));
+    return dest + n;
+}
+
+// Writes the integer `m * 2^e` with `0 < e < 32` and returns the end of the
+// output, which has the same length as the shortest decimal of the same
+// value in fixed notation.  The value is split at the ninth decimal digit
+// of `m` so that each half of the product fits in 64 bits.
+inline char* write_binary_integer(char* dest, std::uint64_t m, int e) {
+    const std::uint64_t billion = 1000000000u;
+    std::uint64_t low = (m % billion) << e;
+    const std::uint64_t high = ((m / billion) << e) + low / billion;
+    low %= billion;
+    if (!high) {
+        const int n = decimal_length(low);
+        write_digits_backward(dest + n, low);
+        return dest + n;
+    }
+    const int n = decimal_length(high);
+    write_digits_backward(dest + n, high);
+    fill_zeros(dest + n, 9);
+    write_digits_backward(dest + n + 9, low);
+    return dest + n + 9;
+}
+
+// Writes a decimal in either fixed or scientific notation, whichever is
+// shorter (preferring fixed), in the style of `%f` and `%e` respectively.
+// The value is also given exactly as `m2 * 2^e2`, which is used for large
+// integers in fixed notation: like `%f`, they are written with all of their
+// digits rather than padded with zeros after the shortest ones.
+inline to_chars_result write_shortest(char* first,
+                                      char* last,
+                                      bool negative,
+                                      decimal_fp d,
+                                      std::uint64_t m2,
+                                      int e2) {
+    char digits[20];
+    const int n = decimal_length(d.digits);
+    write_digits_backward(digits + n, d.digits);
+
+    // Scientific exponent, i.e. the value is `d.ddd * 10^x`.
+    const int x = n + d.exponent - 1;
+    const int ax = x < 0 ? -x : x;
+    const int sci_len = n + (n > 1) + 2 + (ax >= 100 ? 3 : 2);
+    const int fixed_len = d.exponent >= 0 ? n + d.exponent
+                        : x >= 0          ? n + 1
+                        :                   1 + n - x;
+    const bool fixed = fixed_len <= sci_len;
+    if (last - first < negative + (fixed ? fixed_len : sci_len))
+        return to_chars_overflow(last);
+
+    if (negative)
+        *first++ = '-';
+    if (fixed) {
+        if (d.exponent > 0 && e2 > 0) {
+            first = write_binary_integer(first, m2, e2);
+        } else if (d.exponent >= 0) {
+            first = copy_chars(first, digits, n);
+            first = fill_zeros(first, d.exponent);
+        } else if (x >= 0) {
+            first = copy_chars(first, digits, x + 1);
+            *first++ = '.';
+            first = copy_chars(first, digits + x + 1, n - x - 1);
+        } else {
+            *first++ = '0';
+            *first++ = '.';
+            first = fill_zeros(first, -x - 1);
+            first = copy_chars(first, digits, n);
+        }
+    } else {
+        *first++ = digits[0];
+        if (n > 1) {
+            *first++ = '.';
+            first = copy_chars(first, digits + 1, n - 1);
+        }
+        *first++ = 'e';
+        *first++ = x < 0 ? '-' : '+';
+        char* const exponent_end = first + (ax >= 100 ? 3 : 2);
+        write_digits_backward(exponent_end, static_cast<unsigned>(ax));
+        if (ax < 10)
+            *first = '0';
+        first = exponent_end;
+    }
+    return to_chars_success(first);
+}
+
+// Formats an IEEE binary floating-point number given its decomposed fields.
+inline to_chars_result float_to_chars(char* first,
+                                      char* last,
+                                      bool negative,
+                                      std::uint32_t ieee_exponent,
+                                      std::uint64_t ieee_mantissa,
+                                      int mantissa_bits,
+                                      int exponent_bits) {
+    const std::uint32_t max_exponent = (1u << exponent_bits) - 1;
+    const int bias = (1 << (exponent_bits - 1)) - 1;
+    if (ieee_exponent == max_exponent || (!ieee_exponent && !ieee_mantissa)) {
+        const char* s = ieee_exponent != max_exponent ? "0"
+                      : ieee_mantissa                 ? "nan"
+                      :                                 "inf";
+        const int len = static_cast<int>(std::strlen(s));
+        if (last - first < negative + len)
+            return to_chars_overflow(last);
+        if (negative)
+            *first++ = '-';
+        return to_chars_success(copy_chars(first, s, len));
+    }
+    const bool normal = ieee_exponent != 0;
+    return write_shortest(first, last, negative,
+                          shortest_decimal(ieee_mantissa, ieee_exponent,
+                                           mantissa_bits, bias),
+                          ieee_mantissa
+                          | std::uint64_t(normal) << mantissa_bits,
+                          static_cast<int>(ieee_exponent + !normal)
+                          - bias - mantissa_bits);
+}
+
+}
+
+/// Writes the decimal representation of an integer into `[first, last)`.
+///
+/// No null terminator is written.  If the range is too small, the result has
+/// `ec == std::errc::value_too_large` and the contents of the range are
+/// unspecified.
+template<class T> inline
+CALICO_ENABLE_IF((std::is_integral<T>::value
+                  && !std::is_same<T, bool>::value), to_chars_result)
+to_chars(char* first, char* last, T value) {
+    typedef typename _priv::to_chars_uint<T>::type uint_type;
+    const bool negative = value < T();
+    uint_type u = static_cast<uint_type>(value);
+    if (negative)
+        u = uint_type() - u;
+    const int n = _priv::decimal_length(u);
+    if (last - first < negative + n)
+        return _priv::to_chars_overflow(last);
+    if (negative)
+        *first++ = '-';
+    _priv::write_digits_backward(first + n, u);
+    return _priv::to_chars_success(first + n);
+}
+
+/// Writes the decimal representation of a `double` into `[first, last)`,
+/// using the fewest significant digits that round-trip.
+///
+/// The output uses fixed or scientific notation, whichever is shorter, in the
+/// style of `%f` and `%e` (e.g. `3.2`, `100`, `1e+22`, `5e-324`).  As with
+/// `%f`, an integer in fixed notation is written exactly, so `2^62` is
+/// `4611686018427387904` even though `4611686018427388000` would round-trip.
+/// NaN and infinity are written as `nan` and `inf`.  No null terminator is
+/// written.  If the range is too small, the result has
+/// `ec == std::errc::value_too_large`.
+inline to_chars_result to_chars(char* first, char* last, double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return _priv::float_to_chars(
+        first, last,
+        (bits >> 63) != 0,
+        static_cast<std::uint32_t>((bits >> 52) & 0x7ffu),
+        bits & ((std::uint64_t(1) << 52) - 1),
+        52, 11);
+}
+
+/// Writes the decimal representation of a `float` into `[first, last)`,
+/// using the fewest significant digits that round-trip.
+///
+/// @see to_chars(char*, char*, double)
+inline to_chars_result to_chars(char* first, char* last, float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return _priv::float_to_chars(
+        first, last,
+        (bits >> 31) != 0,
+        (bits >> 23) & 0xffu,
+        bits & ((std::uint32_t(1) << 23) - 1),
+        23, 8);
+}
+
+namespace _priv {
+
+inline from_chars_result from_chars_error(const char* ptr, std::errc ec) {
+    from_chars_result r = {ptr, ec};
+    return r;
+}
+
+inline bool is_digit(char c) {
+    return static_cast<unsigned>(c - '0') < 10u;
+}
+
+inline unsigned digit_value(char c) {
+    return static_cast<unsigned>(c - '0');
+}
+
+// Loads 8 characters as a little-endian integer regardless of the host byte
+// order.
+inline std::uint64_t load_le64(const char* p) {
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// Whether all 8 characters packed by `load_le64` are decimal digits.
+inline bool is_eight_digits(std::uint64_t v) {
+    return (((v + 0x4646464646464646u) | (v - 0x3030303030303030u))
+            & 0x8080808080808080u) == 0;
+}
+
+// Converts 8 digits packed by `load_le64` using three multiplications
+// instead of eight.  Adjacent digits are combined into pairs, then the pairs
+// into the two halves, which are combined by a single 64-bit product.
+inline std::uint32_t parse_eight_digits(std::uint64_t v) {
+    const std::uint64_t mask = 0x000000ff000000ffu;
+    const std::uint64_t mul1 = 100u + (1000000ull << 32);
+    const std::uint64_t mul2 = 1u + (10000ull << 32);
+    v -= 0x3030303030303030u;
+    v = v * 10u + (v >> 8);
+    v = ((v & mask) * mul1 + ((v >> 16) & mask) * mul2) >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+
+// Properties of the IEEE binary formats needed by the parser.
+template<class T> struct float_traits;
+template<> struct float_traits<double> {
+    typedef std::uint64_t bits_type;
+    static const int mantissa_bits = 52;
+    static const int exponent_bits = 11;
+    static const int smallest_power_of_ten = -342;
+    static const int largest_power_of_ten = 308;
+    static const int min_exponent_round_to_even = -4;
+    static const int max_exponent_round_to_even = 23;
+    static const int max_exponent_fast_path = 22;
+    static double exact_power_of_ten(int i) {
+        static const double table[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+            1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+            1e22
+        };
+        return table[i];
+    }
+};
+template<> struct float_traits<float> {
+    typedef std::uint32_t bits_type;
+    static const int mantissa_bits = 23;
+    static const int exponent_bits = 8;
+    static const int smallest_power_of_ten = -65;
+    static const int largest_power_of_ten = 38;
+    static const int min_exponent_round_to_even = -17;
+    static const int max_exponent_round_to_even = 10;
+    static const int max_exponent_fast_path = 10;
+    static float exact_power_of_ten(int i) {
+        static const float table[] = {
+            1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+        };
+        return table[i];
+    }
+};
+
+// A decimal number as scanned from the input, with at most 19 significant
+// digits kept in `mantissa` so that the value is roughly
+// `mantissa * 10^exponent`.
+struct scanned_decimal {
+    std::uint64_t mantissa;
+    int exponent;
+    int explicit_exponent;
+    bool negative;
+    bool truncated;           // whether nonzero digits were dropped
+    const char* digits_first; // first digit (or decimal point)
+    const char* digits_last;  // one past the last mantissa digit
+    const char* last;         // one past the end of the number
+};
+
+// Scans `[-]digits[.digits][(e|E)[+|-]digits]`.  Returns false if there are
+// no mantissa digits.
+inline bool scan_decimal(const char* first,
+                         const char* last,
+                         scanned_decimal& d) {
+    const char* p = first;
+    d.negative = p != last && *p == '-';
+    if (d.negative)
+        ++p;
+    d.digits_first = p;
+    std::uint64_t w = 0;
+    int significant = 0, exponent = 0;
+    bool any = false, truncated = false;
+    for (; p != last && is_digit(*p); ++p) {
+        // Once past the leading zeros, consume whole blocks of 8 digits.
+        while (w && significant <= 11 && last - p >= 8
+               && is_eight_digits(load_le64(p))) {
+            w = w * 100000000u + parse_eight_digits(load_le64(p));
+            significant += 8;
+            p += 8;
+        }
+        if (p == last || !is_digit(*p))
+            break;
+        const unsigned digit = digit_value(*p);
+        any = true;
+        if (significant < 19) {
+            if (w || digit) {
+                w = w * 10u + digit;
+                ++significant;
+            }
+        } else {
+            ++exponent;
+            truncated |= digit != 0;
+        }
+    }
+    if (p != last && *p == '.') {
+        ++p;
+        for (; p != last && is_digit(*p); ++p) {
+            while (w && significant <= 11 && last - p >= 8
+                   && is_eight_digits(load_le64(p))) {
+                w = w * 100000000u + parse_eight_digits(load_le64(p));
+                significant += 8;
+                exponent -= 8;
+                p += 8;
+            }
+            if (p == last || !is_digit(*p))
+                break;
+            const unsigned digit = digit_value(*p);
+            any = true;
+            if (significant < 19) {
+                if (w || digit) {
+                    w = w * 10u + digit;
+                    ++significant;
+                }
+                --exponent;
+            } else {
+                truncated |= digit != 0;
+            }
+        }
+    }
+    if (!any)
+        return false;
+    d.digits_last = p;
+    d.explicit_exponent = 0;
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool negative_exponent = false;
+        if (q != last && (*q == '+' || *q == '-')) {
+            negative_exponent = *q == '-';
+            ++q;
+        }
+        if (q != last && is_digit(*q)) {
+            int e = 0;
+            for (; q != last && is_digit(*q); ++q)
+                if (e < 100000)
+                    e = e * 10 + static_cast<int>(digit_value(*q));
+            d.explicit_exponent = negative_exponent ? -e : e;
+            p = q;
+        }
+    }
+    d.mantissa = w;
+    d.exponent = exponent + d.explicit_exponent;
+    d.truncated = truncated;
+    d.last = p;
+    return true;
+}
+
+// A binary floating-point number as a mantissa (without the implicit bit)
+// and a biased exponent.  A negative exponent indicates that the result
+// could not be determined.
+struct adjusted_mantissa {
+    std::uint64_t mantissa;
+    int power2;
+};
+
+inline bool operator==(const adjusted_mantissa& a,
+                       const adjusted_mantissa& b) {
+    return a.mantissa == b.mantissa && a.power2 == b.power2;
+}
+
+inline int leading_zeros(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    for (; !(x >> 63); x <<= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// Eisel-Lemire algorithm.  See: Daniel Lemire, "Number Parsing at a
+// Gigabyte per Second", Software: Practice and Experience 51 (8), 2021.
+template<class T>
+inline adjusted_mantissa eisel_lemire(int q, std::uint64_t w) {
+    typedef float_traits<T> traits;
+    const int mantissa_bits = traits::mantissa_bits;
+    const int infinite_power = (1 << traits::exponent_bits) - 1;
+    const int min_exponent = -((1 << (traits::exponent_bits - 1)) - 1);
+    adjusted_mantissa r;
+    if (w == 0 || q < traits::smallest_power_of_ten) {
+        r.mantissa = 0;
+        r.power2 = 0;
+        return r;
+    }
+    if (q > traits::largest_power_of_ten) {
+        r.mantissa = 0;
+        r.power2 = infinite_power;
+        return r;
+    }
+    const int lz = leading_zeros(w);
+    w <<= lz;
+
+    // Compute the product with just enough precision.
+    const std::uint64_t* p5 =
+        pow5_table<>::value[q - pow5_table<>::min_exponent];
+    std::uint64_t high, low = umul128(w, p5[0], high);
+    const std::uint64_t precision_mask =
+        ~std::uint64_t() >> (mantissa_bits + 3);
+    if ((high & precision_mask) == precision_mask) {
+        std::uint64_t high2;
+        umul128(w, p5[1], high2);
+        low += high2;
+        if (high2 > low)
+            ++high;
+    }
+    if (low == ~std::uint64_t() && (q < -27 || q > 55)) {
+        r.mantissa = 0;
+        r.power2 = -1;
+        return r;
+    }
+
+    const int upper_bit = static_cast<int>(high >> 63);
+    const int shift = upper_bit + 64 - mantissa_bits - 3;
+    r.mantissa = high >> shift;
+    r.power2 = (((152170 + 65536) * q) >> 16) + 63 + upper_bit - lz
+             - min_exponent;
+    if (r.power2 <= 0) {
+        // Subnormal.
+        if (-r.power2 + 1 >= 64) {
+            r.mantissa = 0;
+            r.power2 = 0;
+            return r;
+        }
+        r.mantissa >>= -r.power2 + 1;
+        r.mantissa += r.mantissa & 1;
+        r.mantissa >>= 1;
+        r.power2 = r.mantissa < (std::uint64_t(1) << mantissa_bits) ? 0 : 1;
+        return r;
+    }
+    // Avoid rounding up when the value is exactly halfway.
+    if (low <= 1
+        && q >= traits::min_exponent_round_to_even
+        && q <= traits::max_exponent_round_to_even
+        && (r.mantissa & 3) == 1
+        && (r.mantissa << shift) == high)
+        r.mantissa &= ~std::uint64_t(1);
+    r.mantissa += r.mantissa & 1;
+    r.mantissa >>= 1;
+    if (r.mantissa >= (std::uint64_t(2) << mantissa_bits)) {
+        r.mantissa = std::uint64_t(1) << mantissa_bits;
+        ++r.power2;
+    }
+    r.mantissa &= ~(std::uint64_t(1) << mantissa_bits);
+    if (r.power2 >= infinite_power) {
+        r.power2 = infinite_power;
+        r.mantissa = 0;
+    }
+    return r;
+}
+
+// Arbitrary-precision decimal `0.d[0]d[1]... * 10^dp` used as the slow path
+// when Eisel-Lemire cannot decide the rounding.  Adapted from the Go
+// standard library (strconv/decimal.go).
+struct big_decimal {
+    static const int max_digits = 800;
+    static const int max_shift = 60;
+    unsigned char d[max_digits + 20]; // digits 0-9, with room for a shift
+    int nd;                           // number of digits used
+    int dp;                           // decimal point
+    bool trunc;                       // discarded nonzero digits
+
+    void assign(const char* p, const char* last, int explicit_exponent) {
+        int n = 0;
+        bool saw_dot = false;
+        nd = 0;
+        dp = 0;
+        trunc = false;
+        for (; p != last; ++p) {
+            if (*p == '.') {
+                saw_dot = true;
+                dp = n;
+                continue;
+            }
+            const unsigned char digit =
+                static_cast<unsigned char>(digit_value(*p));
+            if (digit == 0 && n == 0) {
+                --dp; // leading zero
+                continue;
+            }
+            ++n;
+            if (nd < max_digits)
+                d[nd++] = digit;
+            else if (digit != 0)
+                trunc = true;
+        }
+        if (!saw_dot)
+            dp = n;
+        dp += explicit_exponent;
+        trim();
+    }
+
+    void trim() {
+        while (nd > 0 && d[nd - 1] == 0)
+            --nd;
+        if (nd == 0)
+            dp = 0;
+    }
+
+    // Divides by 2^k, where k <= max_shift.
+    void right_shift(int k) {
+        int r = 0, w = 0;
+        std::uint64_t n = 0;
+        for (; !(n >> k); ++r) {
+            if (r >= nd) {
+                if (n == 0) {
+                    nd = 0;
+                    return;
+                }
+                for (; !(n >> k); ++r)
+                    n *= 10u;
+                break;
+            }
+            n = n * 10u + d[r];
+        }
+        dp -= r - 1;
+        const std::uint64_t mask = (std::uint64_t(1) << k) - 1;
+        for (; r < nd; ++r) {
+            const std::uint64_t digit = n >> k;
+            n &= mask;
+            d[w++] = static_cast<unsigned char>(digit);
+            n = n * 10u + d[r];
+        }
+        while (n > 0) {
+            const std::uint64_t digit = n >> k;
+            n &= mask;
+            if (w < max_digits)
+                d[w++] = static_cast<unsigned char>(digit);
+            else if (digit > 0)
+                trunc = true;
+            n *= 10u;
+        }
+        nd = w;
+        trim();
+    }
+
+    // Multiplies by 2^k, where k <= max_shift.  The product is written with
+    // enough headroom for the new digits and then moved into place.
+    void left_shift(int k) {
+        const int headroom = 19;
+        int r = nd, w = nd + headroom;
+        std::uint64_t n = 0;
+        while (r > 0) {
+            n += static_cast<std::uint64_t>(d[--r]) << k;
+            d[--w] = static_cast<unsigned char>(n % 10u);
+            n /= 10u;
+        }
+        while (n > 0) {
+            d[--w] = static_cast<unsigned char>(n % 10u);
+            n /= 10u;
+        }
+        const int delta = headroom - w;
+        int count = nd + delta;
+        if (count > max_digits) {
+            for (int i = max_digits; i != count; ++i)
+                trunc |= d[w + i] != 0;
+            count = max_digits;
+        }
+        std::memmove(d, d + w, static_cast<std::size_t>(count));
+        nd = count;
+        dp += delta;
+        trim();
+    }
+
+    void shift(int k) {
+        if (nd == 0)
+            return;
+        for (; k > max_shift; k -= max_shift)
+            left_shift(max_shift);
+        for (; k < -max_shift; k += max_shift)
+            right_shift(max_shift);
+        if (k > 0)
+            left_shift(k);
+        else if (k < 0)
+            right_shift(-k);
+    }
+
+    bool should_round_up(int i) const {
+        if (i < 0 || i >= nd)
+            return false;
+        // Exactly halfway: round to even unless digits were discarded.
+        if (d[i] == 5 && i + 1 == nd)
+            return trunc || (i > 0 && d[i - 1] % 2 == 1);
+        return d[i] >= 5;
+    }
+
+    std::uint64_t rounded_integer() const {
+        if (dp > 20)
+            return ~std::uint64_t();
+        int i = 0;
+        std::uint64_t n = 0;
+        for (; i < dp && i < nd; ++i)
+            n = n * 10u + d[i];
+        for (; i < dp; ++i)
+            n *= 10u;
+        return n + should_round_up(dp);
+    }
+
+    template<class T>
+    adjusted_mantissa to_binary() {
+        typedef float_traits<T> traits;
+        const int mantissa_bits = traits::mantissa_bits;
+        const int infinite_power = (1 << traits::exponent_bits) - 1;
+        const int bias = -((1 << (traits::exponent_bits - 1)) - 1);
+        static const int powers[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+        const int npowers = sizeof(powers) / sizeof(*powers);
+        adjusted_mantissa r;
+        if (nd == 0 || dp < -330) {
+            r.mantissa = 0;
+            r.power2 = 0;
+            return r;
+        }
+        if (dp > 310) {
+            r.mantissa = 0;
+            r.power2 = infinite_power;
+            return r;
+        }
+
+        // Scale by powers of two until in range [0.5, 1).
+        int exp = 0;
+        while (dp > 0) {
+            const int n = dp >= npowers ? 27 : powers[dp];
+            shift(-n);
+            exp += n;
+        }
+        while (dp < 0 || (dp == 0 && d[0] < 5)) {
+            const int n = -dp >= npowers ? 27 : powers[-dp];
+            shift(n);
+            exp -= n;
+        }
+
+        // Our range is [0.5, 1) but the floating-point range is [1, 2).
+        --exp;
+        if (exp < bias + 1) {
+            const int n = bias + 1 - exp;
+            shift(-n);
+            exp += n;
+        }
+        if (exp - bias >= infinite_power) {
+            r.mantissa = 0;
+            r.power2 = infinite_power;
+            return r;
+        }
+
+        // Extract 1 + mantissa_bits bits.
+        shift(1 + mantissa_bits);
+        std::uint64_t mantissa = rounded_integer();
+        if (mantissa == std::uint64_t(2) << mantissa_bits) {
+            mantissa >>= 1;
+            if (++exp - bias >= infinite_power) {
+                r.mantissa = 0;
+                r.power2 = infinite_power;
+                return r;
+            }
+        }
+        if (!(mantissa & (std::uint64_t(1) << mantissa_bits)))
+            exp = bias; // subnormal
+        r.mantissa = mantissa & ((std::uint64_t(1) << mantissa_bits) - 1);
+        r.power2 = exp - bias;
+        return r;
+    }
+};
+
+// Case-insensitive match of a lowercase ASCII word at the start of a range.
+inline bool match_word(const char* first, const char* last, const char* word) {
+    for (; *word; ++first, ++word)
+        if (first == last || (*first | 0x20) != *word)
+            return false;
+    return true;
+}
+
+template<class T>
+inline from_chars_result parse_float(const char* first,
+                                     const char* last,
+                                     T& value) {
+    typedef float_traits<T> traits;
+    typedef typename traits::bits_type bits_type;
+    const int mantissa_bits = traits::mantissa_bits;
+    const int infinite_power = (1 << traits::exponent_bits) - 1;
+
+    scanned_decimal d;
+    if (!scan_decimal(first, last, d)) {
+        // Try infinity or NaN.
+        const char* p = d.digits_first;
+        if (match_word(p, last, "inf")) {
+            p += match_word(p, last, "infinity") ? 8 : 3;
+            value = d.negative ? -std::numeric_limits<T>::infinity()
+                               :  std::numeric_limits<T>::infinity();
+            return from_chars_error(p, std::errc());
+        }
+        if (match_word(p, last, "nan")) {
+            p += 3;
+            // Optional "(n-char-sequence)".
+            if (p != last && *p == '(') {
+                const char* q = p + 1;
+                while (q != last && (is_digit(*q) || *q == '_'
+                                     || ((*q | 0x20) >= 'a'
+                                         && (*q | 0x20) <= 'z')))
+                    ++q;
+                if (q != last && *q == ')')
+                    p = q + 1;
+            }
+            value = d.negative ? -std::numeric_limits<T>::quiet_NaN()
+                               :  std::numeric_limits<T>::quiet_NaN();
+            return from_chars_error(p, std::errc());
+        }
+        return from_chars_error(first, std::errc::invalid_argument);
+    }
+
+#if FLT_EVAL_METHOD == 0
+    // Clinger's fast path: both the mantissa and the power of ten are exact.
+    if (!d.truncated
+        && d.mantissa <= std::uint64_t(1) << (mantissa_bits + 1)
+        && d.exponent >= -traits::max_exponent_fast_path
+        && d.exponent <= traits::max_exponent_fast_path) {
+        T x = static_cast<T>(d.mantissa);
+        if (d.exponent < 0)
+            x /= traits::exact_power_of_ten(-d.exponent);
+        else
+            x *= traits::exact_power_of_ten(d.exponent);
+        value = d.negative ? -x : x;
+        return from_chars_error(d.last, std::errc());
+    }
+#endif
+
+    adjusted_mantissa am = eisel_lemire<T>(d.exponent, d.mantissa);
+    // With dropped digits the true value lies between w and w + 1.
+    if (d.truncated && am.power2 >= 0
+        && !(am == eisel_lemire<T>(d.exponent, d.mantissa + 1)))
+        am.power2 = -1;
+    if (am.power2 < 0) {
+        big_decimal big;
+        big.assign(d.digits_first, d.digits_last, d.explicit_exponent);
+        am = big.to_binary<T>();
+    }
+
+    if (am.power2 == infinite_power
+        || (am.power2 == 0 && am.mantissa == 0 && d.mantissa != 0))
+        return from_chars_error(d.last, std::errc::result_out_of_range);
+    const bits_type bits = static_cast<bits_type>(
+        (static_cast<std::uint64_t>(d.negative)
+             << (mantissa_bits + traits::exponent_bits))
+        | (static_cast<std::uint64_t>(am.power2) << mantissa_bits)
+        | am.mantissa);
+    std::memcpy(&value, &bits, sizeof(value));
+    return from_chars_error(d.last, std::errc());
+}
+
+}
+
+/// Parses a decimal integer at the beginning of `[first, last)`.
+///
+/// The input must match `[-]digits`, where the minus sign is only accepted
+/// for signed types.  Leading whitespace and a plus sign are not accepted.
+/// On error, `value` is left unmodified; if the integer does not fit, `ptr`
+/// still points past all of its digits.
+template<class T> inline
+CALICO_ENABLE_IF((std::is_integral<T>::value
+                  && !std::is_same<T, bool>::value), from_chars_result)
+from_chars(const char* first, const char* last, T& value) {
+    typedef typename _priv::to_chars_uint<T>::type uint_type;
+    const char* p = first;
+    const bool negative = std::is_signed<T>::value && p != last && *p == '-';
+    if (negative)
+        ++p;
+    const char* const digits = p;
+    const uint_type limit =
+        static_cast<uint_type>(std::numeric_limits<T>::max()) + negative;
+    uint_type u = 0;
+    bool overflow = false;
+    for (; p != last && _priv::is_digit(*p); ++p) {
+        const unsigned digit = _priv::digit_value(*p);
+        if (u > (limit - digit) / 10u)
+            overflow = true;
+        else
+            u = u * 10u + digit;
+    }
+    if (p == digits)
+        return _priv::from_chars_error(first, std::errc::invalid_argument);
+    if (overflow)
+        return _priv::from_chars_error(p, std::errc::result_out_of_range);
+    value = static_cast<T>(negative ? uint_type() - u : u);
+    return _priv::from_chars_error(p, std::errc());
+}
+
+/// Parses a decimal floating-point number at the beginning of
+/// `[first, last)`.
+///
+/// The input must match `[-]digits[.digits][(e|E)[+|-]digits]` (where
+/// either group of digits may be empty, but not both), or one of `inf`,
+/// `infinity`, `nan` and `nan(...)` in any case, optionally preceded by a
+/// minus sign.  The result is correctly rounded.  On error, `value` is left
+/// unmodified; overflow and underflow to zero are reported as
+/// `std::errc::result_out_of_range`.
+inline from_chars_result from_chars(const char* first,
+                                    const char* last,
+                                    double& value) {
+    return _priv::parse_float(first, last, value);
+}
+
+/// Parses a decimal floating-point number at the beginning of
+/// `[first, last)`.
+///
+/// @see from_chars(const char*, const char*, double&)
+inline from_chars_result from_chars(const char* first,
+                                    const char* last,
+                                    float& value) {
+    return _priv::parse_float(first, last, value);
+}
+
+/// The result of `parse_column`.
+struct parse_column_result {
+    /// `last` on success; otherwise, the beginning of the first field that
+    /// could not be parsed.
+    const char* ptr;
+
+    /// `std::errc()` on success, `std::errc::invalid_argument` if a field is
+    /// empty or is not a number followed by a separator, or
+    /// `std::errc::result_out_of_range` if a value does not fit.
+    std::errc ec;
+
+    /// Number of values written, i.e. the number of fields before `ptr`.
+    std::size_t count;
+};
+
+namespace _priv {
+
+// Replaces the low `n` bytes of `v` (packed by `load_le64`) with '0'.
+inline std::uint64_t pad_zeros(std::uint64_t v, std::size_t n) {
+    static const std::uint64_t masks[] = {
+        0, 0xff, 0xffff, 0xffffff, 0xffffffff, 0xffffffffff, 0xffffffffffff,
+        0xffffffffffffff, 0xffffffffffffffff
+    };
+    const std::uint64_t m = masks[n];
+    return (v & ~m) | (0x3030303030303030u & m);
+}
+
+// Parses the integer field `[first, last)` of a buffer that starts at
+// `begin`, returning false if the field needs the general path.
+//
+// Up to 16 digits are converted without branching on their count: the 16
+// bytes ending at the last digit are loaded, everything before the first
+// digit is replaced with '0', and the two halves are validated and
+// converted 8 digits at a time.
+template<class T>
+inline bool parse_column_fast(const char* begin,
+                              const char* first,
+                              const char* last,
+                              T& value,
+                              std::true_type) {
+    typedef typename to_chars_uint<T>::type uint_type;
+    const bool negative = std::is_signed<T>::value && first != last
+                       && *first == '-';
+    const std::size_t n = static_cast<std::size_t>(last - first) - negative;
+    if (n - 1 >= 16 || last - begin < 16)
+        return false;
+    const std::size_t pad = 16 - n;
+    const std::uint64_t hi =
+        pad_zeros(load_le64(last - 16), pad < 8 ? pad : 8);
+    const std::uint64_t lo =
+        pad_zeros(load_le64(last - 8), pad < 8 ? 0 : pad - 8);
+    if (!is_eight_digits(hi) || !is_eight_digits(lo))
+        return false;
+    const std::uint64_t u =
+        static_cast<std::uint64_t>(parse_eight_digits(hi)) * 100000000u
+        + parse_eight_digits(lo);
+    if (u > static_cast<std::uint64_t>(std::numeric_limits<T>::max())
+            + negative)
+        return false;
+    const uint_type v = static_cast<uint_type>(u);
+    value = static_cast<T>(negative ? uint_type() - v : v);
+    return true;
+}
+
+template<class T>
+inline bool parse_column_fast(const char*,
+                              const char* first,
+                              const char* last,
+                              T& value,
+                              std::false_type) {
+    const from_chars_result r = from_chars(first, last, value);
+    return r.ec == std::errc() && r.ptr == last;
+}
+
+// Parses the field at `first` along with the separator that follows it,
+// returning the start of the next field.
+template<class T>
+inline from_chars_result parse_column_field(const char* first,
+                                            const char* last,
+                                            T& value,
+                                            char delimiter) {
+    from_chars_result r = from_chars(first, last, value);
+    if (r.ec != std::errc() || r.ptr == last)
+        return r;
+    if (*r.ptr == '\r' && last - r.ptr > 1 && r.ptr[1] == '\n')
+        ++r.ptr;
+    if (*r.ptr != delimiter && *r.ptr != '\n')
+        return from_chars_error(first, std::errc::invalid_argument);
+    ++r.ptr;
+    return r;
+}
+
+}
+
+/// Parses every number in a buffer of delimited fields, writing each value
+/// to `out` in turn.
+///
+/// Fields are separated by `delimiter` or by a line break (`\n` or
+/// `\r\n`), and each must match the corresponding `from_chars` grammar
+/// exactly: no whitespace is skipped.  A single trailing line break is
+/// allowed, but a trailing delimiter is an empty last field and therefore
+/// an error, as is an empty field anywhere else.  Parsing stops at the
+/// first malformed field; the values before it have already been written.
+///
+/// This is the bulk counterpart to calling `parse` on each field separately.
+/// Separators are located 64 bytes at a time with SIMD where available, and
+/// integers of up to 16 digits are converted 8 digits at a time without
+/// scanning them first.
+template<class T, class OutputIterator> inline
+parse_column_result parse_column(const char* first,
+                                 const char* last,
+                                 OutputIterator out,
+                                 char delimiter = ',') {
+    static_assert(std::is_arithmetic<T>::value
+                  && !std::is_same<T, bool>::value,
+                  "parse_column requires an integer or floating-point type");
+    parse_column_result r = {first, std::errc(), 0};
+    const char* p = first;
+    T value;
+    for (const char* block = first; last - block >= 64; block += 64) {
+        std::uint64_t m = _priv::match_mask64(block, delimiter, '\n');
+        for (; m; m &= m - 1) {
+            const char* const sep = block + _priv::count_trailing_zeros(m);
+            const char* end = sep;
+            if (*sep == '\n' && end != p && end[-1] == '\r')
+                --end;
+            if (!_priv::parse_column_fast(first, p, end, value,
+                                          std::is_integral<T>())) {
+                // Either the value is unusual or the field is malformed;
+                // the general path tells which.  A valid field always ends
+                // at `sep`, since it cannot contain a separator.
+                const from_chars_result f =
+                    _priv::parse_column_field(p, last, value, delimiter);
+                if (f.ec != std::errc()) {
+                    r.ptr = p;
+                    r.ec = f.ec;
+                    return r;
+                }
+            }
+            *out = value;
+            ++out;
+            ++r.count;
+            p = sep + 1;
+        }
+    }
+    while (p != last) {
+        const from_chars_result f =
+            _priv::parse_column_field(p, last, value, delimiter);
+        if (f.ec != std::errc()) {
+            r.ptr = p;
+            r.ec = f.ec;
+            return r;
+        }
+        *out = value;
+        ++out;
+        ++r.count;
+        p = f.ptr;
+    }
+    r.ptr = last;
+    // A trailing delimiter leaves an empty field, like `,,` does.
+    if (p != first && p[-1] == delimiter && delimiter != '\n')
+        r.ec = std::errc::invalid_argument;
+    return r;
+}
+
+/// Parses every number in a buffer of delimited fields, appending the
+/// values to `values`.
+///
+/// @see parse_column(const char*, const char*, OutputIterator, char)
+template<class T, class Allocator> inline
+parse_column_result parse_column(const char* first,
+                                 const char* last,
+                                 std::vector<T, Allocator>& values,
+                                 char delimiter = ',') {
+    return parse_column<T>(first, last, std::back_inserter(values),
+                           delimiter);
+}
+
+}
+#endif
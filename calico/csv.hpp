@@ -0,0 +1,483 @@
+#ifndef VKQZTRBNWMHXJCDPELSF
+#define VKQZTRBNWMHXJCDPELSF
+/// @file
+///
+/// Streaming reader for delimited text (CSV, TSV, and the like) with typed
+/// rows.
+///
+/// The input is read in chunks into a single buffer, which only grows if a
+/// record does not fit, so arbitrarily large files can be processed in
+/// memory proportional to the chunk size.  Records are located with the
+/// vectorized scanner in `simd.hpp`, and fields are converted straight from
+/// the buffer without creating intermediate strings.
+///
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "iterator.hpp"
+#include "simd.hpp"
+#include "string.hpp"
+#include "utility.hpp"
+namespace cal {
+
+/// Thrown by `csv_reader` if a record does not match the row schema.
+class csv_error : public std::runtime_error {
+public:
+    /// Constructs the exception with an explanatory message and the
+    /// (1-based) position of the offending field.
+    csv_error(const std::string& what, std::size_t row, std::size_t column)
+        : std::runtime_error(what), _row(row), _column(column) {}
+
+    /// Returns the number of the record, counting from 1 and including any
+    /// header but not blank lines.
+    std::size_t row() const { return _row; }
+
+    /// Returns the number of the field within the record, counting from 1.
+    std::size_t column() const { return _column; }
+
+private:
+    std::size_t _row;
+    std::size_t _column;
+};
+
+namespace _priv {
+
+// Treats each type of the schema as a `tuple` of one element unless it is
+// already a `tuple`.
+template<class T>
+struct csv_tuple {
+    typedef std::tuple<T> type;
+};
+template<class... Ts>
+struct csv_tuple<std::tuple<Ts...> > {
+    typedef std::tuple<Ts...> type;
+};
+
+template<class Tuple>
+struct csv_columns;
+template<class... Ts>
+struct csv_columns<std::tuple<Ts...> > {
+    typedef std::tuple<std::vector<Ts>...> type;
+};
+
+template<class Tuple>
+struct csv_has_string_ref : std::false_type {};
+template<class T, class... Ts>
+struct csv_has_string_ref<std::tuple<T, Ts...> > : std::integral_constant<
+    bool, std::is_same<T, string_ref>::value
+          || csv_has_string_ref<std::tuple<Ts...> >::value> {};
+
+// Returns the line break that ends the record starting at `p`, skipping
+// those within quotes, or `last` if the record is incomplete.  Every quote
+// toggles the state, which also handles escaped (doubled) quotes.
+inline const char* csv_record_end(const char* p, const char* last) {
+    bool quoted = false;
+    for (; last - p >= 64; p += 64) {
+        for (std::uint64_t m = match_mask64(p, '\n', '"'); m; m &= m - 1) {
+            const char* const q = p + count_trailing_zeros(m);
+            if (*q == '"')
+                quoted = !quoted;
+            else if (!quoted)
+                return q;
+        }
+    }
+    for (; p != last; ++p) {
+        if (*p == '"')
+            quoted = !quoted;
+        else if (*p == '\n' && !quoted)
+            return p;
+    }
+    return last;
+}
+
+template<class T>
+inline bool csv_parse_field(const char* first, const char* last, T& value) {
+    const from_chars_result r = cal::parse(first, last, value);
+    return r.ec == std::errc() && r.ptr == last;
+}
+
+inline bool csv_parse_field(const char* first,
+                            const char* last,
+                            std::string& value) {
+    value.assign(first, last);
+    return true;
+}
+
+inline bool csv_parse_field(const char* first,
+                            const char* last,
+                            string_ref& value) {
+    value = string_ref(first, static_cast<std::size_t>(last - first));
+    return true;
+}
+
+}
+
+/// Reads delimited text one record at a time, converting the fields of each
+/// record into a `tuple` of the given types.
+///
+/// Each type in `Ts` describes one field, except that a `std::tuple` type
+/// describes several consecutive fields, so that `ntuple_t` can be used for
+/// runs of fields of the same type.  For example, the rows of
+/// `csv_reader<std::string, ntuple_t<double, 3> >` are
+/// `std::tuple<std::string, double, double, double>`.
+///
+/// Numbers (and any other type that `parse` supports) must span the whole
+/// field, apart from leading whitespace.  `std::string` fields receive a
+/// copy of the characters, while `string_ref` fields refer directly to the
+/// reader's buffer and are only valid until the next record is read.
+///
+/// Records end with `\n` or `\r\n`, and blank lines are skipped.  As in
+/// RFC 4180, a field may be enclosed in double quotes, in which case it can
+/// contain delimiters, line breaks, and doubled quotes that stand for a
+/// single quote.  Quotes are unescaped in place within the buffer.  A field
+/// that contains a quote must be quoted.
+///
+/// @throws csv_error          If a record has the wrong number of fields or
+///                            a field cannot be converted.
+/// @throws std::system_error  If reading from a file fails.
+template<class... Ts>
+class csv_reader {
+public:
+
+    /// The `tuple` type of each row.
+    typedef combine_tuples_t<typename _priv::csv_tuple<Ts>::type...>
+        row_type;
+
+    /// A `tuple` of vectors, one for each column, filled by `read_columns`.
+    typedef typename _priv::csv_columns<row_type>::type columns_type;
+
+    /// The number of fields in each record.
+    static const std::size_t column_count = std::tuple_size<row_type>::value;
+
+    static_assert(column_count != 0, "csv_reader requires at least one field");
+
+    /// An `InputIterator` over the rows of a `csv_reader`.  Incrementing it
+    /// reads the next row, replacing the previous one.
+    class iterator
+        : public input_iterator_base<iterator, row_type, const row_type&> {
+    public:
+
+        /// Constructs a past-the-end iterator.
+        iterator() : _reader() {}
+
+        /// Returns the current row.
+        const row_type& operator*() const { return _reader->_row; }
+
+        /// Reads the next row.
+        iterator& operator++() {
+            if (!_reader->read(_reader->_row))
+                _reader = nullptr;
+            return *this;
+        }
+
+        using input_iterator_base<iterator,
+                                  row_type,
+                                  const row_type&>::operator++;
+
+        /// Compares two iterators for equality.
+        bool operator==(const iterator& other) const {
+            return _reader == other._reader;
+        }
+
+    private:
+        friend class csv_reader;
+
+        explicit iterator(csv_reader* reader) : _reader(reader) { ++*this; }
+
+        csv_reader* _reader;
+    };
+
+    /// Reads from a `FILE`, starting at its current position.
+    ///
+    /// @param file        A file that remains open for the lifetime of the
+    ///                    reader.
+    /// @param delimiter   The field separator, such as `','` or `'\t'`.
+    /// @param chunk_size  The number of bytes to read at a time.
+    explicit csv_reader(std::FILE* file,
+                        char delimiter = ',',
+                        std::size_t chunk_size = 1 << 20)
+        : _read([file](char* buf, std::size_t n) {
+              const std::size_t k = std::fread(buf, 1, n, file);
+              if (k < n && std::ferror(file))
+                  throw std::system_error(errno, std::system_category(),
+                                          "cal::csv_reader: read failed");
+              return k;
+          }),
+          _delimiter(delimiter) {
+        init(chunk_size);
+    }
+
+    /// Reads from text in memory, which must outlive the reader.  The text
+    /// is copied into the buffer one chunk at a time.
+    ///
+    /// @see csv_reader(std::FILE*, char, std::size_t)
+    explicit csv_reader(string_ref text,
+                        char delimiter = ',',
+                        std::size_t chunk_size = 1 << 20)
+        : _read([text](char* buf, std::size_t n) mutable {
+              if (n > text.size())
+                  n = text.size();
+              std::memcpy(buf, text.data(), n);
+              text.remove_prefix(n);
+              return n;
+          }),
+          _delimiter(delimiter) {
+        init(chunk_size);
+    }
+
+    csv_reader(const csv_reader&) = delete;
+
+    csv_reader& operator=(const csv_reader&) = delete;
+
+    /// Reads the next record as a list of strings regardless of the schema,
+    /// typically to consume a header.  Returns an empty list at the end of
+    /// the input.
+    std::vector<std::string> read_header() {
+        std::vector<std::string> names;
+        char* p;
+        char* end;
+        if (!next_record(p, end))
+            return names;
+        for (;;) {
+            char* first;
+            char* last;
+            p = split_field(p, end, first, last, names.size());
+            names.emplace_back(first, last);
+            if (p == end)
+                return names;
+            ++p;
+        }
+    }
+
+    /// Reads the next record into `row`.  Returns `false` at the end of the
+    /// input, in which case `row` is left unmodified.
+    ///
+    /// If an exception is thrown, `row` may be partially modified, but the
+    /// reader remains usable and continues with the next record.
+    bool read(row_type& row) {
+        char* p;
+        char* end;
+        if (!next_record(p, end))
+            return false;
+        row_target target = {row};
+        parse_fields(target, p, end, index<0>());
+        return true;
+    }
+
+    /// Reads up to `max_rows` records, appending each field to the vector of
+    /// its column.  Returns the number of records read, which is less than
+    /// `max_rows` only at the end of the input.
+    ///
+    /// If an exception is thrown, the columns contain exactly the rows
+    /// before the offending record.
+    std::size_t read_columns(columns_type& columns,
+                             std::size_t max_rows = std::size_t(-1)) {
+        static_assert(!_priv::csv_has_string_ref<row_type>::value,
+                      "string_ref fields would not outlive the buffer");
+        std::size_t n = 0;
+        char* p;
+        char* end;
+        while (n != max_rows && next_record(p, end)) {
+            column_target target = {columns, 0};
+            try {
+                parse_fields(target, p, end, index<0>());
+            } catch (...) {
+                truncate(columns, target.appended, index<0>());
+                throw;
+            }
+            ++n;
+        }
+        return n;
+    }
+
+    /// Reads the next row and returns an iterator to it, or a past-the-end
+    /// iterator if there is none.  The reader itself is thus a single-pass
+    /// range of rows.
+    iterator begin() { return iterator(this); }
+
+    /// Returns a past-the-end iterator.
+    iterator end() { return iterator(); }
+
+private:
+    template<std::size_t I>
+    using index = std::integral_constant<std::size_t, I>;
+
+    struct row_target {
+        row_type& row;
+
+        template<std::size_t I>
+        typename std::tuple_element<I, row_type>::type& get() {
+            return std::get<I>(row);
+        }
+    };
+
+    // Appends a default-constructed element to each column as it is
+    // reached, for the field to be parsed into.
+    struct column_target {
+        columns_type& columns;
+        std::size_t appended;
+
+        template<std::size_t I>
+        typename std::tuple_element<I, row_type>::type& get() {
+            auto& column = std::get<I>(columns);
+            column.emplace_back();
+            ++appended;
+            return column.back();
+        }
+    };
+
+    void init(std::size_t chunk_size) {
+        _buf.resize(chunk_size ? chunk_size : 1);
+        _pos = 0;
+        _end = 0;
+        _eof = false;
+        _rows = 0;
+    }
+
+    // Moves the unconsumed input to the front of the buffer (growing it if
+    // the input fills it entirely) and reads more after it.  Returns
+    // `false` at the end of the input.
+    bool refill() {
+        if (_eof)
+            return false;
+        const std::size_t pending = _end - _pos;
+        if (_pos)
+            std::memmove(_buf.data(), _buf.data() + _pos, pending);
+        if (pending == _buf.size())
+            _buf.resize(_buf.size() * 2);
+        const std::size_t n = _read(_buf.data() + pending,
+                                    _buf.size() - pending);
+        _eof = n == 0;
+        _pos = 0;
+        _end = pending + n;
+        return !_eof;
+    }
+
+    // Finds the next non-blank record, excluding its line break.
+    bool next_record(char*& first, char*& last) {
+        for (;;) {
+            char* p = _buf.data() + _pos;
+            char* const e = _buf.data() + _end;
+            char* q = const_cast<char*>(_priv::csv_record_end(p, e));
+            if (q != e) {
+                _pos = static_cast<std::size_t>(q + 1 - _buf.data());
+            } else if (refill()) {
+                continue;
+            } else {
+                // refill may have moved the pending input to the front of a
+                // reallocated buffer, so `p` and `e` are stale
+                p = _buf.data() + _pos;
+                q = _buf.data() + _end;
+                if (p == q)
+                    return false;
+                _pos = _end;        // the last record has no line break
+            }
+            if (q != p && q[-1] == '\r')
+                --q;
+            if (q != p) {
+                ++_rows;
+                first = p;
+                last = q;
+                return true;
+            }
+        }
+    }
+
+    // Finds the field at `p`, unescaping it in place if it is quoted, and
+    // returns the position of the delimiter that follows it (or `end`).
+    char* split_field(char* p,
+                      char* end,
+                      char*& first,
+                      char*& last,
+                      std::size_t column) const {
+        if (p == end || *p != '"') {
+            first = p;
+            void* const d = std::memchr(p, _delimiter,
+                                        static_cast<std::size_t>(end - p));
+            last = d ? static_cast<char*>(d) : end;
+            return last;
+        }
+        char* r = ++p;
+        char* w = p;
+        for (;;) {
+            void* const q = std::memchr(r, '"',
+                                        static_cast<std::size_t>(end - r));
+            if (!q)
+                error("unterminated quoted field", column);
+            const std::size_t n = static_cast<std::size_t>(
+                static_cast<char*>(q) - r);
+            if (w != r)
+                std::memmove(w, r, n);
+            w += n;
+            r = static_cast<char*>(q) + 1;
+            if (r == end || *r != '"')
+                break;
+            *w++ = '"';
+            ++r;
+        }
+        if (r != end && *r != _delimiter)
+            error("unexpected character after quoted field", column);
+        first = p;
+        last = w;
+        return r;
+    }
+
+    template<class Target, std::size_t I>
+    void parse_fields(Target& target, char* p, char* end, index<I>) const {
+        if (I) {
+            if (p == end)
+                error("too few fields", I);
+            ++p;
+        }
+        char* first;
+        char* last;
+        p = split_field(p, end, first, last, I);
+        if (!_priv::csv_parse_field(first, last,
+                                    target.template get<I>()))
+            error("invalid value", I);
+        parse_fields(target, p, end, index<I + 1>());
+    }
+
+    template<class Target>
+    void parse_fields(Target&, char* p, char* end, index<column_count>) const {
+        if (p != end)
+            error("too many fields", column_count);
+    }
+
+    // Removes the elements appended to the first `n` columns.
+    template<std::size_t I>
+    static void truncate(columns_type& columns, std::size_t n, index<I>) {
+        if (I < n)
+            std::get<I>(columns).pop_back();
+        truncate(columns, n, index<I + 1>());
+    }
+
+    static void truncate(columns_type&, std::size_t, index<column_count>) {}
+
+    [[noreturn]] void error(const char* what, std::size_t column) const {
+        throw csv_error(concat("cal::csv_reader: row ", _rows,
+                               ", column ", column + 1, ": ", what),
+                        _rows, column + 1);
+    }
+
+    std::function<std::size_t(char*, std::size_t)> _read;
+    const char _delimiter;
+    std::vector<char> _buf;
+    std::size_t _pos;       // start of the unconsumed input
+    std::size_t _end;       // end of the input in the buffer
+    bool _eof;
+    std::size_t _rows;
+    row_type _row;
+};
+
+}
+#endif
@@ -0,0 +1,1103 @@
+#ifndef NKEVJZTAHQMOWXRBLDYC
+#define NKEVJZTAHQMOWXRBLDYC
+/// @file
+///
+/// Type-safe string formatting.
+///
+/// The format string syntax is a subset of that of Python's `str.format`.
+/// Text outside of braces is copied verbatim, except that `{{` and `}}` are
+/// replaced by `{` and `}`.  Each replacement field formats the next
+/// argument:
+///
+///     field  ::= "{" [":" spec] "}"
+///     spec   ::= [[fill] align] [sign] ["#"] ["0"] [width] ["." precision]
+///                [type]
+///     align  ::= "<" | ">" | "^"
+///     sign   ::= "+" | "-" | " "
+///     type   ::= "b" | "c" | "d" | "o" | "x" | "X"   (integers, characters)
+///              | "e" | "E" | "f" | "F" | "g" | "G"   (floating-point)
+///              | "s"                                 (strings, `bool`)
+///
+/// Signs, `#` (base prefix) and `0` (zero padding) apply only to numbers.
+/// Precision is the number of digits for floating-point numbers and the
+/// maximum length for strings.  Without a type or precision, floating-point
+/// numbers are written as by `to_chars`, with the fewest significant digits
+/// that round-trip.  Tuples are written as `(a, b, c)` and any other type is
+/// written using `to_string`.
+///
+/// Since the arguments are passed with their types intact, a mismatched
+/// specification is reported as a `format_error` rather than resulting in
+/// undefined behavior.  With the `CALICO_FORMAT` and `CALICO_FORMAT_TO`
+/// macros, the format string is additionally checked and parsed at compile
+/// time.
+///
+/// To build strings without temporaries, `format_append` appends to an
+/// existing string and `format_to` writes to any output iterator.
+/// `formatted_size` computes the exact length in advance so that a buffer can
+/// be reserved once.
+///
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "charconv.hpp"
+#include "iterator.hpp"
+#include "string.hpp"
+namespace cal {
+
+/// Thrown when a format string is malformed or does not match the
+/// arguments.
+class format_error : public std::runtime_error {
+public:
+    /// Constructs the exception with an explanatory message.
+    explicit format_error(const std::string& what)
+        : std::runtime_error(what) {}
+};
+
+namespace _priv {
+
+// Categories of arguments, which determine the allowed specifications.
+enum {
+    format_kind_none = -1, // no argument left
+    format_kind_int,
+    format_kind_char,
+    format_kind_bool,
+    format_kind_float,
+    format_kind_string,
+    format_kind_tuple,
+    format_kind_other
+};
+
+template<class T>
+struct format_kind_of : std::integral_constant<int,
+    std::is_same<T, bool>::value ? format_kind_bool
+  : std::is_same<T, char>::value ? format_kind_char
+  : std::is_integral<T>::value   ? format_kind_int
+  : std::is_floating_point<T>::value ? format_kind_float
+  : format_kind_other> {};
+template<>
+struct format_kind_of<const char*>
+    : std::integral_constant<int, format_kind_string> {};
+template<>
+struct format_kind_of<char*>
+    : std::integral_constant<int, format_kind_string> {};
+template<class Traits, class Allocator>
+struct format_kind_of<std::basic_string<char, Traits, Allocator> >
+    : std::integral_constant<int, format_kind_string> {};
+template<class Traits>
+struct format_kind_of<basic_string_ref<char, Traits> >
+    : std::integral_constant<int, format_kind_string> {};
+template<class... Ts>
+struct format_kind_of<std::tuple<Ts...> >
+    : std::integral_constant<int, format_kind_tuple> {};
+
+template<class T>
+struct format_kind_of_arg
+    : format_kind_of<typename std::decay<T>::type> {};
+
+// The specification grammar, written as `constexpr` functions so that
+// format strings can be validated at compile time.  Each `format_check_*`
+// function returns a pointer just past the closing brace, or null if the
+// field is invalid for the given kind of argument.  At run time, the same
+// rules are applied by `format_parse_field` while it parses the field.
+
+constexpr bool format_is_digit(char c) { return c >= '0' && c <= '9'; }
+
+constexpr bool format_is_align(char c) {
+    return c == '<' || c == '>' || c == '^';
+}
+
+constexpr bool format_is_sign(char c) {
+    return c == '+' || c == '-' || c == ' ';
+}
+
+constexpr bool format_is_numeric(int kind) {
+    return kind == format_kind_int || kind == format_kind_float;
+}
+
+constexpr bool format_is_integer(int kind) {
+    return kind == format_kind_int || kind == format_kind_char;
+}
+
+constexpr bool format_allows_precision(int kind) {
+    return kind == format_kind_float || kind == format_kind_string;
+}
+
+constexpr bool format_allows_type(int kind, char t) {
+    return format_is_integer(kind)
+               ? t == 'b' || t == 'c' || t == 'd'
+              || t == 'o' || t == 'x' || t == 'X'
+         : kind == format_kind_float
+               ? t == 'e' || t == 'E' || t == 'f'
+              || t == 'F' || t == 'g' || t == 'G'
+         : kind == format_kind_string || kind == format_kind_bool
+               ? t == 's'
+         : false;
+}
+
+constexpr const char* format_skip_digits(const char* s) {
+    return format_is_digit(*s) ? format_skip_digits(s + 1) : s;
+}
+
+constexpr const char* format_skip_align(const char* s) {
+    return *s && *s != '}' && format_is_align(s[1]) ? s + 2
+         : format_is_align(*s)                      ? s + 1
+         :                                            s;
+}
+
+constexpr const char* format_check_type(const char* s, int kind) {
+    return *s == '}'                                     ? s + 1
+         : format_allows_type(kind, *s) && s[1] == '}' ? s + 2
+         :                                               nullptr;
+}
+
+constexpr const char* format_check_precision(const char* s, int kind) {
+    return *s != '.'
+               ? format_check_type(s, kind)
+         : format_is_digit(s[1]) && format_allows_precision(kind)
+               ? format_check_type(format_skip_digits(s + 1), kind)
+         : nullptr;
+}
+
+constexpr const char* format_check_width(const char* s, int kind) {
+    return *s == '0' && !format_is_numeric(kind)
+               ? nullptr
+               : format_check_precision(format_skip_digits(s), kind);
+}
+
+constexpr const char* format_check_alt(const char* s, int kind) {
+    return *s != '#'                ? format_check_width(s, kind)
+         : format_is_integer(kind) ? format_check_width(s + 1, kind)
+         :                           nullptr;
+}
+
+constexpr const char* format_check_sign(const char* s, int kind) {
+    return !format_is_sign(*s)      ? format_check_alt(s, kind)
+         : format_is_numeric(kind) ? format_check_alt(s + 1, kind)
+         :                           nullptr;
+}
+
+// `s` points just past the opening brace.
+constexpr const char* format_check_field(const char* s, int kind) {
+    return kind == format_kind_none ? nullptr
+         : *s == '}'                ? s + 1
+         : *s == ':'                ? format_check_sign(
+                                          format_skip_align(s + 1), kind)
+         :                            nullptr;
+}
+
+constexpr bool format_is_plain(char c) {
+    return c && c != '{' && c != '}';
+}
+
+constexpr bool format_is_plain8(const char* s) {
+    return format_is_plain(s[0]) && format_is_plain(s[1])
+        && format_is_plain(s[2]) && format_is_plain(s[3])
+        && format_is_plain(s[4]) && format_is_plain(s[5])
+        && format_is_plain(s[6]) && format_is_plain(s[7]);
+}
+
+// A compile-time list of argument kinds.
+template<int... Kinds>
+struct format_kinds {};
+
+template<class... Ts>
+format_kinds<format_kind_of_arg<Ts>::value...>
+format_arg_kinds(const char*, const Ts&...); // only used in `decltype`
+
+template<int... Kinds>
+constexpr std::size_t format_kind_count(format_kinds<Kinds...>) {
+    return sizeof...(Kinds);
+}
+
+constexpr int format_kind_at(format_kinds<>, std::size_t) {
+    return format_kind_none;
+}
+
+template<int Kind, int... Kinds>
+constexpr int format_kind_at(format_kinds<Kind, Kinds...>, std::size_t i) {
+    return i == 0 ? Kind : format_kind_at(format_kinds<Kinds...>(), i - 1);
+}
+
+template<class Kinds>
+constexpr bool format_check_text(const char* s, Kinds kinds, std::size_t i);
+
+template<class Kinds>
+constexpr bool format_check_next(const char* s, Kinds kinds, std::size_t i) {
+    return s && format_check_text(s, kinds, i);
+}
+
+// Literal text is skipped eight characters at a time to keep the recursion
+// depth well within the limits of the compiler.
+template<class Kinds>
+constexpr bool format_check_text(const char* s, Kinds kinds, std::size_t i) {
+    return format_is_plain8(s)
+               ? format_check_text(s + 8, kinds, i)
+         : !*s
+               ? i == format_kind_count(kinds)
+         : *s == '{' && s[1] == '{'
+               ? format_check_text(s + 2, kinds, i)
+         : *s == '{'
+               ? format_check_next(
+                     format_check_field(s + 1, format_kind_at(kinds, i)),
+                     kinds, i + 1)
+         : *s == '}'
+               ? s[1] == '}' && format_check_text(s + 2, kinds, i)
+         : format_check_text(s + 1, kinds, i);
+}
+
+// Returns whether the format string is valid for the given argument kinds.
+template<class Kinds>
+constexpr bool format_check(const char* format, Kinds kinds) {
+    return format_check_text(format, kinds, 0);
+}
+
+template<bool Valid>
+inline void format_static_check() {
+    static_assert(Valid, "format string does not match the arguments");
+}
+
+// A parsed replacement field.
+struct format_spec {
+    char fill;
+    char align;
+    char sign;
+    char type;
+    bool alt;
+    bool zero;
+    int width;
+    int precision;
+};
+
+inline format_spec format_default_spec() {
+    format_spec spec = {' ', 0, '-', 0, false, false, 0, -1};
+    return spec;
+}
+
+inline int format_parse_int(const char*& s) {
+    int n = 0;
+    for (; format_is_digit(*s); ++s)
+        if (n < 100000)
+            n = n * 10 + (*s - '0');
+    return n;
+}
+
+inline const char* format_invalid_spec() {
+    throw format_error("cal::format: invalid format specification");
+}
+
+// Parses the field starting just past the opening brace and returns a
+// pointer just past its closing brace.  The field is validated along the
+// way by the same rules as `format_check_field`, so it is scanned only once.
+inline const char* format_parse_field(const char* s,
+                                      int kind,
+                                      format_spec& spec) {
+    if (kind == format_kind_none)
+        throw format_error("cal::format: too few arguments");
+    spec = format_default_spec();
+    if (*s == '}')
+        return s + 1;
+    if (*s++ != ':')
+        return format_invalid_spec();
+    if (*s && *s != '}' && format_is_align(s[1])) {
+        spec.fill = *s++;
+        spec.align = *s++;
+    } else if (format_is_align(*s)) {
+        spec.align = *s++;
+    }
+    if (format_is_sign(*s)) {
+        if (!format_is_numeric(kind))
+            return format_invalid_spec();
+        spec.sign = *s++;
+    }
+    if (*s == '#') {
+        if (!format_is_integer(kind))
+            return format_invalid_spec();
+        spec.alt = true;
+        ++s;
+    }
+    if (*s == '0') {
+        if (!format_is_numeric(kind))
+            return format_invalid_spec();
+        spec.zero = true;
+        ++s;
+    }
+    spec.width = format_parse_int(s);
+    if (*s == '.') {
+        if (!format_is_digit(s[1]) || !format_allows_precision(kind))
+            return format_invalid_spec();
+        spec.precision = format_parse_int(++s);
+    }
+    if (*s != '}') {
+        if (!format_allows_type(kind, *s) || s[1] != '}')
+            return format_invalid_spec();
+        spec.type = *s++;
+    }
+    return s + 1;
+}
+
+// All output goes through these two functions so that appending to a string
+// or counting can be done in bulk.
+
+template<class OutputIterator>
+inline OutputIterator format_write(OutputIterator out,
+                                   const char* first,
+                                   const char* last) {
+    return std::copy(first, last, out);
+}
+
+template<class OutputIterator>
+inline OutputIterator format_fill(OutputIterator out,
+                                  std::size_t n,
+                                  char c) {
+    return std::fill_n(out, n, c);
+}
+
+inline string_appender format_write(string_appender out,
+                                    const char* first,
+                                    const char* last) {
+    out.str().append(first, static_cast<std::size_t>(last - first));
+    return out;
+}
+
+inline string_appender format_fill(string_appender out,
+                                   std::size_t n,
+                                   char c) {
+    out.str().append(n, c);
+    return out;
+}
+
+inline counting_output_iterator format_write(counting_output_iterator out,
+                                             const char* first,
+                                             const char* last) {
+    return out.skip(static_cast<std::size_t>(last - first));
+}
+
+inline counting_output_iterator format_fill(counting_output_iterator out,
+                                            std::size_t n,
+                                            char) {
+    return out.skip(n);
+}
+
+// Writes `[s, s + n)` padded to the requested width.  For numbers, the first
+// `prefix` characters (sign and base prefix) precede any zero padding.
+template<class OutputIterator>
+inline OutputIterator format_padded(OutputIterator out,
+                                    const format_spec& spec,
+                                    const char* s,
+                                    std::size_t n,
+                                    char default_align,
+                                    std::size_t prefix = 0) {
+    const std::size_t width = static_cast<std::size_t>(spec.width);
+    if (n >= width)
+        return format_write(out, s, s + n);
+    const std::size_t pad = width - n;
+    if (spec.zero && !spec.align) {
+        out = format_write(out, s, s + prefix);
+        out = format_fill(out, pad, '0');
+        return format_write(out, s + prefix, s + n);
+    }
+    const char align = spec.align ? spec.align : default_align;
+    const std::size_t left = align == '>' ? pad : align == '^' ? pad / 2 : 0;
+    out = format_fill(out, left, spec.fill);
+    out = format_write(out, s, s + n);
+    return format_fill(out, pad - left, spec.fill);
+}
+
+template<class UInt>
+inline char* format_radix(char* last, UInt v, int bits, bool upper) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    const UInt mask = static_cast<UInt>((1u << bits) - 1);
+    do {
+        *--last = digits[v & mask];
+        v = static_cast<UInt>(v >> bits);
+    } while (v);
+    return last;
+}
+
+template<class OutputIterator, class T>
+inline OutputIterator format_integer(OutputIterator out,
+                                     const format_spec& spec,
+                                     T x) {
+    typedef typename to_chars_uint<T>::type uint_type;
+    if (spec.type == 'c') {
+        const char c = static_cast<char>(x);
+        return format_padded(out, spec, &c, 1, '<');
+    }
+    char buf[80];
+    char* const last = buf + sizeof(buf);
+    const bool negative = x < T();
+    uint_type u = static_cast<uint_type>(x);
+    if (negative)
+        u = uint_type() - u;
+    char* first;
+    switch (spec.type) {
+    case 'x':
+    case 'X':
+        first = format_radix(last, u, 4, spec.type == 'X');
+        break;
+    case 'o':
+        first = format_radix(last, u, 3, false);
+        break;
+    case 'b':
+        first = format_radix(last, u, 1, false);
+        break;
+    default:
+        first = write_digits_backward(last, u);
+    }
+    if (spec.alt) {
+        if (spec.type == 'o' && u)
+            *--first = '0';
+        else if (spec.type && spec.type != 'o' && spec.type != 'd') {
+            *--first = spec.type;
+            *--first = '0';
+        }
+    }
+    if (negative)
+        *--first = '-';
+    else if (spec.sign != '-')
+        *--first = spec.sign;
+    const std::size_t prefix = static_cast<std::size_t>(
+        (negative || spec.sign != '-')
+        + (spec.alt && spec.type && spec.type != 'd'
+           ? (spec.type == 'o' ? u != 0 : 2) : 0));
+    return format_padded(out, spec, first,
+                         static_cast<std::size_t>(last - first), '>',
+                         prefix);
+}
+
+// Shortest representation for types supported by `to_chars`.
+inline char* format_shortest(char* first, char* last, float x) {
+    return to_chars(first, last, x).ptr;
+}
+
+inline char* format_shortest(char* first, char* last, double x) {
+    return to_chars(first, last, x).ptr;
+}
+
+inline char* format_shortest(char* first, char* last, long double x) {
+    const int n = std::snprintf(first, static_cast<std::size_t>(last - first),
+                                "%.*Lg",
+                                std::numeric_limits<long double>::digits10,
+                                x);
+    return n < 0 ? first : first + std::min<std::ptrdiff_t>(n, last - first);
+}
+
+template<class T>
+inline int format_printf(char* buf, std::size_t size, const char* f,
+                         int precision, T x) {
+    return std::snprintf(buf, size, f, precision, static_cast<double>(x));
+}
+
+inline int format_printf(char* buf, std::size_t size, const char* f,
+                         int precision, long double x) {
+    return std::snprintf(buf, size, f, precision, x);
+}
+
+template<class OutputIterator, class T>
+inline OutputIterator format_float(OutputIterator out,
+                                   const format_spec& spec,
+                                   T x) {
+    char buf[512];
+    std::size_t n;
+    if (!spec.type && spec.precision < 0) {
+        char* first = buf;
+        if (!std::signbit(x) && spec.sign != '-')
+            *first++ = spec.sign;
+        n = static_cast<std::size_t>(
+            format_shortest(first, buf + sizeof(buf), x) - buf);
+    } else {
+        // Build the `printf` specification ourselves so that the argument
+        // type is guaranteed to match.
+        char f[8];
+        char* p = f;
+        *p++ = '%';
+        if (spec.sign != '-')
+            *p++ = spec.sign;
+        *p++ = '.';
+        *p++ = '*';
+        if (std::is_same<T, long double>::value)
+            *p++ = 'L';
+        *p++ = spec.type ? spec.type : 'g';
+        *p = '\0';
+        const int precision = spec.precision < 0 ? 6 : spec.precision;
+        const int r = format_printf(buf, sizeof(buf), f, precision, x);
+        if (r < 0)
+            throw format_error("cal::format: snprintf failed");
+        n = static_cast<std::size_t>(r);
+        if (n >= sizeof(buf)) {
+            std::vector<char> big(n + 1);
+            format_printf(&big[0], big.size(), f, precision, x);
+            return format_padded(out, spec, &big[0], n, '>',
+                                 format_is_sign(big[0]));
+        }
+    }
+    return format_padded(out, spec, buf, n, '>', format_is_sign(buf[0]));
+}
+
+template<class OutputIterator, class T>
+OutputIterator format_arg(OutputIterator out,
+                          const format_spec& spec,
+                          const T& x);
+
+template<std::size_t I, std::size_t N>
+struct format_tuple_helper {
+    template<class OutputIterator, class Tuple>
+    static OutputIterator apply(OutputIterator out, const Tuple& x) {
+        static const char separator[] = ", ";
+        if (I)
+            out = format_write(out, separator, separator + 2);
+        out = format_arg(out, format_default_spec(), std::get<I>(x));
+        return format_tuple_helper<I + 1, N>::apply(out, x);
+    }
+};
+template<std::size_t N>
+struct format_tuple_helper<N, N> {
+    template<class OutputIterator, class Tuple>
+    static OutputIterator apply(OutputIterator out, const Tuple&) {
+        return out;
+    }
+};
+
+inline const char* format_string_data(const char* s) {
+    return s ? s : "(null)";
+}
+
+template<class Traits, class Allocator>
+inline const char*
+format_string_data(const std::basic_string<char, Traits, Allocator>& s) {
+    return s.data();
+}
+
+template<class Traits>
+inline const char* format_string_data(basic_string_ref<char, Traits> s) {
+    return s.data();
+}
+
+inline std::size_t format_string_size(const char* s) {
+    return std::char_traits<char>::length(format_string_data(s));
+}
+
+template<class Traits, class Allocator>
+inline std::size_t
+format_string_size(const std::basic_string<char, Traits, Allocator>& s) {
+    return s.size();
+}
+
+template<class Traits>
+inline std::size_t format_string_size(basic_string_ref<char, Traits> s) {
+    return s.size();
+}
+
+template<class OutputIterator, class T>
+inline OutputIterator format_kind(std::integral_constant<int,
+                                                         format_kind_int>,
+                                  OutputIterator out,
+                                  const format_spec& spec,
+                                  const T& x) {
+    return format_integer(out, spec, x);
+}
+
+template<class OutputIterator>
+inline OutputIterator format_kind(std::integral_constant<int,
+                                                         format_kind_char>,
+                                  OutputIterator out,
+                                  const format_spec& spec,
+                                  char x) {
+    if (!spec.type || spec.type == 'c')
+        return format_padded(out, spec, &x, 1, '<');
+    return format_integer(out, spec, x);
+}
+
+template<class OutputIterator>
+inline OutputIterator format_kind(std::integral_constant<int,
+                                                         format_kind_bool>,
+                                  OutputIterator out,
+                                  const format_spec& spec,
+                                  bool x) {
+    return x ? format_padded(out, spec, "true", 4, '<')
+             : format_padded(out, spec, "false", 5, '<');
+}
+
+template<class OutputIterator, class T>
+inline OutputIterator format_kind(std::integral_constant<int,
+                                                         format_kind_float>,
+                                  OutputIterator out,
+                                  const format_spec& spec,
+                                  const T& x) {
+    return format_float(out, spec, x);
+}
+
+template<class OutputIterator, class T>
+inline OutputIterator format_kind(std::integral_constant<int,
+                                                         format_kind_string>,
+                                  OutputIterator out,
+                                  const format_spec& spec,
+                                  const T& x) {
+    std::size_t n = format_string_size(x);
+    if (spec.precision >= 0)
+        n = std::min(n, static_cast<std::size_t>(spec.precision));
+    return format_padded(out, spec, format_string_data(x), n, '<');
+}
+
+template<class OutputIterator, class T>
+inline OutputIterator format_kind(std::integral_constant<int,
+                                                         format_kind_tuple>,
+                                  OutputIterator out,
+                                  const format_spec& spec,
+                                  const T& x) {
+    typedef format_tuple_helper<0, std::tuple_size<T>::value> helper;
+    if (!spec.width) {
+        out = format_fill(out, 1, '(');
+        out = helper::apply(out, x);
+        return format_fill(out, 1, ')');
+    }
+    std::string s(1, '(');
+    helper::apply(string_appender(s), x);
+    s += ')';
+    return format_padded(out, spec, s.data(), s.size(), '<');
+}
+
+template<class OutputIterator, class T>
+inline OutputIterator format_kind(std::integral_constant<int,
+                                                         format_kind_other>,
+                                  OutputIterator out,
+                                  const format_spec& spec,
+                                  const T& x) {
+    const std::string s = to_string(x);
+    return format_padded(out, spec, s.data(), s.size(), '<');
+}
+
+template<class OutputIterator, class T>
+OutputIterator format_arg(OutputIterator out,
+                          const format_spec& spec,
+                          const T& x) {
+    return format_kind(format_kind_of_arg<T>(), out, spec, x);
+}
+
+// Copies literal text up to the next replacement field.  Returns a pointer
+// just past its opening brace, or null at the end of the format string.
+template<class OutputIterator>
+inline const char* format_literal(OutputIterator& out, const char* s) {
+    for (;;) {
+        const char* p = s;
+        while (format_is_plain(*p))
+            ++p;
+        out = format_write(out, s, p);
+        if (!*p)
+            return nullptr;
+        if (p[0] == p[1]) {
+            out = format_fill(out, 1, *p);
+            s = p + 2;
+            continue;
+        }
+        if (*p == '}')
+            throw format_error("cal::format: unmatched '}'");
+        return p + 1;
+    }
+}
+
+template<class OutputIterator>
+inline OutputIterator format_args(OutputIterator out, const char* s) {
+    if (format_literal(out, s))
+        throw format_error("cal::format: too few arguments");
+    return out;
+}
+
+template<class OutputIterator, class T, class... Ts>
+inline OutputIterator format_args(OutputIterator out,
+                                  const char* s,
+                                  const T& x,
+                                  const Ts&... xs) {
+    s = format_literal(out, s);
+    if (!s)
+        throw format_error("cal::format: too many arguments");
+    format_spec spec;
+    s = format_parse_field(s, format_kind_of_arg<T>::value, spec);
+    out = format_arg(out, spec, x);
+    return format_args(out, s, xs...);
+}
+
+// Format strings known at compile time (through `CALICO_FORMAT`) are parsed
+// into a table of `format_field`s once, during compilation.  The functions
+// below assume that the format string has already passed `format_check`.
+
+// The literal text before a replacement field (or before the end) and the
+// specification of the field.
+struct format_field {
+    std::size_t first;
+    std::size_t last;
+    bool escaped;
+    format_spec spec;
+};
+
+// Returns a pointer just past the opening brace of the next field.
+constexpr const char* format_next_field(const char* s) {
+    return format_is_plain8(s)           ? format_next_field(s + 8)
+         : *s == s[1] && (*s == '{' || *s == '}')
+                                         ? format_next_field(s + 2)
+         : *s == '{'                     ? s + 1
+         :                                 format_next_field(s + 1);
+}
+
+// Returns a pointer just past the closing brace of a field.
+constexpr const char* format_field_end(const char* s) {
+    return *s == '}' ? s + 1 : format_field_end(s + 1);
+}
+
+// Returns a pointer just past the opening brace of the field `i`.
+constexpr const char* format_field_at(const char* s, std::size_t i) {
+    return i == 0 ? format_next_field(s)
+         : format_field_at(format_field_end(format_next_field(s)), i - 1);
+}
+
+// Returns where the literal text before the field `i` begins.
+constexpr const char* format_text_at(const char* s, std::size_t i) {
+    return i == 0 ? s : format_field_end(format_field_at(s, i - 1));
+}
+
+constexpr bool format_has_brace(const char* first, const char* last) {
+    return last - first >= 8 && format_is_plain8(first)
+               ? format_has_brace(first + 8, last)
+         : first == last
+               ? false
+         : *first == '{' || *first == '}'
+         || format_has_brace(first + 1, last);
+}
+
+constexpr int format_const_int(const char* s, int n) {
+    return format_is_digit(*s)
+        ? format_const_int(s + 1, n < 100000 ? n * 10 + (*s - '0') : n)
+        : n;
+}
+
+// The remaining functions take the part of the specification left to
+// parse.  `s` points just past the ':', or at the closing brace if there is
+// no specification.
+
+constexpr const char* format_spec_sign(const char* s) {
+    return *s == '}' ? s : format_skip_align(s);
+}
+
+constexpr const char* format_spec_alt(const char* s) {
+    return format_spec_sign(s) + format_is_sign(*format_spec_sign(s));
+}
+
+constexpr const char* format_spec_zero(const char* s) {
+    return format_spec_alt(s) + (*format_spec_alt(s) == '#');
+}
+
+constexpr const char* format_spec_width(const char* s) {
+    return format_spec_zero(s) + (*format_spec_zero(s) == '0');
+}
+
+constexpr const char* format_spec_precision(const char* s) {
+    return format_skip_digits(format_spec_width(s));
+}
+
+constexpr const char* format_spec_type(const char* s) {
+    return *format_spec_precision(s) == '.'
+        ? format_skip_digits(format_spec_precision(s) + 1)
+        : format_spec_precision(s);
+}
+
+constexpr format_spec format_const_spec(const char* s) {
+    return format_spec{
+        format_spec_sign(s) - s == 2 ? *s : ' ',
+        format_spec_sign(s) != s ? format_spec_sign(s)[-1] : '\0',
+        format_is_sign(*format_spec_sign(s)) ? *format_spec_sign(s) : '-',
+        *format_spec_type(s) != '}' ? *format_spec_type(s) : '\0',
+        *format_spec_alt(s) == '#',
+        *format_spec_zero(s) == '0',
+        format_const_int(format_spec_width(s), 0),
+        *format_spec_precision(s) == '.'
+            ? format_const_int(format_spec_precision(s) + 1, 0)
+            : -1
+    };
+}
+
+// `s` points just past the opening brace of a field.
+constexpr format_spec format_const_field(const char* s) {
+    return format_const_spec(*s == ':' ? s + 1 : s);
+}
+
+// Describes field `i` of a format string of length `n` with `count` fields,
+// or the text after the last field if `i == count`.
+constexpr format_field format_make_field(const char* s,
+                                         std::size_t n,
+                                         std::size_t count,
+                                         std::size_t i) {
+    return format_field{
+        static_cast<std::size_t>(format_text_at(s, i) - s),
+        i == count ? n
+                   : static_cast<std::size_t>(format_field_at(s, i) - 1 - s),
+        format_has_brace(format_text_at(s, i),
+                         i == count ? s + n : format_field_at(s, i) - 1),
+        i == count ? format_spec{' ', 0, '-', 0, false, false, 0, -1}
+                   : format_const_field(format_field_at(s, i))
+    };
+}
+
+// The fields of the format string `Literal::get()`, which has `Count`
+// replacement fields.
+template<class Literal, std::size_t Count,
+         class = typename make_indices<Count + 1>::type>
+struct format_table;
+
+template<class Literal, std::size_t Count, std::size_t... I>
+struct format_table<Literal, Count, indices<I...> > {
+    static constexpr format_field fields[] = {
+        format_make_field(Literal::get(), Literal::size(), Count, I)...
+    };
+};
+
+template<class Literal, std::size_t Count, std::size_t... I>
+constexpr format_field
+format_table<Literal, Count, indices<I...> >::fields[];
+
+// Writes literal text, replacing `{{` and `}}` if there are any.
+template<class OutputIterator>
+inline OutputIterator format_text(OutputIterator out,
+                                  const char* s,
+                                  const format_field& f) {
+    if (!f.escaped)
+        return format_write(out, s + f.first, s + f.last);
+    const char* const last = s + f.last;
+    for (s += f.first;; s += 2) {
+        const char* p = s;
+        while (p != last && *p != '{' && *p != '}')
+            ++p;
+        if (p == last)
+            return format_write(out, s, last);
+        out = format_write(out, s, p + 1);
+        s = p;
+    }
+}
+
+template<class OutputIterator>
+inline OutputIterator format_fields(OutputIterator out,
+                                    const char* s,
+                                    const format_field* f) {
+    return format_text(out, s, *f);
+}
+
+template<class OutputIterator, class T, class... Ts>
+inline OutputIterator format_fields(OutputIterator out,
+                                    const char* s,
+                                    const format_field* f,
+                                    const T& x,
+                                    const Ts&... xs) {
+    out = format_text(out, s, *f);
+    out = format_arg(out, f->spec, x);
+    return format_fields(out, s, f + 1, xs...);
+}
+
+// Formats using the table of a format string that is known at compile time.
+template<class Literal, class OutputIterator, class... Args>
+inline OutputIterator format_const_to(Literal,
+                                      OutputIterator out,
+                                      const char* format,
+                                      const Args&... args) {
+    return format_fields(
+        out, format,
+        format_table<Literal, sizeof...(Args)>::fields, args...);
+}
+
+template<class Literal, class... Args>
+inline std::string format_const(Literal literal,
+                                const char* format,
+                                const Args&... args) {
+    std::string s;
+    format_const_to(literal, string_appender(s), format, args...);
+    return s;
+}
+
+}
+
+/// Formats the arguments according to the `format` string and writes the
+/// result to an output iterator.
+///
+/// @return  The output iterator past the last character written.
+/// @throws  format_error  If the format string is malformed or does not
+///                        match the arguments.
+template<class OutputIterator, class... Args>
+OutputIterator format_to(OutputIterator out,
+                         const char* format,
+                         const Args&... args) {
+    return _priv::format_args(out, format, args...);
+}
+
+/// Formats the arguments according to the `format` string and returns the
+/// result as a string.
+///
+/// @throws  format_error  If the format string is malformed or does not
+///                        match the arguments.
+template<class... Args>
+std::string format(const char* format, const Args&... args) {
+    std::string s;
+    _priv::format_args(string_appender(s), format, args...);
+    return s;
+}
+
+/// Formats the arguments according to the `format` string and appends the
+/// result to `s`.  No temporary strings are created.
+///
+/// @throws  format_error  If the format string is malformed or does not
+///                        match the arguments.
+template<class... Args>
+void format_append(std::string& s, const char* format, const Args&... args) {
+    _priv::format_args(string_appender(s), format, args...);
+}
+
+/// Returns the number of characters that `format` would produce for the
+/// given arguments, without writing them anywhere.  This can be used to
+/// reserve the exact amount of space needed in advance.
+///
+/// @throws  format_error  If the format string is malformed or does not
+///                        match the arguments.
+template<class... Args>
+std::size_t formatted_size(const char* format, const Args&... args) {
+    return _priv::format_args(counting_output_iterator(), format,
+                              args...).count();
+}
+
+namespace _priv {
+
+// A bound on the formatted length of a `T` that is good enough for
+// reserving space, or zero if there is none.
+template<class T, int Kind = format_kind_of<T>::value>
+struct join_size_hint : std::integral_constant<std::size_t,
+    Kind == format_kind_int ? std::numeric_limits<T>::digits10 + 2
+  : Kind == format_kind_char ? 1
+  : Kind == format_kind_bool ? 5
+  : Kind == format_kind_float ? 24
+  : 0> {};
+
+template<class Range>
+inline void join_reserve(std::string&, const Range&, std::size_t,
+                         std::input_iterator_tag) {}
+
+template<class Range>
+inline void join_reserve(std::string& s,
+                         const Range& range,
+                         std::size_t sep_size,
+                         std::random_access_iterator_tag) {
+    typedef typename std::decay<decltype(*adl_begin(range))>::type value_type;
+    const std::size_t n = static_cast<std::size_t>(
+        std::distance(adl_begin(range), adl_end(range)));
+    if (n)
+        s.reserve(s.size() + (n - 1) * sep_size
+                  + n * join_size_hint<value_type>::value);
+}
+
+template<class OutputIterator, class Range>
+inline OutputIterator join_args(OutputIterator out,
+                                const Range& range,
+                                string_ref sep) {
+    const format_spec spec = format_default_spec();
+    bool first = true;
+    for (auto&& x : range) {
+        if (!first)
+            out = format_write(out, sep.begin(), sep.end());
+        first = false;
+        out = format_arg(out, spec, x);
+    }
+    return out;
+}
+
+}
+
+/// Formats every element of a range as `format("{}", x)` would, separated by
+/// `sep`, and writes the result to an output iterator.
+///
+/// @return  The output iterator past the last character written.
+template<class OutputIterator, class Range>
+OutputIterator join_to(OutputIterator out,
+                       const Range& range,
+                       string_ref sep) {
+    return _priv::join_args(out, range, sep);
+}
+
+/// Formats every element of a range as `format("{}", x)` would, separated by
+/// `sep`, and appends the result to the string of a `string_appender`.
+///
+/// If the range is random-access (as are containers such as `std::vector`
+/// and ranges over them such as the result of `transform`), its size is used
+/// to reserve space in advance, so the string is usually grown at most once.
+/// No temporary strings are created for numbers or strings.
+///
+/// @return  The same `string_appender`.
+template<class Range>
+string_appender join_to(string_appender out,
+                        const Range& range,
+                        string_ref sep) {
+    typedef typename iterator_type<const Range&>::type iterator;
+    _priv::join_reserve(out.str(), range, sep.size(),
+                        typename std::iterator_traits<iterator>
+                        ::iterator_category());
+    return _priv::join_args(out, range, sep);
+}
+
+/// Formats every element of a range as `format("{}", x)` would and returns
+/// the results separated by `sep`.
+///
+/// Example: `join(transform(v, f), ", ")`.
+///
+/// @see join_to(string_appender, const Range&, string_ref)
+template<class Range>
+std::string join(const Range& range, string_ref sep) {
+    std::string s;
+    join_to(string_appender(s), range, sep);
+    return s;
+}
+}
+
+#define CALICO_FORMAT_EXPAND_(x) x
+#define CALICO_FORMAT_FIRST_(first, ...) first
+#define CALICO_FORMAT_CHECK_(...)                                           \
+    ::cal::_priv::format_static_check<                                      \
+        ::cal::_priv::format_check(                                         \
+            CALICO_FORMAT_EXPAND_(CALICO_FORMAT_FIRST_(__VA_ARGS__, ~)),    \
+            decltype(::cal::_priv::format_arg_kinds(__VA_ARGS__))())>()
+// A value whose type gives access to the format string in constant
+// expressions, so that it can be parsed into a `format_table`.
+#define CALICO_FORMAT_LITERAL_(...)                                         \
+    [] {                                                                    \
+        struct literal {                                                    \
+            static constexpr const char* get() {                            \
+                return CALICO_FORMAT_EXPAND_(                               \
+                    CALICO_FORMAT_FIRST_(__VA_ARGS__, ~));                  \
+            }                                                               \
+            static constexpr std::size_t size() {                           \
+                return sizeof(CALICO_FORMAT_EXPAND_(                        \
+                    CALICO_FORMAT_FIRST_(__VA_ARGS__, ~))) - 1;             \
+            }                                                               \
+        };                                                                  \
+        return literal();                                                   \
+    }()
+
+/// Same as `cal::format(format, args...)`, but the format string (which must
+/// be a string literal) is checked against the types of the arguments and
+/// parsed at compile time, so that only the arguments are processed at run
+/// time.
+#define CALICO_FORMAT(...)                                                  \
+    (CALICO_FORMAT_CHECK_(__VA_ARGS__),                                     \
+     ::cal::_priv::format_const(CALICO_FORMAT_LITERAL_(__VA_ARGS__),        \
+                                __VA_ARGS__))
+
+/// Same as `cal::format_to(out, format, args...)`, but the format string
+/// (which must be a string literal) is checked against the types of the
+/// arguments and parsed at compile time.
+#define CALICO_FORMAT_TO(out, ...)                                          \
+    (CALICO_FORMAT_CHECK_(__VA_ARGS__),                                     \
+     ::cal::_priv::format_const_to(CALICO_FORMAT_LITERAL_(__VA_ARGS__),     \
+                                   out, __VA_ARGS__))
+
+#endif
@@ -0,0 +1,297 @@
+#ifndef BUPMOPGSWYFURDPPKKOP
+#define BUPMOPGSWYFURDPPKKOP
+/// @file
+///
+/// A string with a fixed capacity that is stored entirely inline.
+///
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "charconv.hpp"
+#include "iterator.hpp"
+#include "string.hpp"
+namespace cal {
+
+namespace _priv {
+
+// The smallest unsigned type that can hold `N`.
+template<std::size_t N>
+struct inline_string_size {
+    typedef typename std::conditional<
+        (N <= 0xff), unsigned char, typename std::conditional<
+            (N <= 0xffff), std::uint16_t, std::size_t>::type>::type type;
+};
+
+}
+
+/// A string of at most `N` characters, stored inline without any heap
+/// allocation.
+///
+/// The characters are kept null-terminated in an array of `N + 1` bytes,
+/// followed by the length in the smallest unsigned type that can hold `N`,
+/// so `inline_string<30>` occupies exactly 32 bytes with an alignment of 1.
+/// The type is trivially copyable: copies are plain `memcpy`s, and arrays of
+/// it are dense and can be relocated freely.
+///
+/// Operations that would exceed the capacity throw `std::length_error` and
+/// leave the string unmodified.
+///
+/// @tparam N  The maximum number of characters, excluding the terminator.
+template<std::size_t N>
+class inline_string
+    : public container_base<inline_string<N>, const char*, char*,
+                            std::size_t> {
+    typedef typename _priv::inline_string_size<N>::type size_type_;
+
+public:
+
+    /// Constructs an empty string.
+    inline_string() : _size() { _data[0] = '\0'; }
+
+    /// Copies a null-terminated string.
+    ///
+    /// @throws std::length_error  If the string is longer than `N`.
+    inline_string(const char* s) : _size() { assign(string_ref(s)); }
+
+    /// Copies a sequence of characters.
+    ///
+    /// @throws std::length_error  If the string is longer than `N`.
+    inline_string(string_ref s) : _size() { assign(s); }
+
+    /// Returns the maximum number of characters, `N`.
+    static constexpr std::size_t capacity() { return N; }
+
+    /// Returns the maximum number of characters, `N`.
+    static constexpr std::size_t max_size() { return N; }
+
+    /// Returns a pointer to the first character.
+    char* data() { return _data; }
+
+    /// Returns a pointer to the first character.
+    const char* data() const { return _data; }
+
+    /// Returns a pointer to the null-terminated characters.
+    const char* c_str() const { return _data; }
+
+    /// Returns the number of characters.
+    std::size_t size() const { return _size; }
+
+    /// Returns the number of characters.
+    std::size_t length() const { return _size; }
+
+    /// Accesses the character at a given index without bounds-checking.
+    char& operator[](std::size_t index) { return _data[index]; }
+
+    /// Accesses the character at a given index without bounds-checking.
+    const char& operator[](std::size_t index) const { return _data[index]; }
+
+    /// Refers to the characters.
+    operator string_ref() const { return string_ref(_data, _size); }
+
+    /// Copies the characters into an `std::string`.
+    std::string str() const { return std::string(_data, _size); }
+
+    /// Removes all characters.
+    void clear() { set_size(0); }
+
+    /// Replaces the contents with a copy of `s`.
+    ///
+    /// @throws std::length_error  If `s` is longer than `N`.
+    inline_string& assign(string_ref s) {
+        check_length(s.size(), "cal::inline_string::assign");
+        std::char_traits<char>::move(_data, s.data(), s.size());
+        set_size(s.size());
+        return *this;
+    }
+
+    /// Appends the characters of `s`.
+    ///
+    /// @throws std::length_error  If the result would be longer than `N`.
+    inline_string& append(string_ref s) {
+        check_length(_size + s.size(), "cal::inline_string::append");
+        std::char_traits<char>::move(_data + _size, s.data(), s.size());
+        set_size(_size + s.size());
+        return *this;
+    }
+
+    /// Appends `n` copies of `c`.
+    ///
+    /// @throws std::length_error  If the result would be longer than `N`.
+    inline_string& append(std::size_t n, char c) {
+        check_length(_size + n, "cal::inline_string::append");
+        std::char_traits<char>::assign(_data + _size, n, c);
+        set_size(_size + n);
+        return *this;
+    }
+
+    /// Appends a character.
+    ///
+    /// @throws std::length_error  If the string is already full.
+    void push_back(char c) {
+        check_length(_size + 1u, "cal::inline_string::push_back");
+        _data[_size] = c;
+        set_size(_size + 1u);
+    }
+
+    /// Removes the last character, which must exist.
+    void pop_back() { set_size(_size - 1u); }
+
+    /// Changes the number of characters, appending copies of `c` if the
+    /// string grows.
+    ///
+    /// @throws std::length_error  If `n` exceeds `N`.
+    void resize(std::size_t n, char c = '\0') {
+        check_length(n, "cal::inline_string::resize");
+        if (n > _size)
+            std::char_traits<char>::assign(_data + _size, n - _size, c);
+        set_size(n);
+    }
+
+    /// Appends the characters of `s`.
+    inline_string& operator+=(string_ref s) { return append(s); }
+
+    /// Appends a character.
+    inline_string& operator+=(char c) {
+        push_back(c);
+        return *this;
+    }
+
+    /// Compares two strings for equality.
+    friend bool operator==(const inline_string& a, const inline_string& b) {
+        return string_ref(a) == string_ref(b);
+    }
+
+    /// Compares a string with a reference for equality.
+    friend bool operator==(const inline_string& a, string_ref b) {
+        return string_ref(a) == b;
+    }
+
+    /// Compares a reference with a string for equality.
+    friend bool operator==(string_ref a, const inline_string& b) {
+        return a == string_ref(b);
+    }
+
+    /// Compares a string with a null-terminated string for equality.
+    friend bool operator==(const inline_string& a, const char* b) {
+        return string_ref(a) == string_ref(b);
+    }
+
+    /// Compares a null-terminated string with a string for equality.
+    friend bool operator==(const char* a, const inline_string& b) {
+        return string_ref(a) == string_ref(b);
+    }
+
+    /// Compares two strings for inequality.
+    friend bool operator!=(const inline_string& a, const inline_string& b) {
+        return !(a == b);
+    }
+
+    /// Compares a string with a reference for inequality.
+    friend bool operator!=(const inline_string& a, string_ref b) {
+        return !(a == b);
+    }
+
+    /// Compares a reference with a string for inequality.
+    friend bool operator!=(string_ref a, const inline_string& b) {
+        return !(a == b);
+    }
+
+    /// Compares a string with a null-terminated string for inequality.
+    friend bool operator!=(const inline_string& a, const char* b) {
+        return !(a == b);
+    }
+
+    /// Compares a null-terminated string with a string for inequality.
+    friend bool operator!=(const char* a, const inline_string& b) {
+        return !(a == b);
+    }
+
+    /// Compares two strings lexicographically.
+    friend bool operator<(const inline_string& a, const inline_string& b) {
+        return string_ref(a) < string_ref(b);
+    }
+
+    /// Writes the characters to a stream.
+    friend std::ostream& operator<<(std::ostream& stream,
+                                    const inline_string& s) {
+        return stream << string_ref(s);
+    }
+
+private:
+    static void check_length(std::size_t n, const char* what) {
+        if (n > N)
+            throw std::length_error(what);
+    }
+
+    void set_size(std::size_t n) {
+        _size = static_cast<size_type_>(n);
+        _data[n] = '\0';
+    }
+
+    char _data[N + 1];
+    size_type_ _size;
+};
+
+/// Copies the characters into an `std::string`.
+template<std::size_t N>
+inline std::string to_string(const inline_string<N>& s) { return s.str(); }
+
+/// Writes the decimal representation of a number into an `inline_string`.
+///
+/// @throws std::length_error  If the representation is longer than `N`.
+///
+/// @see to_chars
+template<std::size_t N, class T> inline
+typename std::enable_if<std::is_arithmetic<T>::value
+                        && !std::is_same<T, bool>::value,
+                        inline_string<N> >::type
+to_inline_string(T value) {
+    char buf[N ? N : 1];
+    const to_chars_result r = to_chars(buf, buf + N, value);
+    if (r.ec != std::errc())
+        throw std::length_error("cal::to_inline_string");
+    return inline_string<N>(
+        string_ref(buf, static_cast<std::size_t>(r.ptr - buf)));
+}
+
+/// Formats a string similar to `sprintf` into `s`, replacing its contents.
+///
+/// The output is formatted in a single pass into a stack buffer of the same
+/// capacity and then copied into `s`.
+///
+/// @throws std::length_error  If the output is longer than `N`, in which
+///                            case `s` is left unmodified.
+///
+/// @see format_str_to(std::string&, const char*, T&&...)
+template<std::size_t N, class ...T>
+void format_str_to(inline_string<N>& s, const char* format, T&&... t) {
+    using namespace std;
+    char buf[N + 1];
+    const int n = snprintf(buf, sizeof(buf), format, t...);
+    if (n < 0)
+        throw runtime_error("cal::format_str: snprintf failed");
+    if (static_cast<size_t>(n) > N)
+        throw length_error("cal::format_str: output too long");
+    s.assign(string_ref(buf, static_cast<size_t>(n)));
+}
+
+}
+
+namespace std {
+
+/// Hashes the characters of an `inline_string`.
+template<std::size_t N>
+struct hash<cal::inline_string<N> > {
+    /// Returns the hash of the characters.
+    std::size_t operator()(const cal::inline_string<N>& s) const {
+        return cal::_priv::hash_bytes(s.data(), s.size());
+    }
+};
+
+}
+#endif
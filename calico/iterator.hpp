@@ -4,10 +4,14 @@
 ///
 /// Some utility related to iterators.
 ///
+#include <cstddef>
 #include <iterator>
 #include <memory>
+#include <new>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include "utility.hpp"
 namespace cal {
 namespace _priv {
@@ -33,7 +37,7 @@ auto adl_end(const Container& c)
 template<class Container> inline
 auto adl_rbegin(const Container& c)
 -> decltype(c.rbegin())
-{   return  c.rend(); }
+{   return  c.rbegin(); }
 
 template<class Container> inline
 auto adl_rend(const Container& c)
@@ -51,12 +55,12 @@ template<class T>             struct iterator_type<T,
 // A proxy object that behaves like a pointer.
 template<class Ref>
 struct proxy_pointer {
-    explicit proxy_pointer(Ref& r) : _r(r) {}
+    explicit proxy_pointer(const Ref& r) : _r(r) {}
     Ref* operator->() const { return std::addressof(_r); }
     Ref operator*() const { return _r; }
     operator Ref*() const { return std::addressof(_r); }
 private:
-    Ref _r;
+    mutable Ref _r;
 };
 
 // Constructs from a given reference or proxy-reference type to `T` a pointer
@@ -64,12 +68,12 @@ private:
 template<class T, class Ref>
 struct reference_to_pointer {
     typedef proxy_pointer<Ref> type;
-    type get(Ref& r) { return type(r); }
+    static type get(const Ref& r) { return type(r); }
 };
 template<class T>
 struct reference_to_pointer<T, T&> {
     typedef T* type;
-    type get(T& r) { return &r; }
+    static type get(T& r) { return std::addressof(r); }
 };
 
 }
@@ -140,22 +144,24 @@ public:
 
     /// Compares two iterators for inequality.
     bool operator!=(const Derived& i) const {
-        return !(*static_cast<Derived*>(this) == i);
+        return !(static_cast<const Derived&>(*this) == i);
     }
 
     /// Returns the pointed-to object.
-    reference operator*() const { return *static_cast<Derived*>(this); }
+    reference operator*() const {
+        return const_cast<Derived&>(static_cast<const Derived&>(*this));
+    }
 
     /// Member access of the object pointed to by the iterator.
     pointer operator->() const {
-        return _pointer::get(**static_cast<Derived*>(this));
+        return _pointer::get(*static_cast<const Derived&>(*this));
     }
 
-    /// Increments the iterator and returns the previously pointed-to value.
-    Derived& operator++(int) {
-        value_type x = **static_cast<Derived*>(this);
-        ++*static_cast<Derived*>(this);
-        return x;
+    /// Increments and returns the iterator prior to the increment.
+    Derived operator++(int) {
+        Derived i = static_cast<Derived&>(*this);
+        ++static_cast<Derived&>(*this);
+        return i;
     }
 
 protected:
@@ -477,6 +483,59 @@ counted_iterator<Iterator> iterator_counter(
         typename counted_iterator<Iterator>::difference_type()
 ) { return counted_iterator<Iterator>(iterator, init_count); }
 
+/// An `OutputIterator` that discards everything written to it and only
+/// counts the number of elements.  Useful for computing the exact size of an
+/// output before writing it for real.
+struct counting_output_iterator {
+
+    /// Iterator category.
+    typedef std::output_iterator_tag iterator_category;
+
+    /// Value type.
+    typedef void value_type;
+
+    /// Difference type.
+    typedef std::ptrdiff_t difference_type;
+
+    /// Pointer type.
+    typedef void pointer;
+
+    /// Reference type.
+    typedef void reference;
+
+    /// Constructs an iterator with an initial count.
+    explicit counting_output_iterator(std::size_t init_count = 0)
+        : _count(init_count) {}
+
+    /// Returns the number of elements written so far.
+    std::size_t count() const { return _count; }
+
+    /// Adds `n` to the count as if `n` elements were written.
+    counting_output_iterator& skip(std::size_t n) {
+        _count += n;
+        return *this;
+    }
+
+    /// Counts an element and discards it.
+    template<class T>
+    counting_output_iterator& operator=(const T&) {
+        ++_count;
+        return *this;
+    }
+
+    /// Returns the iterator itself.
+    counting_output_iterator& operator*() { return *this; }
+
+    /// Does nothing.
+    counting_output_iterator& operator++() { return *this; }
+
+    /// Does nothing.
+    counting_output_iterator& operator++(int) { return *this; }
+
+private:
+    std::size_t _count;
+};
+
 /// An `RandomAccessIterator` that stores an integer value of type `T`.  The
 /// dereferenced value of the iterator is the integer itself.
 ///
@@ -760,7 +819,7 @@ struct container_base {
     /// Depends on `begin() const`.  If the container is empty, the result is
     /// undefined.
     const_reference front() const {
-        return static_cast<const Derived&>(*this).begin();
+        return *static_cast<const Derived&>(*this).begin();
     }
 
     /// Returns a `reference` to the first element in the container.
@@ -768,7 +827,7 @@ struct container_base {
     /// Depends on `begin()`.  If the container is empty, the result is
     /// undefined.
     reference front() {
-        return static_cast<Derived&>(*this).begin();
+        return *static_cast<Derived&>(*this).begin();
     }
 
     /// Returns a `const_reference` to the last element in the container.
@@ -776,7 +835,8 @@ struct container_base {
     /// Depends on `end() const` and is only defined if the iterator is
     /// bidirectional.  If the container is empty, the result is undefined.
     const_reference back() const {
-        return *--static_cast<const Derived&>(*this).end();
+        const_iterator last = static_cast<const Derived&>(*this).end();
+        return *--last;
     }
 
     /// Returns a `reference` to the last element in the container.
@@ -784,7 +844,8 @@ struct container_base {
     /// Depends on `end()` and is only defined if the iterator is
     /// bidirectional.  If the container is empty, the result is undefined.
     reference back() {
-        return *--static_cast<Derived&>(*this).end();
+        iterator last = static_cast<Derived&>(*this).end();
+        return *--last;
     }
 
     /// Returns an `iterator` to the beginning of the container.
@@ -881,7 +942,7 @@ struct container_base {
     const_reference at(size_type index) const {
         // First check is not strictly needed, but can be useful in case
         // `size_type` happens to be a signed type.
-        const Derived& dthis = static_cast<const Derived&>(this);
+        const Derived& dthis = static_cast<const Derived&>(*this);
         if (index < size_type() || index >= dthis.size())
             throw std::out_of_range("index out of range");
         return dthis[index];
@@ -940,7 +1001,9 @@ protected:
              + static_cast<Derived&>(*this).size();
     }
 
-    ~container_base() {}; // don't try to initialize a CRTP base type
+    // Protected so that the CRTP base type is never used on its own, but
+    // trivial so that derived types can still be trivially copyable.
+    ~container_base() = default;
 };
 
 /// An container-like type defined by a pair of iterators.
@@ -1224,6 +1287,276 @@ auto transform(const Container& c, const UnaryOperation& op)
 #endif
 {   return  transform(_priv::adl_begin(c), _priv::adl_end(c), op); }
 
+namespace _priv {
+
+// Inline storage for an optional value.  Unlike the value itself, it is
+// always copy-assignable (by reconstruction), which allows it to hold
+// lambdas inside iterators.
+template<class T>
+class optional_storage {
+public:
+    optional_storage() : _full(false) {}
+
+    optional_storage(const optional_storage& other) : _full(false) {
+        if (other._full)
+            emplace(other.get());
+    }
+
+    optional_storage& operator=(const optional_storage& other) {
+        if (this != &other) {
+            reset();
+            if (other._full)
+                emplace(other.get());
+        }
+        return *this;
+    }
+
+    ~optional_storage() { reset(); }
+
+    bool has_value() const { return _full; }
+
+    const T& get() const { return *reinterpret_cast<const T*>(&_storage); }
+
+    template<class U>
+    void emplace(U&& value) {
+        ::new(static_cast<void*>(&_storage)) T(std::forward<U>(value));
+        _full = true;
+    }
+
+    void reset() {
+        if (_full) {
+            reinterpret_cast<T*>(&_storage)->~T();
+            _full = false;
+        }
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+    bool _full;
+};
+
+// The category of `Iterator`, but no stronger than forward.
+template<class Iterator>
+struct at_most_forward {
+    typedef typename std::common_type<
+        std::forward_iterator_tag,
+        typename std::iterator_traits<Iterator>::iterator_category
+    >::type type;
+};
+
+}
+
+/// Tag type that selects the caching overloads of `transform`.
+struct cache_tag {};
+
+/// An iterator that applies a function to each element, like
+/// `transform_iterator`, but evaluates it at most once per position and
+/// keeps the result inside the iterator until the iterator moves.
+///
+/// This pays off when the function is expensive and the result is used more
+/// than once through the same iterator, as in chained `operator->` calls.
+/// Copies of the iterator carry the cached value along, but the value is
+/// not shared between them, so an algorithm that copies iterators before
+/// dereferencing them (as the comparisons inside many standard algorithms
+/// do) still evaluates the function once per copy.
+///
+/// Unlike `transform_iterator`, this iterator is copy-assignable even if the
+/// function object (e.g. a lambda) is not.
+///
+/// The references returned by `operator*` point into the iterator itself, so
+/// they are only valid until the iterator is modified or destroyed.  For
+/// this reason, the iterator is at most a forward iterator regardless of the
+/// underlying one: a reverse iterator on top of it would return references
+/// into a temporary.  A single iterator must also not be dereferenced
+/// concurrently from several threads, although distinct iterators may be.
+template<class InputIterator, class UnaryOperation>
+struct cached_transform_iterator {
+
+    /// Underlying iterator type.
+    typedef InputIterator iterator;
+
+    /// Iterator category.
+    typedef CALICO_HIDE(
+        typename _priv::at_most_forward<iterator>::type
+    ) iterator_category;
+
+    /// Difference type.
+    typedef CALICO_HIDE(
+        typename std::iterator_traits<iterator>::difference_type
+    ) difference_type;
+
+    /// Value type.
+    typedef CALICO_HIDE(
+        typename std::decay<typename std::result_of<
+            UnaryOperation(
+                typename std::iterator_traits<iterator>::reference
+            )
+        >::type>::type
+    ) value_type;
+
+    /// Reference type.
+    typedef const value_type& reference;
+
+    /// Pointer type.
+    typedef const value_type* pointer;
+
+    /// Default initializer.
+    cached_transform_iterator() {}
+
+    /// Constructs an iterator that applies a function to each element.
+    cached_transform_iterator(
+        const iterator& it,
+        const UnaryOperation& op
+    ) : _it(it) { _op.emplace(op); }
+
+    /// Returns the underlying iterator.
+    const iterator& base() const { return _it; }
+
+    /// Returns the function object.
+    const UnaryOperation& function() const { return _op.get(); }
+
+    /// Returns the result of the function, evaluating it if this is the
+    /// first access since the iterator last moved.
+    reference operator*() const {
+        if (!_cache.has_value())
+            _cache.emplace(_op.get()(*_it));
+        return _cache.get();
+    }
+
+    /// Member access of the result of the function.
+    pointer operator->() const { return std::addressof(**this); }
+
+    /// Pre-increments the iterator.
+    cached_transform_iterator& operator++() {
+        ++_it;
+        _cache.reset();
+        return *this;
+    }
+
+    /// Post-increments the iterator.
+    cached_transform_iterator operator++(int) {
+        cached_transform_iterator t = *this;
+        ++*this;
+        return t;
+    }
+
+    /// Compares the underlying iterators.
+    friend bool operator==(const cached_transform_iterator& i,
+                           const cached_transform_iterator& j) {
+        return i._it == j._it;
+    }
+
+    /// Compares the underlying iterators.
+    friend bool operator!=(const cached_transform_iterator& i,
+                           const cached_transform_iterator& j) {
+        return i._it != j._it;
+    }
+
+private:
+    iterator _it;
+    _priv::optional_storage<UnaryOperation> _op;
+    mutable _priv::optional_storage<value_type> _cache;
+};
+
+/// Constructs a `cached_transform_iterator`.
+template<class InputIterator, class UnaryOperation> inline
+cached_transform_iterator<InputIterator, UnaryOperation>
+make_cached_transform_iterator(const InputIterator& it,
+                               const UnaryOperation& op) {
+    return cached_transform_iterator<InputIterator, UnaryOperation>(it, op);
+}
+
+/// The range returned by the caching overloads of `transform`.
+///
+/// Since the iterators own the values they refer to, the element accessors
+/// return copies rather than references, and the accessors that would need
+/// to step backwards are not available.
+template<class InputIterator, class UnaryOperation>
+struct cached_transform_range
+    : container_base<
+          cached_transform_range<InputIterator, UnaryOperation>,
+          cached_transform_iterator<InputIterator, UnaryOperation> > {
+private:
+    typedef container_base<
+        cached_transform_range<InputIterator, UnaryOperation>,
+        cached_transform_iterator<InputIterator, UnaryOperation> > base_type;
+public:
+
+    /// Iterator type.
+    typedef cached_transform_iterator<InputIterator, UnaryOperation>
+        iterator_type;
+
+    /// Size type.
+    typedef typename base_type::size_type size_type;
+
+    /// Value type.
+    typedef typename base_type::value_type value_type;
+
+    /// Constructs a range from a pair of iterators.
+    cached_transform_range(const iterator_type& first,
+                           const iterator_type& last)
+        : first(first), last(last) {}
+
+    iterator_type first;
+    iterator_type last;
+    iterator_type begin() const { return first; }
+    iterator_type end()   const { return last;  }
+
+    /// Returns a copy of the first element.  If the range is empty, the
+    /// result is undefined.
+    value_type front() const { return *begin(); }
+
+    /// Returns a copy of the element at a given index, which takes linear
+    /// time.
+    value_type operator[](size_type index) const {
+        iterator_type it = first;
+        std::advance(it, index);
+        return *it;
+    }
+
+    /// Returns a copy of the element at a given index with bounds-checking.
+    value_type at(size_type index) const {
+        if (index >= this->size())
+            throw std::out_of_range("index out of range");
+        return (*this)[index];
+    }
+
+    // These would have to return references into a temporary iterator.
+    void back() const = delete;
+    void rbegin() const = delete;
+    void rend() const = delete;
+    void crbegin() const = delete;
+    void crend() const = delete;
+};
+
+/// Applies a given function to every element of an iterator range and returns
+/// the result as a lazily evaluated iterable container, evaluating the
+/// function at most once each time an iterator visits an element.
+///
+/// @see cached_transform_iterator
+template<class InputIterator, class UnaryOperation> inline
+cached_transform_range<InputIterator, UnaryOperation>
+transform(const InputIterator& first,
+          const InputIterator& last,
+          const UnaryOperation& op,
+          cache_tag) {
+    return cached_transform_range<InputIterator, UnaryOperation>(
+        make_cached_transform_iterator(first, op),
+        make_cached_transform_iterator(last, op));
+}
+
+/// Applies a given function to every element of an iterable container and
+/// returns the result as a lazily evaluated iterable container, evaluating
+/// the function at most once each time an iterator visits an element.
+///
+/// @see cached_transform_iterator
+template<class Container, class UnaryOperation> inline
+auto transform(const Container& c, const UnaryOperation& op, cache_tag tag)
+#ifndef CALICO_DOC_ONLY
+-> decltype(transform(_priv::adl_begin(c), _priv::adl_end(c), op, tag))
+#endif
+{   return  transform(_priv::adl_begin(c), _priv::adl_end(c), op, tag); }
+
 /// Reverses a container or iterator range.
 ///
 /// Requires `rbegin` and `rend` as member functions.  This may be relaxed in
@@ -1235,5 +1568,728 @@ auto reverse_range(const Container& c)
 #endif
 {   return  make_range(_priv::adl_rbegin(c), _priv::adl_rend(c)); }
 
+namespace _priv {
+
+// Position within a partition of `n` elements into consecutive blocks,
+// where block `p` begins at `p * q + min(p, r)` (clamped to `n`).  The
+// underlying iterator is kept at the start of the current block, with its
+// offset tracked by the `counted_iterator`.
+template<class Iterator>
+struct partition_cursor {
+    typedef typename std::iterator_traits<Iterator>::difference_type
+        difference_type;
+
+    partition_cursor() {}
+
+    partition_cursor(const Iterator& first, difference_type size,
+                     difference_type block, difference_type extra,
+                     difference_type index)
+        : it(first), n(size), q(block), r(extra), p(0) { seek(index); }
+
+    difference_type offset(difference_type index) const {
+        const difference_type o = index * q + (index < r ? index : r);
+        return o < n ? o : n;
+    }
+
+    void seek(difference_type index) {
+        std::advance(it, offset(index) - it.count());
+        p = index;
+    }
+
+    // Returns the end of the current block.
+    Iterator block_end() const {
+        return std::next(it.base(), offset(p + 1) - it.count());
+    }
+
+    counted_iterator<Iterator> it;
+    difference_type n, q, r, p;
+};
+
+}
+
+/// An iterator over consecutive sub-ranges of an underlying range, obtained
+/// from `chunks` or `chunks_of`.
+///
+/// The iterator has the same category as `Iterator`, but dereferences to an
+/// `iterator_range<Iterator>` by value.  All of its operations are O(1) if
+/// `Iterator` is random-access.
+template<class Iterator>
+struct chunk_iterator {
+
+    /// Underlying iterator type.
+    typedef Iterator iterator_type;
+
+    /// Iterator category.
+    typedef typename std::iterator_traits<Iterator>::iterator_category
+        iterator_category;
+
+    /// Difference type.
+    typedef typename std::iterator_traits<Iterator>::difference_type
+        difference_type;
+
+    /// Value type.
+    typedef iterator_range<Iterator> value_type;
+
+    /// Reference type.
+    typedef value_type reference;
+
+private:
+    typedef _priv::reference_to_pointer<value_type, reference> _pointer;
+
+public:
+    /// Pointer type.
+    typedef CALICO_HIDE(typename _pointer::type) pointer;
+
+    /// Default initializer.
+    chunk_iterator() {}
+
+    /// Constructs an iterator pointing to the `index`-th block of a range of
+    /// `size` elements starting at `first`, where block `p` begins at offset
+    /// `p * block + min(p, extra)`.
+    chunk_iterator(const iterator_type& first, difference_type size,
+                   difference_type block, difference_type extra,
+                   difference_type index)
+        : _c(first, size, block, extra, index) {}
+
+    /// Returns the index of the current block.
+    difference_type index() const { return _c.p; }
+
+    /// Returns the current block.
+    reference operator*() const {
+        return value_type(_c.it.base(), _c.block_end());
+    }
+
+    /// Member access of the current block.
+    pointer operator->() const { return _pointer::get(**this); }
+
+    /// Returns the block `n` positions away.
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    /// Pre-increments the iterator.
+    chunk_iterator& operator++() { _c.seek(_c.p + 1); return *this; }
+
+    /// Post-increments the iterator.
+    chunk_iterator operator++(int) {
+        chunk_iterator t = *this;
+        ++*this;
+        return t;
+    }
+
+    /// Pre-decrements the iterator.
+    chunk_iterator& operator--() { _c.seek(_c.p - 1); return *this; }
+
+    /// Post-decrements the iterator.
+    chunk_iterator operator--(int) {
+        chunk_iterator t = *this;
+        --*this;
+        return t;
+    }
+
+    /// Advances the iterator by `n`.
+    chunk_iterator& operator+=(difference_type n) {
+        _c.seek(_c.p + n);
+        return *this;
+    }
+
+    /// Advances the iterator by `n` in reverse.
+    chunk_iterator& operator-=(difference_type n) {
+        _c.seek(_c.p - n);
+        return *this;
+    }
+
+    /// Returns an iterator advanced by `n`.
+    friend chunk_iterator operator+(chunk_iterator i, difference_type n) {
+        return i += n;
+    }
+
+    /// Returns an iterator advanced by `n`.
+    friend chunk_iterator operator+(difference_type n, chunk_iterator i) {
+        return i += n;
+    }
+
+    /// Returns an iterator advanced by `n` in reverse.
+    friend chunk_iterator operator-(chunk_iterator i, difference_type n) {
+        return i -= n;
+    }
+
+    /// Returns the distance between two iterators.
+    friend difference_type
+    operator-(const chunk_iterator& i, const chunk_iterator& j) {
+        return i._c.p - j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator==(const chunk_iterator& i, const chunk_iterator& j) {
+        return i._c.p == j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator!=(const chunk_iterator& i, const chunk_iterator& j) {
+        return i._c.p != j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator<(const chunk_iterator& i, const chunk_iterator& j) {
+        return i._c.p < j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator>(const chunk_iterator& i, const chunk_iterator& j) {
+        return i._c.p > j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator<=(const chunk_iterator& i, const chunk_iterator& j) {
+        return i._c.p <= j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator>=(const chunk_iterator& i, const chunk_iterator& j) {
+        return i._c.p >= j._c.p;
+    }
+
+private:
+    _priv::partition_cursor<Iterator> _c;
+};
+
+/// An iterator that visits every `s`-th element of an underlying range,
+/// obtained from `stride`.
+///
+/// The iterator has the same category as `Iterator` and never moves the
+/// underlying iterator past the end of the range.  All of its operations are
+/// O(1) if `Iterator` is random-access.
+template<class Iterator>
+struct stride_iterator {
+
+    /// Underlying iterator type.
+    typedef Iterator iterator_type;
+
+    /// Iterator category.
+    typedef typename std::iterator_traits<Iterator>::iterator_category
+        iterator_category;
+
+    /// Difference type.
+    typedef typename std::iterator_traits<Iterator>::difference_type
+        difference_type;
+
+    /// Value type.
+    typedef typename std::iterator_traits<Iterator>::value_type value_type;
+
+    /// Reference type.
+    typedef typename std::iterator_traits<Iterator>::reference reference;
+
+    /// Pointer type.
+    typedef typename std::iterator_traits<Iterator>::pointer pointer;
+
+    /// Default initializer.
+    stride_iterator() {}
+
+    /// Constructs an iterator pointing to the element at offset
+    /// `index * step` of a range of `size` elements starting at `first`.
+    stride_iterator(const iterator_type& first, difference_type size,
+                    difference_type step, difference_type index)
+        : _c(first, size, step, 0, index) {}
+
+    /// Returns the underlying iterator.
+    const iterator_type& base() const { return _c.it.base(); }
+
+    /// Returns the pointed-to object.
+    reference operator*() const { return *_c.it; }
+
+    /// Member access of the object pointed to by the iterator.
+    pointer operator->() const { return _c.it.operator->(); }
+
+    /// Returns the element `n` positions away.
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    /// Pre-increments the iterator.
+    stride_iterator& operator++() { _c.seek(_c.p + 1); return *this; }
+
+    /// Post-increments the iterator.
+    stride_iterator operator++(int) {
+        stride_iterator t = *this;
+        ++*this;
+        return t;
+    }
+
+    /// Pre-decrements the iterator.
+    stride_iterator& operator--() { _c.seek(_c.p - 1); return *this; }
+
+    /// Post-decrements the iterator.
+    stride_iterator operator--(int) {
+        stride_iterator t = *this;
+        --*this;
+        return t;
+    }
+
+    /// Advances the iterator by `n`.
+    stride_iterator& operator+=(difference_type n) {
+        _c.seek(_c.p + n);
+        return *this;
+    }
+
+    /// Advances the iterator by `n` in reverse.
+    stride_iterator& operator-=(difference_type n) {
+        _c.seek(_c.p - n);
+        return *this;
+    }
+
+    /// Returns an iterator advanced by `n`.
+    friend stride_iterator operator+(stride_iterator i, difference_type n) {
+        return i += n;
+    }
+
+    /// Returns an iterator advanced by `n`.
+    friend stride_iterator operator+(difference_type n, stride_iterator i) {
+        return i += n;
+    }
+
+    /// Returns an iterator advanced by `n` in reverse.
+    friend stride_iterator operator-(stride_iterator i, difference_type n) {
+        return i -= n;
+    }
+
+    /// Returns the distance between two iterators.
+    friend difference_type
+    operator-(const stride_iterator& i, const stride_iterator& j) {
+        return i._c.p - j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool
+    operator==(const stride_iterator& i, const stride_iterator& j) {
+        return i._c.p == j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool
+    operator!=(const stride_iterator& i, const stride_iterator& j) {
+        return i._c.p != j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator<(const stride_iterator& i, const stride_iterator& j) {
+        return i._c.p < j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool operator>(const stride_iterator& i, const stride_iterator& j) {
+        return i._c.p > j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool
+    operator<=(const stride_iterator& i, const stride_iterator& j) {
+        return i._c.p <= j._c.p;
+    }
+
+    /// Compares the positions of the iterators.
+    friend bool
+    operator>=(const stride_iterator& i, const stride_iterator& j) {
+        return i._c.p >= j._c.p;
+    }
+
+private:
+    _priv::partition_cursor<Iterator> _c;
+};
+
+/// Splits a container or iterator range into `k` consecutive sub-ranges
+/// whose sizes differ by at most one, with the larger ones first.  If there
+/// are fewer than `k` elements, the trailing sub-ranges are empty.
+///
+/// The result is a lazily evaluated range of `iterator_range`s, which is
+/// random-access with an O(1) `size()` if the underlying range is.  `k` must
+/// be positive.
+template<class Container> inline
+auto chunks(const Container& c,
+            typename std::iterator_traits<
+                iterator_type_t<const Container&>
+            >::difference_type k)
+#ifndef CALICO_DOC_ONLY
+-> iterator_range<chunk_iterator<iterator_type_t<const Container&> > >
+#endif
+{
+    typedef iterator_type_t<const Container&> iterator;
+    const iterator first = _priv::adl_begin(c);
+    const auto n = std::distance(first, iterator(_priv::adl_end(c)));
+    return make_range(chunk_iterator<iterator>(first, n, n / k, n % k, 0),
+                      chunk_iterator<iterator>(first, n, n / k, n % k, k));
+}
+
+/// Splits a container or iterator range into consecutive sub-ranges of
+/// `size` elements each, except for the last one which may be shorter.
+///
+/// The result is a lazily evaluated range of `iterator_range`s, which is
+/// random-access with an O(1) `size()` if the underlying range is.  `size`
+/// must be positive.
+template<class Container> inline
+auto chunks_of(const Container& c,
+               typename std::iterator_traits<
+                   iterator_type_t<const Container&>
+               >::difference_type size)
+#ifndef CALICO_DOC_ONLY
+-> iterator_range<chunk_iterator<iterator_type_t<const Container&> > >
+#endif
+{
+    typedef iterator_type_t<const Container&> iterator;
+    const iterator first = _priv::adl_begin(c);
+    const auto n = std::distance(first, iterator(_priv::adl_end(c)));
+    return make_range(chunk_iterator<iterator>(first, n, size, 0, 0),
+                      chunk_iterator<iterator>(first, n, size, 0,
+                                               (n + size - 1) / size));
+}
+
+/// Returns every `step`-th element of a container or iterator range,
+/// starting with the first one.
+///
+/// The result is a lazily evaluated range, which is random-access with an
+/// O(1) `size()` if the underlying range is.  `step` must be positive.
+template<class Container> inline
+auto stride(const Container& c,
+            typename std::iterator_traits<
+                iterator_type_t<const Container&>
+            >::difference_type step)
+#ifndef CALICO_DOC_ONLY
+-> iterator_range<stride_iterator<iterator_type_t<const Container&> > >
+#endif
+{
+    typedef iterator_type_t<const Container&> iterator;
+    const iterator first = _priv::adl_begin(c);
+    const auto n = std::distance(first, iterator(_priv::adl_end(c)));
+    return make_range(stride_iterator<iterator>(first, n, step, 0),
+                      stride_iterator<iterator>(first, n, step,
+                                                (n + step - 1) / step));
+}
+
+namespace _priv {
+
+template<std::size_t... I>
+struct indices {};
+
+template<std::size_t N, std::size_t... I>
+struct make_indices : make_indices<N - 1, N - 1, I...> {};
+
+template<std::size_t... I>
+struct make_indices<0, I...> { typedef indices<I...> type; };
+
+// The category of a `zip_iterator`: the weakest of the `Iterators`, but no
+// stronger than forward unless all of them are random-access, since only
+// then can the ends of the ranges be aligned up front.
+template<class... Iterators>
+struct zip_category {
+    typedef typename std::common_type<
+        typename std::iterator_traits<Iterators>::iterator_category...
+    >::type weakest;
+    typedef typename std::conditional<
+        std::is_base_of<std::random_access_iterator_tag, weakest>::value,
+        weakest,
+        typename std::common_type<std::forward_iterator_tag, weakest>::type
+    >::type type;
+};
+
+}
+
+/// An iterator that moves several iterators in lockstep and dereferences to
+/// a `std::tuple` of their references, obtained from `zip`.
+///
+/// If all the `Iterators` are random-access, so is this iterator, and the
+/// iterators are assumed to stay aligned (as they do in the ranges returned
+/// by `zip`), so comparisons and differences only look at the first one.
+/// Otherwise, two iterators compare equal if any of their components do, so
+/// that iteration stops at the end of the shortest range.  The end of such
+/// a range is not a valid position to step back from, so the category is
+/// then at most forward.
+///
+/// The reference type is a tuple of references rather than a true
+/// reference, so algorithms that swap elements through it (such as
+/// `std::sort`) are not supported.
+template<class... Iterators>
+struct zip_iterator {
+
+    /// Tuple of the underlying iterators.
+    typedef std::tuple<Iterators...> iterator_tuple;
+
+    /// Iterator category.
+    typedef CALICO_HIDE(
+        typename _priv::zip_category<Iterators...>::type
+    ) iterator_category;
+
+    /// Difference type.  It is signed even if some of the underlying
+    /// iterators (such as an `integer_iterator` of unsigned integers) use an
+    /// unsigned one.
+    typedef CALICO_HIDE(typename std::common_type<
+        typename std::make_signed<
+            typename std::iterator_traits<Iterators>::difference_type
+        >::type...
+    >::type) difference_type;
+
+    /// Value type.
+    typedef std::tuple<
+        typename std::iterator_traits<Iterators>::value_type...
+    > value_type;
+
+    /// Reference type.
+    typedef std::tuple<
+        typename std::iterator_traits<Iterators>::reference...
+    > reference;
+
+private:
+    static_assert(sizeof...(Iterators) > 0,
+                  "zip_iterator needs at least one iterator");
+
+    typedef typename _priv::make_indices<sizeof...(Iterators)>::type
+        _indices;
+
+    typedef _priv::reference_to_pointer<value_type, reference> _pointer;
+
+public:
+    /// Pointer type.
+    typedef CALICO_HIDE(typename _pointer::type) pointer;
+
+    /// Whether the underlying iterators are compared through the first one
+    /// only, which is the case if they are random-access.
+    typedef std::is_base_of<std::random_access_iterator_tag,
+                            iterator_category> aligned;
+
+    /// Default initializer.
+    zip_iterator() {}
+
+    /// Constructs an iterator from the underlying iterators.
+    explicit zip_iterator(const Iterators&... iterators)
+        : _its(iterators...) {}
+
+    /// Returns the underlying iterators.
+    const iterator_tuple& base() const { return _its; }
+
+    /// Returns a tuple of the references of the underlying iterators.
+    reference operator*() const { return deref(_indices()); }
+
+    /// Member access of the tuple of references.
+    pointer operator->() const { return _pointer::get(**this); }
+
+    /// Returns the tuple of references `n` positions away.
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    /// Pre-increments the iterators.
+    zip_iterator& operator++() {
+        increment(_indices());
+        return *this;
+    }
+
+    /// Post-increments the iterators.
+    zip_iterator operator++(int) {
+        zip_iterator t = *this;
+        ++*this;
+        return t;
+    }
+
+    /// Pre-decrements the iterators.
+    zip_iterator& operator--() {
+        decrement(_indices());
+        return *this;
+    }
+
+    /// Post-decrements the iterators.
+    zip_iterator operator--(int) {
+        zip_iterator t = *this;
+        --*this;
+        return t;
+    }
+
+    /// Advances the iterators by `n`.
+    zip_iterator& operator+=(difference_type n) {
+        advance(n, _indices());
+        return *this;
+    }
+
+    /// Advances the iterators by `n` in reverse.
+    zip_iterator& operator-=(difference_type n) {
+        advance(-n, _indices());
+        return *this;
+    }
+
+    /// Returns an iterator advanced by `n`.
+    friend zip_iterator operator+(zip_iterator i, difference_type n) {
+        return i += n;
+    }
+
+    /// Returns an iterator advanced by `n`.
+    friend zip_iterator operator+(difference_type n, zip_iterator i) {
+        return i += n;
+    }
+
+    /// Returns an iterator advanced by `n` in reverse.
+    friend zip_iterator operator-(zip_iterator i, difference_type n) {
+        return i -= n;
+    }
+
+    /// Returns the distance between the first underlying iterators.
+    friend difference_type
+    operator-(const zip_iterator& i, const zip_iterator& j) {
+        return static_cast<difference_type>(
+            std::get<0>(i._its) - std::get<0>(j._its));
+    }
+
+    /// Compares the underlying iterators.
+    friend bool operator==(const zip_iterator& i, const zip_iterator& j) {
+        return i.equal(j, aligned());
+    }
+
+    /// Compares the underlying iterators.
+    friend bool operator!=(const zip_iterator& i, const zip_iterator& j) {
+        return !i.equal(j, aligned());
+    }
+
+    /// Compares the first underlying iterators.
+    friend bool operator<(const zip_iterator& i, const zip_iterator& j) {
+        return std::get<0>(i._its) < std::get<0>(j._its);
+    }
+
+    /// Compares the first underlying iterators.
+    friend bool operator>(const zip_iterator& i, const zip_iterator& j) {
+        return std::get<0>(i._its) > std::get<0>(j._its);
+    }
+
+    /// Compares the first underlying iterators.
+    friend bool operator<=(const zip_iterator& i, const zip_iterator& j) {
+        return std::get<0>(i._its) <= std::get<0>(j._its);
+    }
+
+    /// Compares the first underlying iterators.
+    friend bool operator>=(const zip_iterator& i, const zip_iterator& j) {
+        return std::get<0>(i._its) >= std::get<0>(j._its);
+    }
+
+private:
+    template<std::size_t... I>
+    reference deref(_priv::indices<I...>) const {
+        return reference(*std::get<I>(_its)...);
+    }
+
+    // The arrays below only serve to expand the parameter packs in order.
+
+    template<std::size_t... I>
+    void increment(_priv::indices<I...>) {
+        const int expand[] = {0, (++std::get<I>(_its), 0)...};
+        (void)expand;
+    }
+
+    template<std::size_t... I>
+    void decrement(_priv::indices<I...>) {
+        static_assert(aligned::value, "zip_iterator can only step backwards "
+                      "if all of its iterators are random-access");
+        const int expand[] = {0, (--std::get<I>(_its), 0)...};
+        (void)expand;
+    }
+
+    template<std::size_t I>
+    using _difference_type = typename std::iterator_traits<
+        typename std::tuple_element<I, iterator_tuple>::type
+    >::difference_type;
+
+    template<std::size_t... I>
+    void advance(difference_type n, _priv::indices<I...>) {
+        const int expand[] = {0, (std::get<I>(_its) +=
+                                  static_cast<_difference_type<I> >(n),
+                                  0)...};
+        (void)expand;
+    }
+
+    bool equal(const zip_iterator& other, std::true_type) const {
+        return std::get<0>(_its) == std::get<0>(other._its);
+    }
+
+    bool equal(const zip_iterator& other, std::false_type) const {
+        return any_equal(other, _indices());
+    }
+
+    template<std::size_t... I>
+    bool any_equal(const zip_iterator& other, _priv::indices<I...>) const {
+        bool equal = false;
+        const int expand[] = {0, (equal = equal || std::get<I>(_its)
+                                              == std::get<I>(other._its),
+                                  0)...};
+        (void)expand;
+        return equal;
+    }
+
+    iterator_tuple _its;
+};
+
+namespace _priv {
+
+// Unlike `adl_begin` and `adl_end`, these preserve the constness of the
+// container.
+
+template<class Container> inline
+auto adl_begin_mutable(Container& c)
+-> decltype(begin(c))
+{   return  begin(c); }
+
+template<class Container> inline
+auto adl_end_mutable(Container& c)
+-> decltype(end(c))
+{   return  end(c); }
+
+// Random-access zipped ranges end at the length of the shortest range, so
+// that only the first iterator needs to be compared.
+template<class... Iterators, std::size_t... I> inline
+iterator_range<zip_iterator<Iterators...> >
+make_zip_range(const zip_iterator<Iterators...>& first,
+               const zip_iterator<Iterators...>& last,
+               std::true_type,
+               indices<I...>) {
+    typedef typename zip_iterator<Iterators...>::difference_type
+        difference_type;
+    difference_type n = last - first;
+    difference_type m;
+    const int expand[] = {0, (
+        m = static_cast<difference_type>(
+            std::get<I>(last.base()) - std::get<I>(first.base())),
+        n = m < n ? m : n, 0)...};
+    (void)expand;
+    return make_range(first, first + n);
+}
+
+template<class... Iterators, std::size_t... I> inline
+iterator_range<zip_iterator<Iterators...> >
+make_zip_range(const zip_iterator<Iterators...>& first,
+               const zip_iterator<Iterators...>& last,
+               std::false_type,
+               indices<I...>) {
+    return make_range(first, last);
+}
+
+}
+
+/// Iterates several containers or iterator ranges in lockstep, yielding
+/// `std::tuple`s of references to their elements, up to the end of the
+/// shortest one.
+///
+/// ~~~~cpp
+/// for (auto&& t : zip(x, y))
+///     std::get<1>(t) += a * std::get<0>(t);
+/// ~~~~
+///
+/// The ranges are not copied, so they must outlive the result.  If they are
+/// all random-access, so is the result, with an O(1) `size()`, and a loop
+/// over it compiles to the same code as an indexed loop.  Otherwise, the
+/// result is at most a forward range.
+///
+/// @see zip_iterator
+template<class... Containers> inline
+auto zip(Containers&&... c)
+#ifndef CALICO_DOC_ONLY
+-> iterator_range<zip_iterator<decltype(_priv::adl_begin_mutable(c))...> >
+#endif
+{
+    typedef zip_iterator<decltype(_priv::adl_begin_mutable(c))...> iterator;
+    return _priv::make_zip_range(
+        iterator(_priv::adl_begin_mutable(c)...),
+        iterator(_priv::adl_end_mutable(c)...),
+        typename iterator::aligned(),
+        typename _priv::make_indices<sizeof...(Containers)>::type());
+}
+
 }
 #endif
@@ -0,0 +1,533 @@
+#ifndef HXQDMWAPZVKTRCNEUBLJ
+#define HXQDMWAPZVKTRCNEUBLJ
+/// @file
+///
+/// An asynchronous logger with deferred formatting.
+///
+/// Logging a message only copies the format string pointer and the
+/// arguments, in binary form, into a ring buffer owned by the calling thread.
+/// A background thread later decodes them and formats the line using
+/// `format_append` (see `format.hpp`), so the cost of formatting is never
+/// paid by the thread that logs.
+///
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "format.hpp"
+#include "string.hpp"
+namespace cal {
+
+/// What a `logger` does when the ring buffer of a thread is full.
+enum class log_overflow {
+    /// Discards the message and counts it in `logger::dropped`.
+    drop,
+    /// Waits until the background thread has made room.
+    block
+};
+
+namespace _priv {
+
+// How an argument is stored in a log record.  Trivially copyable values are
+// copied as they are; strings are copied as a length followed by the
+// characters and decoded as a `string_ref`.
+template<class T, class = void>
+struct log_codec {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "cal::logger: arguments must be strings or trivially "
+                  "copyable; convert other types with to_string first");
+    typedef T decoded_type;
+    static std::size_t size(const T&) { return sizeof(T); }
+    static char* encode(char* p, const T& x) {
+        std::memcpy(p, &x, sizeof(T));
+        return p + sizeof(T);
+    }
+    static T decode(const char*& p) {
+        T x;
+        std::memcpy(&x, p, sizeof(T));
+        p += sizeof(T);
+        return x;
+    }
+};
+
+struct log_string_codec {
+    typedef string_ref decoded_type;
+    static std::size_t size(string_ref s) {
+        return sizeof(std::size_t) + s.size();
+    }
+    static char* encode(char* p, string_ref s) {
+        const std::size_t n = s.size();
+        std::memcpy(p, &n, sizeof(n));
+        std::char_traits<char>::copy(p + sizeof(n), s.data(), n);
+        return p + sizeof(n) + n;
+    }
+    static string_ref decode(const char*& p) {
+        std::size_t n;
+        std::memcpy(&n, p, sizeof(n));
+        const string_ref s(p + sizeof(n), n);
+        p += sizeof(n) + n;
+        return s;
+    }
+};
+
+template<>
+struct log_codec<const char*> : log_string_codec {};
+
+template<>
+struct log_codec<char*> : log_string_codec {};
+
+template<class Traits, class Allocator>
+struct log_codec<std::basic_string<char, Traits, Allocator> >
+    : log_string_codec {};
+
+template<>
+struct log_codec<string_ref> : log_string_codec {};
+
+inline std::size_t log_encoded_size() { return 0; }
+
+template<class T, class... Ts>
+inline std::size_t log_encoded_size(const T& x, const Ts&... xs) {
+    return log_codec<typename std::decay<T>::type>::size(x)
+         + log_encoded_size(xs...);
+}
+
+inline char* log_encode(char* p) { return p; }
+
+template<class T, class... Ts>
+inline char* log_encode(char* p, const T& x, const Ts&... xs) {
+    return log_encode(log_codec<typename std::decay<T>::type>::encode(p, x),
+                      xs...);
+}
+
+// Decodes the arguments one at a time, accumulating them as a parameter
+// pack, and formats them once they are all available.
+template<class... Ts>
+struct log_decoder;
+
+template<>
+struct log_decoder<> {
+    template<class... Us>
+    static void apply(const char*, std::string& out, const char* format,
+                      const Us&... us) {
+        format_append(out, format, us...);
+    }
+};
+
+template<class T, class... Ts>
+struct log_decoder<T, Ts...> {
+    template<class... Us>
+    static void apply(const char* p, std::string& out, const char* format,
+                      const Us&... us) {
+        const typename log_codec<T>::decoded_type x =
+            log_codec<T>::decode(p);
+        log_decoder<Ts...>::apply(p, out, format, us..., x);
+    }
+};
+
+// Formats a record that starts with the format string pointer.
+template<class... Ts>
+void log_format(const char* p, std::string& out) {
+    const char* format;
+    std::memcpy(&format, p, sizeof(format));
+    log_decoder<Ts...>::apply(p + sizeof(format), out, format);
+}
+
+// Each record begins with this header.  Records are padded to a multiple of
+// its size, and a record with a null `format` fills the gap at the end of
+// the ring when the next record would not fit there.
+struct log_header {
+    void (*format)(const char*, std::string&);
+    std::size_t size;
+};
+
+// A single-producer, single-consumer ring buffer of log records.  The
+// positions increase monotonically and are reduced modulo the capacity only
+// when indexing.
+class log_ring {
+public:
+
+    explicit log_ring(std::size_t capacity)
+        : _data(new char[capacity]()),
+          _capacity(capacity),
+          _head(0),
+          _tail(0),
+          _dropped(0),
+          _orphaned(false),
+          _write(0),
+          _cached_tail(0),
+          _read(0) {}
+
+    std::size_t capacity() const { return _capacity; }
+
+    // Producer: returns space for a record of `size` bytes, or null if the
+    // ring is too full.
+    char* reserve(std::size_t size) {
+        const std::size_t offset = index(_write);
+        const std::size_t contiguous = _capacity - offset;
+        const std::size_t needed = size <= contiguous ? size
+                                                      : contiguous + size;
+        if (_write + needed - _cached_tail > _capacity) {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            if (_write + needed - _cached_tail > _capacity)
+                return nullptr;
+        }
+        if (size <= contiguous)
+            return _data.get() + offset;
+        const log_header padding = {nullptr, contiguous};
+        std::memcpy(_data.get() + offset, &padding, sizeof(padding));
+        _write += contiguous;
+        return _data.get();
+    }
+
+    // Producer: publishes a record written into the reserved space.
+    void commit(std::size_t size) {
+        _write += size;
+        _head.store(_write, std::memory_order_release);
+    }
+
+    void drop() { _dropped.fetch_add(1, std::memory_order_relaxed); }
+
+    std::uint64_t dropped() const {
+        return _dropped.load(std::memory_order_relaxed);
+    }
+
+    // Consumer: formats every published record into `out`, calling `sink`
+    // whenever `out` grows large.  Returns whether there were any records.
+    bool drain(std::string& out,
+               const std::function<void(string_ref)>& sink) {
+        const std::uint64_t head = _head.load(std::memory_order_acquire);
+        if (_read == head)
+            return false;
+        while (_read != head) {
+            const char* p = _data.get() + index(_read);
+            log_header h;
+            std::memcpy(&h, p, sizeof(h));
+            if (h.format) {
+                const std::size_t start = out.size();
+                try {
+                    h.format(p + sizeof(h), out);
+                } catch (const std::exception& e) {
+                    out.resize(start);
+                    out += "[cal::logger: ";
+                    out += e.what();
+                    out += ']';
+                }
+                out += '\n';
+            }
+            _read += h.size;
+            _tail.store(_read, std::memory_order_release);
+            if (out.size() >= 65536) {
+                sink(out);
+                out.clear();
+            }
+        }
+        return true;
+    }
+
+    bool empty() const {
+        return _tail.load(std::memory_order_acquire)
+            == _head.load(std::memory_order_acquire);
+    }
+
+    // Set when the owning thread exits, so that the ring can be handed to
+    // another thread once it has been drained.
+    std::atomic<bool>& orphaned() { return _orphaned; }
+
+private:
+    std::size_t index(std::uint64_t position) const {
+        return static_cast<std::size_t>(position & (_capacity - 1));
+    }
+
+    std::unique_ptr<char[]> _data;
+    const std::size_t _capacity;
+    // The padding keeps the shared positions and each side's private state
+    // on separate cache lines.
+    char _pad0[64];
+    std::atomic<std::uint64_t> _head;
+    char _pad1[64];
+    std::atomic<std::uint64_t> _tail;
+    std::atomic<std::uint64_t> _dropped;
+    std::atomic<bool> _orphaned;
+    char _pad2[64];
+    std::uint64_t _write;
+    std::uint64_t _cached_tail;
+    char _pad3[64];
+    std::uint64_t _read;
+};
+
+// A ring used by the current thread.  The logger owns the ring, so only a
+// weak reference is kept here.  Since ids are never reused, the raw pointer
+// is valid whenever the id matches the logger that is looking it up.
+struct log_thread_ring {
+    std::uint64_t id;
+    log_ring* ring;
+    std::weak_ptr<log_ring> owner;
+};
+
+// The rings of the current thread, keyed by the id of their logger.
+struct log_thread_rings {
+    std::vector<log_thread_ring> rings;
+
+    // Forgets the rings of loggers that have been destroyed.
+    void prune() {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i != rings.size(); ++i)
+            if (!rings[i].owner.expired())
+                rings[n++] = std::move(rings[i]);
+        rings.resize(n);
+    }
+
+    ~log_thread_rings() {
+        for (std::size_t i = 0; i != rings.size(); ++i)
+            if (const std::shared_ptr<log_ring> ring = rings[i].owner.lock())
+                ring->orphaned().store(true, std::memory_order_release);
+    }
+};
+
+inline log_thread_rings& thread_log_rings() {
+    static thread_local log_thread_rings rings;
+    return rings;
+}
+
+inline std::uint64_t next_logger_id() {
+    static std::atomic<std::uint64_t> id(0);
+    return ++id;
+}
+
+inline std::size_t round_up_pow2(std::size_t n) {
+    std::size_t m = 1;
+    while (m < n)
+        m *= 2;
+    return m;
+}
+
+}
+
+/// An asynchronous logger.
+///
+/// Each thread that logs gets its own lock-free ring buffer, so logging from
+/// many threads involves no shared writes.  A message is stored as the
+/// format string pointer followed by the arguments in binary form; strings
+/// are copied, while numbers and other trivially copyable values are stored
+/// as they are.  A background thread formats the messages with
+/// `format_append`, appends a newline to each, and passes the text to the
+/// sink in large batches.  Messages from the same thread are written in
+/// order; messages from different threads may be interleaved arbitrarily.
+///
+/// Memory use is bounded by the capacity of each ring.  When a ring is full,
+/// the message is either dropped or the thread waits, according to the
+/// `log_overflow` policy.  Messages larger than a quarter of the capacity are
+/// always dropped.
+///
+/// Because formatting is deferred, the format string must remain valid
+/// until the message has been written, which is always the case for string
+/// literals.  Errors in the format string are written in place of the
+/// message.
+///
+/// Example:
+///
+/// ~~~cpp
+/// cal::logger log(stderr);
+/// log.log("request {} took {} ms", id, elapsed);
+/// log.flush();
+/// ~~~
+class logger {
+public:
+
+    /// The type of function that receives the formatted text.  It is only
+    /// ever called from the background thread.
+    typedef std::function<void(string_ref)> sink_type;
+
+    /// Starts a logger that writes the formatted lines to `sink`.
+    ///
+    /// @param sink           Receives the formatted text in batches.
+    /// @param ring_capacity  The size of each thread's buffer in bytes,
+    ///                       rounded up to a power of two.
+    /// @param overflow       What to do when a thread's buffer is full.
+    explicit logger(sink_type sink,
+                    std::size_t ring_capacity = 65536,
+                    log_overflow overflow = log_overflow::drop)
+        : _sink(std::move(sink)),
+          _ring_capacity(_priv::round_up_pow2(
+              ring_capacity < 256 ? 256 : ring_capacity)),
+          _overflow(overflow),
+          _id(_priv::next_logger_id()),
+          _rings_version(0),
+          _flush_requested(0),
+          _flush_done(0),
+          _stop(false) {
+        _thread = std::thread(&logger::run, this);
+    }
+
+    /// Starts a logger that writes the formatted lines to a file.
+    ///
+    /// @see logger(sink_type, std::size_t, log_overflow)
+    explicit logger(std::FILE* file,
+                    std::size_t ring_capacity = 65536,
+                    log_overflow overflow = log_overflow::drop)
+        : logger(sink_type([file](string_ref s) {
+                     std::fwrite(s.data(), 1, s.size(), file);
+                     std::fflush(file);
+                 }), ring_capacity, overflow) {}
+
+    logger(const logger&) = delete;
+
+    logger& operator=(const logger&) = delete;
+
+    /// Writes all pending messages and stops the background thread.
+    ~logger() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_one();
+        _thread.join();
+    }
+
+    /// Queues a message to be formatted as `format(format, args...)`.
+    ///
+    /// @return  Whether the message was queued, which is always the case
+    ///          for the `block` policy unless the message is too large.
+    template<class... Args>
+    bool log(const char* format, const Args&... args) {
+        _priv::log_ring& ring = thread_ring();
+        const std::size_t header_size = sizeof(_priv::log_header);
+        const std::size_t size =
+            (header_size + sizeof(format) + _priv::log_encoded_size(args...)
+             + header_size - 1) / header_size * header_size;
+        if (size > _ring_capacity / 4) {
+            ring.drop();
+            return false;
+        }
+        char* p = ring.reserve(size);
+        while (!p) {
+            if (_overflow == log_overflow::drop) {
+                ring.drop();
+                return false;
+            }
+            _wake.notify_one();
+            std::this_thread::yield();
+            p = ring.reserve(size);
+        }
+        const _priv::log_header h = {
+            &_priv::log_format<typename std::decay<Args>::type...>, size
+        };
+        std::memcpy(p, &h, sizeof(h));
+        std::memcpy(p + sizeof(h), &format, sizeof(format));
+        _priv::log_encode(p + sizeof(h) + sizeof(format), args...);
+        ring.commit(size);
+        return true;
+    }
+
+    /// Waits until every message logged before the call (by any thread) has
+    /// been formatted and passed to the sink.
+    void flush() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        const std::uint64_t ticket = ++_flush_requested;
+        _wake.notify_one();
+        _flushed.wait(lock, [&] { return _flush_done >= ticket; });
+    }
+
+    /// Returns the number of messages that have been dropped.
+    std::uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::uint64_t n = 0;
+        for (const std::shared_ptr<_priv::log_ring>& ring : _rings)
+            n += ring->dropped();
+        return n;
+    }
+
+private:
+
+    _priv::log_ring& thread_ring() {
+        _priv::log_thread_rings& table = _priv::thread_log_rings();
+        for (std::size_t i = 0; i != table.rings.size(); ++i)
+            if (table.rings[i].id == _id)
+                return *table.rings[i].ring;
+        table.prune();
+        const std::shared_ptr<_priv::log_ring> ring = acquire_ring();
+        const _priv::log_thread_ring entry = {_id, ring.get(), ring};
+        table.rings.push_back(entry);
+        return *ring;
+    }
+
+    // Reuses a drained ring from a thread that has exited, or creates one.
+    std::shared_ptr<_priv::log_ring> acquire_ring() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (const std::shared_ptr<_priv::log_ring>& ring : _rings) {
+            if (ring->orphaned().load(std::memory_order_acquire)
+                && ring->empty()) {
+                ring->orphaned().store(false, std::memory_order_relaxed);
+                return ring;
+            }
+        }
+        _rings.push_back(std::make_shared<_priv::log_ring>(_ring_capacity));
+        ++_rings_version;
+        return _rings.back();
+    }
+
+    void run() {
+        std::vector<std::shared_ptr<_priv::log_ring> > rings;
+        std::uint64_t version = 0;
+        std::string out;
+        for (;;) {
+            std::uint64_t target;
+            bool stop;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                target = _flush_requested;
+                stop = _stop;
+                if (version != _rings_version) {
+                    rings = _rings;
+                    version = _rings_version;
+                }
+            }
+            bool busy = false;
+            for (const std::shared_ptr<_priv::log_ring>& ring : rings)
+                busy |= ring->drain(out, _sink);
+            if (!out.empty()) {
+                _sink(out);
+                out.clear();
+            }
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_flush_done != target) {
+                _flush_done = target;
+                _flushed.notify_all();
+            }
+            if (stop)
+                return;
+            if (!busy && !_stop && _flush_requested == target)
+                _wake.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    const sink_type _sink;
+    const std::size_t _ring_capacity;
+    const log_overflow _overflow;
+    const std::uint64_t _id;
+    mutable std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _flushed;
+    std::vector<std::shared_ptr<_priv::log_ring> > _rings;
+    std::uint64_t _rings_version;
+    std::uint64_t _flush_requested;
+    std::uint64_t _flush_done;
+    bool _stop;
+    std::thread _thread;
+};
+
+}
+#endif
@@ -0,0 +1,399 @@
+#ifndef SEPPIBRNCREHHCGGKTAM
+#define SEPPIBRNCREHHCGGKTAM
+/// @file
+///
+/// Multi-dimensional index ranges with optional cache blocking.
+///
+/// An `nd_range<N>` enumerates the indices of an N-dimensional box as
+/// `std::array`s, in row-major order (the last index varies fastest), so
+///
+/// ~~~~cpp
+/// for (const auto& i : nd_range<2>({rows, cols}))
+///     f(i[0], i[1]);
+/// ~~~~
+///
+/// visits the same indices in the same order as two nested loops.  A tiled
+/// range instead visits the box one tile at a time, which keeps the working
+/// set of a kernel that walks one operand along rows and another along
+/// columns (such as a transpose) within the cache.  `collapse()` presents
+/// either order as a flat random-access range, for use with `chunks` or
+/// `parallel_for`.
+///
+/// The iterators carry the loop state of every dimension, which costs a
+/// little in very tight loops; `nd_range::for_each` visits the same indices
+/// through genuinely nested loops instead.
+///
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include "iterator.hpp"
+
+/// @def CALICO_L1_CACHE_SIZE
+///
+/// Size of the L1 data cache in bytes, used to choose default tile sizes.
+/// Defaults to 32 KiB.
+#ifndef CALICO_L1_CACHE_SIZE
+#   define CALICO_L1_CACHE_SIZE 32768
+#endif
+
+/// @def CALICO_L2_CACHE_SIZE
+///
+/// Size of the L2 cache in bytes, used to choose default tile sizes.
+/// Defaults to 256 KiB.
+#ifndef CALICO_L2_CACHE_SIZE
+#   define CALICO_L2_CACHE_SIZE 262144
+#endif
+
+namespace cal {
+namespace _priv {
+
+// The tile size actually used along a dimension, where 0 stands for the
+// whole extent.
+inline std::size_t nd_effective_tile(std::size_t tile, std::size_t extent) {
+    return tile && tile < extent ? tile : extent;
+}
+
+// Maps a position in the traversal order of an `nd_range` to its index.
+//
+// The order is row-major over the grid of tiles, then row-major within each
+// tile.  Along each dimension every tile but the last is full, so the tile
+// coordinates can be peeled off one dimension at a time by division.
+template<std::size_t N, class T>
+struct nd_unflatten {
+    typedef std::array<T, N> index_type;
+
+    nd_unflatten() {}
+
+    nd_unflatten(const index_type& lower,
+                 const std::array<std::size_t, N>& extent,
+                 const std::array<std::size_t, N>& tile)
+        : lower(lower), extent(extent) {
+        std::size_t suffix = 1;
+        for (std::size_t d = N; d--;) {
+            this->tile[d] = nd_effective_tile(tile[d], extent[d]);
+            this->suffix[d] = suffix;
+            suffix *= extent[d];
+        }
+    }
+
+    index_type operator()(std::size_t k) const {
+        std::array<std::size_t, N> origin, size;
+        std::size_t prefix = 1;
+        for (std::size_t d = 0; d != N; ++d) {
+            const std::size_t unit = prefix * tile[d] * suffix[d];
+            origin[d] = k / unit * tile[d];
+            k %= unit;
+            size[d] = extent[d] - origin[d] < tile[d]
+                    ? extent[d] - origin[d] : tile[d];
+            prefix *= size[d];
+        }
+        index_type i;
+        for (std::size_t d = N; d--;) {
+            i[d] = static_cast<T>(lower[d] + static_cast<T>(origin[d]
+                                                         + k % size[d]));
+            k /= size[d];
+        }
+        return i;
+    }
+
+    index_type lower;
+    std::array<std::size_t, N> extent, tile, suffix;
+};
+
+// Nested loops over dimensions `D` to `N - 1` of the box from `first` to
+// `last`, calling `f` with the index in the innermost loop.
+template<std::size_t D, std::size_t N>
+struct nd_loop {
+    template<class T, class F>
+    static void run(std::array<T, N>& i,
+                    const std::array<T, N>& first,
+                    const std::array<T, N>& last,
+                    const F& f) {
+        for (i[D] = first[D]; i[D] != last[D]; ++i[D])
+            nd_loop<D + 1, N>::run(i, first, last, f);
+    }
+};
+
+template<std::size_t N>
+struct nd_loop<N, N> {
+    template<class T, class F>
+    static void run(std::array<T, N>& i,
+                    const std::array<T, N>&,
+                    const std::array<T, N>&,
+                    const F& f) {
+        f(static_cast<const std::array<T, N>&>(i));
+    }
+};
+
+// Nested loops over the tiles of dimensions `D` to `N - 1`, running
+// `nd_loop` over each tile in the innermost loop.
+template<std::size_t D, std::size_t N>
+struct nd_tile_loop {
+    template<class T, class F>
+    static void run(std::array<T, N>& origin,
+                    std::array<T, N>& stop,
+                    const std::array<T, N>& lower,
+                    const std::array<T, N>& upper,
+                    const std::array<T, N>& tile,
+                    const F& f) {
+        for (origin[D] = lower[D]; origin[D] < upper[D];
+             origin[D] = static_cast<T>(origin[D] + tile[D])) {
+            stop[D] = upper[D] - origin[D] < tile[D]
+                    ? upper[D] : static_cast<T>(origin[D] + tile[D]);
+            nd_tile_loop<D + 1, N>::run(origin, stop, lower, upper, tile, f);
+        }
+    }
+};
+
+template<std::size_t N>
+struct nd_tile_loop<N, N> {
+    template<class T, class F>
+    static void run(std::array<T, N>& origin,
+                    std::array<T, N>& stop,
+                    const std::array<T, N>&,
+                    const std::array<T, N>&,
+                    const std::array<T, N>&,
+                    const F& f) {
+        std::array<T, N> i;
+        nd_loop<0, N>::run(i, origin, stop, f);
+    }
+};
+
+}
+
+/// A `ForwardIterator` over the indices of an `nd_range`, dereferencing to
+/// a `std::array` of indices by value.
+template<std::size_t N, class T>
+class nd_iterator
+    : public input_iterator_base<nd_iterator<N, T>,
+                                 std::array<T, N>,
+                                 std::array<T, N> > {
+public:
+
+    /// Iterator category.
+    typedef std::forward_iterator_tag iterator_category;
+
+    /// Index type.
+    typedef std::array<T, N> index_type;
+
+    using input_iterator_base<nd_iterator, index_type, index_type>::operator++;
+
+    /// Default initializer.
+    nd_iterator() {}
+
+    /// Constructs an iterator at the first index of the box spanning
+    /// `lower` (inclusive) to `upper` (exclusive), or at its end if `at_end`
+    /// is true.  A tile size of 0 stands for the whole extent.
+    nd_iterator(const index_type& lower,
+                const index_type& upper,
+                const std::array<std::size_t, N>& tile,
+                bool at_end)
+        : _lower(lower), _upper(upper), _origin(lower), _i(lower) {
+        for (std::size_t d = 0; d != N; ++d) {
+            if (!(lower[d] < upper[d]))
+                at_end = true;
+            _tile[d] = static_cast<T>(_priv::nd_effective_tile(
+                tile[d], static_cast<std::size_t>(upper[d] - lower[d])));
+            _stop[d] = static_cast<T>(lower[d] + _tile[d]);
+        }
+        if (at_end)
+            _i[0] = upper[0];
+    }
+
+    /// Returns the current index.
+    index_type operator*() const { return _i; }
+
+    /// Compares the current indices.  Only the end iterator has a first
+    /// index equal to its upper bound, so this usually takes a single
+    /// comparison.
+    bool operator==(const nd_iterator& other) const {
+        for (std::size_t d = 0; d != N; ++d)
+            if (_i[d] != other._i[d])
+                return false;
+        return true;
+    }
+
+    /// Advances to the next index.
+    nd_iterator& operator++() {
+        // next index within the tile
+        for (std::size_t d = N; d--;) {
+            if (++_i[d] != _stop[d])
+                return *this;
+            _i[d] = _origin[d];
+        }
+        // first index of the next tile
+        for (std::size_t d = N; d--;) {
+            _origin[d] = static_cast<T>(_origin[d] + _tile[d]);
+            if (_origin[d] < _upper[d]) {
+                _i[d] = _origin[d];
+                _stop[d] = _upper[d] - _origin[d] < _tile[d]
+                         ? _upper[d] : static_cast<T>(_origin[d] + _tile[d]);
+                return *this;
+            }
+            _origin[d] = _lower[d];
+            _i[d] = _lower[d];
+            _stop[d] = static_cast<T>(_lower[d] + _tile[d]);
+        }
+        _i[0] = _upper[0];
+        return *this;
+    }
+
+private:
+    index_type _lower, _upper, _tile, _origin, _stop, _i;
+};
+
+/// An N-dimensional box of indices, iterated as `std::array<T, N>`s.
+///
+/// The indices are visited in row-major order, or tile by tile if the range
+/// is tiled; `size()` is O(1).  Tile sizes may be given explicitly, where 0
+/// stands for the whole extent of the dimension, or chosen from the cache
+/// sizes by `tiled()`.
+///
+/// @tparam N  The number of dimensions.
+/// @tparam T  The index type.
+template<std::size_t N, class T = std::size_t>
+class nd_range
+    : public container_base<nd_range<N, T>, nd_iterator<N, T>,
+                            nd_iterator<N, T>, std::size_t> {
+    static_assert(N > 0, "nd_range must have at least one dimension");
+
+public:
+
+    /// Index type.
+    typedef std::array<T, N> index_type;
+
+    /// Type of the extents and tile sizes.
+    typedef std::array<std::size_t, N> shape_type;
+
+    /// Iterator type of `collapse()`.
+    typedef transform_iterator<integer_iterator<std::size_t>,
+                               _priv::nd_unflatten<N, T> > flat_iterator;
+
+    /// Constructs the box from `T()` (inclusive) to `upper` (exclusive)
+    /// along each dimension.
+    explicit nd_range(const index_type& upper)
+        : _lower(), _upper(upper), _tile() { _lower.fill(T()); }
+
+    /// Constructs the box from `lower` (inclusive) to `upper` (exclusive)
+    /// along each dimension.
+    nd_range(const index_type& lower, const index_type& upper)
+        : _lower(lower), _upper(upper), _tile() {}
+
+    /// Constructs a tiled box from `lower` (inclusive) to `upper`
+    /// (exclusive) along each dimension.
+    nd_range(const index_type& lower,
+             const index_type& upper,
+             const shape_type& tile)
+        : _lower(lower), _upper(upper), _tile(tile) {}
+
+    /// Returns the lower bounds of the box.
+    const index_type& lower() const { return _lower; }
+
+    /// Returns the upper bounds of the box.
+    const index_type& upper() const { return _upper; }
+
+    /// Returns the tile sizes (0 stands for the whole extent).
+    const shape_type& tile_sizes() const { return _tile; }
+
+    /// Returns the number of indices along each dimension.
+    shape_type extents() const {
+        shape_type e;
+        for (std::size_t d = 0; d != N; ++d)
+            e[d] = _lower[d] < _upper[d]
+                 ? static_cast<std::size_t>(_upper[d] - _lower[d]) : 0;
+        return e;
+    }
+
+    /// Returns the number of indices.
+    std::size_t size() const {
+        std::size_t n = 1;
+        for (std::size_t e : extents())
+            n *= e;
+        return n;
+    }
+
+    /// Returns an iterator to the first index.
+    nd_iterator<N, T> begin() const {
+        return nd_iterator<N, T>(_lower, _upper, _tile, false);
+    }
+
+    /// Returns an iterator past the last index.
+    nd_iterator<N, T> end() const {
+        return nd_iterator<N, T>(_lower, _upper, _tile, true);
+    }
+
+    /// Calls `f` with each index (as a `const index_type&`) in the same
+    /// order as the iterators.
+    ///
+    /// Unlike a range-based `for` loop, this is written as nested loops over
+    /// the tiles and over the dimensions, so that it compiles to the same
+    /// code as handwritten loops.
+    template<class F>
+    void for_each(const F& f) const {
+        index_type origin, stop, tile;
+        for (std::size_t d = 0; d != N; ++d) {
+            if (!(_lower[d] < _upper[d]))
+                return;
+            tile[d] = static_cast<T>(_priv::nd_effective_tile(
+                _tile[d], static_cast<std::size_t>(_upper[d] - _lower[d])));
+        }
+        _priv::nd_tile_loop<0, N>::run(origin, stop, _lower, _upper, tile, f);
+    }
+
+    /// Returns the same box traversed with the given tile sizes.
+    nd_range tiled(const shape_type& tile) const {
+        return nd_range(_lower, _upper, tile);
+    }
+
+    /// Returns the same box traversed with tiles chosen for a kernel that
+    /// touches two arrays of `element_size`-byte elements per index.
+    ///
+    /// The last two dimensions are tiled in squares that fit in the L1
+    /// cache, the dimension before them (if any) so that a stack of tiles
+    /// fits in the L2 cache, and the remaining dimensions are left as outer
+    /// loops.  A one-dimensional range is not tiled.
+    nd_range tiled(std::size_t element_size = sizeof(double)) const {
+        return tiled(default_tile_sizes(element_size));
+    }
+
+    /// Returns the tile sizes used by `tiled(element_size)`.
+    static shape_type default_tile_sizes(
+        std::size_t element_size = sizeof(double)) {
+        shape_type tile;
+        tile.fill(1);
+        if (N == 1) {
+            tile[0] = 0;
+            return tile;
+        }
+        const std::size_t bytes = 2 * (element_size ? element_size : 1);
+        std::size_t side = 1;
+        while (4 * side * side * bytes <= CALICO_L1_CACHE_SIZE)
+            side *= 2;
+        tile[N - 1] = side;
+        tile[N - 2] = side;
+        if (N > 2) {
+            const std::size_t depth =
+                CALICO_L2_CACHE_SIZE / (side * side * bytes);
+            tile[N > 2 ? N - 3 : 0] = depth ? depth : 1;
+        }
+        return tile;
+    }
+
+    /// Returns the indices as a lazily evaluated random-access range in the
+    /// same order, computing each one from its position.  This costs a few
+    /// divisions per element, but allows the range to be split into pieces,
+    /// e.g. with `chunks` or `parallel_for`.
+    iterator_range<flat_iterator> collapse() const {
+        const _priv::nd_unflatten<N, T> f(_lower, extents(), _tile);
+        return make_range(
+            flat_iterator(integer_iterator<std::size_t>(0), f),
+            flat_iterator(integer_iterator<std::size_t>(size()), f));
+    }
+
+private:
+    index_type _lower, _upper;
+    shape_type _tile;
+};
+
+}
+#endif
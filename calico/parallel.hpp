@@ -0,0 +1,427 @@
+#ifndef JTQMXCZWNFRHLYBKVDPA
+#define JTQMXCZWNFRHLYBKVDPA
+/// @file
+///
+/// Fork-join parallel loops over random-access ranges.
+///
+/// `parallel_for` and `parallel_for_each` split a range in halves
+/// recursively until the pieces are small enough, running the pieces on a
+/// `thread_pool`.  Each thread of the pool owns a Chase–Lev deque: it pushes
+/// the right half of each split onto the bottom of its own deque and works on
+/// the left half, while idle threads steal the oldest (and therefore
+/// largest) pieces from the top of other deques.  A thread that finishes its
+/// half takes the other half back if nobody has stolen it, so in the common
+/// case the work stays on one core and costs only a few uncontended atomic
+/// operations per split.
+///
+/// The thread that calls `parallel_for` takes part in the work, and loops
+/// may be nested freely: a loop started from within another loop of the
+/// same pool simply pushes its pieces onto the deque of the current thread.
+/// Task descriptors live on the stack of the thread that split them, which
+/// waits for them, so no memory is allocated.
+///
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "iterator.hpp"
+namespace cal {
+
+class thread_pool;
+
+namespace _priv {
+
+template<class Iterator, class F>
+struct parallel_loop;
+
+// A unit of work that someone waits for.  `done` is set once it has run.
+struct parallel_task {
+    void (*run)(parallel_task*);
+    std::atomic<bool> done;
+};
+
+// A fixed-capacity Chase–Lev work-stealing deque: the owner pushes and pops
+// at the bottom, and any thread may steal from the top.  (Lê, Pop, Cohen,
+// and Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory
+// Models", 2013.)  Since tasks are always joined in LIFO order, the deque
+// never holds more than the nesting depth of the splits, so it does not
+// need to grow: if it is full, the owner simply keeps the work.
+class parallel_deque {
+public:
+
+    static const std::size_t capacity = 1024;
+
+    parallel_deque() : _top(0), _bottom(0) {
+        for (std::atomic<parallel_task*>& slot : _tasks)
+            slot.store(nullptr, std::memory_order_relaxed);
+    }
+
+    bool push(parallel_task* t) {
+        const std::int64_t b = _bottom.load(std::memory_order_relaxed);
+        const std::int64_t top = _top.load(std::memory_order_acquire);
+        if (b - top >= static_cast<std::int64_t>(capacity))
+            return false;
+        _tasks[static_cast<std::size_t>(b) & (capacity - 1)].store(
+            t, std::memory_order_relaxed);
+        _bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    parallel_task* pop() {
+        const std::int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(b, std::memory_order_seq_cst);
+        std::int64_t t = _top.load(std::memory_order_seq_cst);
+        parallel_task* task = nullptr;
+        if (t <= b) {
+            task = _tasks[static_cast<std::size_t>(b) & (capacity - 1)]
+                .load(std::memory_order_relaxed);
+            if (t != b)
+                return task;
+            // The last task: race the thieves for it.
+            if (!_top.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+                task = nullptr;
+        }
+        _bottom.store(b + 1, std::memory_order_relaxed);
+        return task;
+    }
+
+    parallel_task* steal() {
+        std::int64_t t = _top.load(std::memory_order_seq_cst);
+        const std::int64_t b = _bottom.load(std::memory_order_seq_cst);
+        if (t >= b)
+            return nullptr;
+        parallel_task* const task =
+            _tasks[static_cast<std::size_t>(t) & (capacity - 1)]
+            .load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(t, t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+            return nullptr;
+        return task;
+    }
+
+private:
+    // Padding keeps the owner's index and the thieves' index on separate
+    // cache lines.
+    std::atomic<std::int64_t> _top;
+    char _pad[64];
+    std::atomic<std::int64_t> _bottom;
+    std::atomic<parallel_task*> _tasks[capacity];
+};
+
+// The pool and deque that the current thread is working for, if any.
+struct parallel_worker {
+    thread_pool* pool;
+    std::size_t index;
+};
+
+inline parallel_worker& current_parallel_worker() {
+    static thread_local parallel_worker worker = {nullptr, 0};
+    return worker;
+}
+
+}
+
+/// A fixed set of threads that run the pieces of `parallel_for` loops.
+///
+/// A pool with a concurrency of `n` starts `n - 1` threads, since the
+/// thread that starts a loop works on it too.  The threads sleep while no
+/// loop is running and spin (yielding) while looking for work during one.
+///
+/// Any number of threads may start loops on the same pool, but loops
+/// started from outside the pool run one at a time; loops started from
+/// within a piece of another loop (nested loops) run concurrently.
+class thread_pool {
+public:
+
+    /// Starts a pool of the given concurrency, which defaults to the number
+    /// of hardware threads.  A concurrency of 1 runs every loop serially on
+    /// the calling thread.
+    explicit thread_pool(std::size_t concurrency =
+                         std::thread::hardware_concurrency())
+        : _deques(concurrency ? concurrency : 1), _loops(0), _stop(false) {
+        for (std::size_t i = 1; i < _deques.size(); ++i)
+            _threads.emplace_back([this, i] { work(i); });
+    }
+
+    thread_pool(const thread_pool&) = delete;
+
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// Stops and joins the threads.  No loop may be running.
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (std::thread& t : _threads)
+            t.join();
+    }
+
+    /// Returns the number of threads that work on each loop, including the
+    /// calling thread.
+    std::size_t concurrency() const { return _deques.size(); }
+
+    /// Returns a pool shared by the whole program, with the default
+    /// concurrency.  It is created on first use.
+    static thread_pool& default_pool() {
+        static thread_pool pool;
+        return pool;
+    }
+
+private:
+    template<class Iterator, class F>
+    friend struct _priv::parallel_loop;
+
+    // Runs `root` as the outermost task of a loop, with the current thread
+    // taking the deque reserved for outside callers unless it already
+    // belongs to the pool.
+    void run_root(_priv::parallel_task& root) {
+        _priv::parallel_worker& self = _priv::current_parallel_worker();
+        if (self.pool == this) {
+            root.run(&root);
+            return;
+        }
+        std::lock_guard<std::mutex> outside(_outside);
+        const _priv::parallel_worker saved = self;
+        self.pool = this;
+        self.index = 0;
+        if (_deques.size() > 1) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                ++_loops;
+            }
+            _wake.notify_all();
+        }
+        root.run(&root);
+        if (_deques.size() > 1)
+            --_loops;
+        self = saved;
+    }
+
+    // Pushes `t` onto the deque of the current thread, returning false if
+    // there is no room.
+    bool push(_priv::parallel_task& t) {
+        return _deques[_priv::current_parallel_worker().index].push(&t);
+    }
+
+    // Waits for `t`, which the current thread pushed last, to finish:
+    // either by running it right away, if it is still in the deque, or else
+    // by helping with other work until the thief is done with it.
+    void join(_priv::parallel_task& t) {
+        const std::size_t index = _priv::current_parallel_worker().index;
+        if (_deques[index].pop() == &t) {
+            t.run(&t);
+            return;
+        }
+        while (!t.done.load(std::memory_order_acquire)) {
+            if (!run_one(index))
+                std::this_thread::yield();
+        }
+    }
+
+    // Runs a task from the deque of `index`, or else steals one, returning
+    // false if there was none.
+    bool run_one(std::size_t index) {
+        _priv::parallel_task* t = _deques[index].pop();
+        const std::size_t n = _deques.size();
+        std::size_t victim = index + random_offset(index);
+        for (std::size_t i = 0; !t && i != n; ++i, ++victim)
+            if (victim % n != index)
+                t = _deques[victim % n].steal();
+        if (!t)
+            return false;
+        t->run(t);
+        return true;
+    }
+
+    // A cheap per-thread random number for picking the first victim.
+    static std::size_t random_offset(std::size_t index) {
+        static thread_local std::uint32_t x = 0;
+        x = x * 1664525u + 1013904223u + static_cast<std::uint32_t>(index);
+        return x >> 16;
+    }
+
+    void work(std::size_t index) {
+        _priv::parallel_worker& self = _priv::current_parallel_worker();
+        self.pool = this;
+        self.index = index;
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (;;) {
+            _wake.wait(lock, [this] { return _stop || _loops.load() != 0; });
+            if (_stop)
+                return;
+            lock.unlock();
+            while (_loops.load(std::memory_order_acquire))
+                if (!run_one(index))
+                    std::this_thread::yield();
+            lock.lock();
+        }
+    }
+
+    std::vector<_priv::parallel_deque> _deques;
+    std::vector<std::thread> _threads;
+    std::mutex _outside;                // held by outside callers
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::atomic<unsigned> _loops;       // loops started from outside
+    bool _stop;
+};
+
+namespace _priv {
+
+// Splits and runs the pieces of one loop.
+template<class Iterator, class F>
+struct parallel_loop {
+    typedef typename std::iterator_traits<Iterator>::difference_type
+        difference_type;
+
+    parallel_loop(thread_pool& pool, const F& f, difference_type grain)
+        : pool(&pool), f(&f), grain(grain), failed(false) {}
+
+    // Runs the whole loop and rethrows the first exception, if any.
+    void run(Iterator first, Iterator last) {
+        piece root(this, first, last);
+        pool->run_root(root);
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    struct piece : _priv::parallel_task {
+        piece(parallel_loop* loop, Iterator first, Iterator last)
+            : loop(loop), first(first), last(last) {
+            run = &piece::execute;
+            done.store(false, std::memory_order_relaxed);
+        }
+
+        static void execute(_priv::parallel_task* t) {
+            piece& p = *static_cast<piece*>(t);
+            p.loop->split(p.first, p.last);
+            p.done.store(true, std::memory_order_release);
+        }
+
+        parallel_loop* loop;
+        Iterator first;
+        Iterator last;
+    };
+
+    void split(Iterator first, Iterator last) {
+        while (last - first > grain) {
+            const Iterator mid = first + (last - first) / 2;
+            piece right(this, mid, last);
+            if (!pool->push(right))
+                break;
+            split(first, mid);
+            pool->join(right);
+            return;
+        }
+        if (failed.load(std::memory_order_relaxed))
+            return;
+        try {
+            (*f)(iterator_range<Iterator>(first, last));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!failed.exchange(true))
+                error = std::current_exception();
+        }
+    }
+
+    thread_pool* pool;
+    const F* f;
+    difference_type grain;
+    std::atomic<bool> failed;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+}
+
+/// Calls `f` on disjoint sub-ranges (as `iterator_range`s) that together
+/// cover a random-access range, in parallel on a thread pool, and waits for
+/// all of them to finish.
+///
+/// `f` is called concurrently from several threads, so it must be safe to
+/// do so.  Receiving whole sub-ranges rather than single elements lets it
+/// run a tight (possibly vectorized) loop over each.
+///
+/// If `f` throws, the remaining pieces are skipped, and once the running
+/// ones have finished, the first exception is rethrown.
+///
+/// @param pool   The pool to run on.
+/// @param range  A range with random-access iterators, such as an
+///               `integer_range`, an `index_range`, or a container.
+/// @param f      The function to call on each sub-range.
+/// @param grain  The size below which sub-ranges are not split any further.
+///               By default, it is chosen so that each thread of the pool
+///               gets about 8 pieces, to balance uneven work.
+template<class Range, class F> inline
+void parallel_for(thread_pool& pool,
+                  Range&& range,
+                  const F& f,
+                  std::size_t grain = 0) {
+    using std::begin;
+    using std::end;
+    typedef decltype(begin(range)) iterator;
+    typedef typename std::iterator_traits<iterator>::difference_type
+        difference_type;
+    const iterator first = begin(range);
+    const iterator last = end(range);
+    if (first == last)
+        return;
+    const std::size_t n = static_cast<std::size_t>(last - first);
+    if (!grain)
+        grain = n / (8 * pool.concurrency());
+    _priv::parallel_loop<iterator, F>(
+        pool, f, static_cast<difference_type>(grain ? grain : 1)
+    ).run(first, last);
+}
+
+/// Calls `f` on disjoint sub-ranges of a random-access range in parallel on
+/// `thread_pool::default_pool()`.
+///
+/// @see parallel_for(thread_pool&, Range&&, const F&, std::size_t)
+template<class Range, class F> inline
+void parallel_for(Range&& range, const F& f, std::size_t grain = 0) {
+    parallel_for(thread_pool::default_pool(), std::forward<Range>(range), f,
+                 grain);
+}
+
+/// Calls `f` on each element of a random-access range in parallel on a
+/// thread pool, and waits for all of them to finish.  For an
+/// `integer_range`, the elements are the integers themselves.
+///
+/// @see parallel_for(thread_pool&, Range&&, const F&, std::size_t)
+template<class Range, class F> inline
+void parallel_for_each(thread_pool& pool,
+                       Range&& range,
+                       const F& f,
+                       std::size_t grain = 0) {
+    parallel_for(pool, std::forward<Range>(range), [&f](
+        const iterator_range<decltype(std::begin(range))>& piece) {
+        for (auto&& x : piece)
+            f(std::forward<decltype(x)>(x));
+    }, grain);
+}
+
+/// Calls `f` on each element of a random-access range in parallel on
+/// `thread_pool::default_pool()`.
+///
+/// @see parallel_for_each(thread_pool&, Range&&, const F&, std::size_t)
+template<class Range, class F> inline
+void parallel_for_each(Range&& range, const F& f, std::size_t grain = 0) {
+    parallel_for_each(thread_pool::default_pool(),
+                      std::forward<Range>(range), f, grain);
+}
+
+}
+#endif
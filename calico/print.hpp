@@ -0,0 +1,286 @@
+#ifndef RMZKWTQXGHDVNFBUAOYC
+#define RMZKWTQXGHDVNFBUAOYC
+/// @file
+///
+/// Formatted output written directly to file descriptors.
+///
+/// `print` formats with the same syntax as `format` (see `format.hpp`), but
+/// appends the output straight to a reusable buffer that is written to the
+/// file descriptor with as few system calls as possible, rather than
+/// building a temporary string and copying it into a stream.
+///
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include "format.hpp"
+#include "string.hpp"
+#ifdef _WIN32
+#   include <io.h>
+#else
+#   include <sys/uio.h>
+#   include <unistd.h>
+#endif
+namespace cal {
+
+/// When an `fd_writer` writes its buffer to the file descriptor.
+enum class print_flush {
+    /// Only when the buffer is full, when `flush` is called, and upon
+    /// destruction.
+    full,
+    /// Additionally after every `print` or `write` whose output contains a
+    /// newline.
+    line,
+    /// Additionally after every `print` or `write`.
+    always
+};
+
+namespace _priv {
+
+inline int file_descriptor(std::FILE* file) {
+#ifdef _WIN32
+    return _fileno(file);
+#else
+    return fileno(file);
+#endif
+}
+
+// Writes the entire range, retrying after partial writes and interruptions.
+inline void write_all(int fd, const char* p, std::size_t n) {
+    while (n) {
+#ifdef _WIN32
+        const int chunk = n > 0x40000000 ? 0x40000000 : static_cast<int>(n);
+        const int r = _write(fd, p, static_cast<unsigned>(chunk));
+#else
+        const ssize_t r = ::write(fd, p, n);
+#endif
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category(),
+                                    "cal::print: write failed");
+        }
+        p += r;
+        n -= static_cast<std::size_t>(r);
+    }
+}
+
+// Writes two ranges one after the other, with a single system call where
+// possible.
+inline void write_all(int fd,
+                      const char* p, std::size_t n,
+                      const char* q, std::size_t m) {
+#ifdef _WIN32
+    write_all(fd, p, n);
+    write_all(fd, q, m);
+#else
+    while (n) {
+        iovec iov[2] = {{const_cast<char*>(p), n}, {const_cast<char*>(q), m}};
+        const ssize_t r = ::writev(fd, iov, 2);
+        if (r < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::system_category(),
+                                    "cal::print: write failed");
+        }
+        std::size_t k = static_cast<std::size_t>(r);
+        if (k < n) {
+            p += k;
+            n -= k;
+            continue;
+        }
+        k -= n;
+        n = 0;
+        q += k;
+        m -= k;
+    }
+    write_all(fd, q, m);
+#endif
+}
+
+}
+
+/// A buffered writer for a file descriptor.
+///
+/// Output is formatted directly into an internal buffer, whose memory is
+/// reused for the lifetime of the writer, and written out in large blocks
+/// according to the `print_flush` policy.  Writes larger than the buffer
+/// bypass it: they are written together with any pending output using a
+/// single `writev` call.
+///
+/// The writer does not own the file descriptor.  Any output still in the
+/// buffer is written upon destruction, where errors are ignored; call
+/// `flush` first to detect them.
+class fd_writer {
+public:
+
+    /// Constructs a writer for a file descriptor.
+    ///
+    /// @param fd        The file descriptor, which must remain open for the
+    ///                  lifetime of the writer.
+    /// @param policy    When to write the buffer out.
+    /// @param capacity  The size of the buffer in bytes.
+    explicit fd_writer(int fd,
+                       print_flush policy = print_flush::full,
+                       std::size_t capacity = 65536)
+        : _fd(fd), _policy(policy), _capacity(capacity) {
+        _buf.reserve(capacity);
+    }
+
+    /// Constructs a writer for the file descriptor underlying a `FILE`,
+    /// after flushing the `FILE`.  The `FILE` must not be written to while
+    /// the writer has output pending.
+    ///
+    /// @see fd_writer(int, print_flush, std::size_t)
+    explicit fd_writer(std::FILE* file,
+                       print_flush policy = print_flush::full,
+                       std::size_t capacity = 65536)
+        : fd_writer((std::fflush(file), _priv::file_descriptor(file)),
+                    policy, capacity) {}
+
+    fd_writer(const fd_writer&) = delete;
+
+    fd_writer& operator=(const fd_writer&) = delete;
+
+    ~fd_writer() {
+        try {
+            flush();
+        } catch (const std::system_error&) {}
+    }
+
+    /// Returns the file descriptor.
+    int fd() const { return _fd; }
+
+    /// Returns the output that has not been written yet.
+    string_ref pending() const { return _buf; }
+
+    /// Formats the arguments as `format(format, args...)` would and writes
+    /// the result.
+    ///
+    /// @throws format_error       If the format string is malformed or does
+    ///                            not match the arguments.
+    /// @throws std::system_error  If writing fails.
+    template<class... Args>
+    void print(const char* format, const Args&... args) {
+        const std::size_t start = _buf.size();
+        try {
+            format_append(_buf, format, args...);
+        } catch (const format_error&) {
+            _buf.resize(start);
+            throw;
+        }
+        written(start);
+    }
+
+    /// Writes a sequence of characters.
+    ///
+    /// @throws std::system_error  If writing fails.
+    void write(string_ref s) {
+        if (s.size() >= _capacity) {
+            write_and_clear([&] {
+                _priv::write_all(_fd, _buf.data(), _buf.size(),
+                                 s.data(), s.size());
+            });
+            return;
+        }
+        const std::size_t start = _buf.size();
+        _buf.append(s.data(), s.size());
+        written(start);
+    }
+
+    /// Writes out the buffer.
+    ///
+    /// @throws std::system_error  If writing fails, in which case the
+    ///                            unwritten output is discarded.
+    void flush() {
+        if (_buf.empty())
+            return;
+        write_and_clear([&] {
+            _priv::write_all(_fd, _buf.data(), _buf.size());
+        });
+    }
+
+private:
+    // Calls `f` to write the buffer out and then empties it, even if `f`
+    // throws.
+    template<class F>
+    void write_and_clear(const F& f) {
+        try {
+            f();
+        } catch (...) {
+            _buf.clear();
+            throw;
+        }
+        _buf.clear();
+    }
+
+    void written(std::size_t start) {
+        if (_buf.size() >= _capacity
+            || _policy == print_flush::always
+            || (_policy == print_flush::line
+                && _buf.find('\n', start) != std::string::npos))
+            flush();
+    }
+
+    const int _fd;
+    const print_flush _policy;
+    const std::size_t _capacity;
+    std::string _buf;
+};
+
+namespace _priv {
+
+// A buffer reused by the unbuffered overloads of `print` on each thread.
+inline std::string& print_buffer() {
+    static thread_local std::string buf;
+    buf.clear();
+    return buf;
+}
+
+}
+
+/// Formats the arguments as `format(format, args...)` would and writes the
+/// result to a buffered writer.
+///
+/// @see fd_writer::print
+template<class... Args>
+void print(fd_writer& out, const char* format, const Args&... args) {
+    out.print(format, args...);
+}
+
+/// Formats the arguments as `format(format, args...)` would and writes the
+/// result to a file descriptor immediately with a single `write` call (or
+/// more if the write is partial).  The output is formatted into a
+/// per-thread buffer that is reused across calls.  To batch many calls into
+/// fewer system calls, use an `fd_writer`.
+///
+/// @throws format_error       If the format string is malformed or does not
+///                            match the arguments.
+/// @throws std::system_error  If writing fails.
+template<class... Args>
+void print(int fd, const char* format, const Args&... args) {
+    std::string& buf = _priv::print_buffer();
+    format_append(buf, format, args...);
+    _priv::write_all(fd, buf.data(), buf.size());
+}
+
+/// Formats the arguments as `format(format, args...)` would and writes the
+/// result to a `FILE` with a single `fwrite` call, so that it is subject to
+/// the buffering of the `FILE`.  The output is formatted into a per-thread
+/// buffer that is reused across calls.
+///
+/// @throws format_error       If the format string is malformed or does not
+///                            match the arguments.
+/// @throws std::system_error  If writing fails.
+template<class... Args>
+void print(std::FILE* file, const char* format, const Args&... args) {
+    std::string& buf = _priv::print_buffer();
+    format_append(buf, format, args...);
+    if (std::fwrite(buf.data(), 1, buf.size(), file) != buf.size())
+        throw std::system_error(errno, std::system_category(),
+                                "cal::print: fwrite failed");
+}
+
+}
+#endif
@@ -0,0 +1,890 @@
+#ifndef PXRWLGZKQJNTUFAMEYHB
+#define PXRWLGZKQJNTUFAMEYHB
+/// @file
+///
+/// Vectorized scanning routines used by the string utilities.
+///
+/// SSE2 is used whenever it is available (always the case on x86-64).  AVX2
+/// is used if the code is compiled with it enabled; otherwise, on x86 with
+/// GCC, Clang, or MSVC, the search kernels are compiled for AVX2 anyway and
+/// selected at run time if the processor supports it.  Other platforms fall
+/// back to scalar loops.
+///
+/// The vectorized length scans read whole aligned blocks, which may extend
+/// past the end of the array but never into the next page, so they cannot
+/// fault.  Since such reads are nonetheless flagged by AddressSanitizer, the
+/// affected functions opt out of it.  The search kernels are given explicit
+/// bounds and never read outside of them.
+///
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cwchar>
+#include <type_traits>
+#if defined(__AVX2__)
+#   define CALICO_SIMD_AVX2
+#endif
+#if defined(__SSE2__) || defined(_M_X64) \
+ || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define CALICO_SIMD_SSE2
+#endif
+#if !defined(CALICO_SIMD_AVX2) && defined(CALICO_SIMD_SSE2) \
+ && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#   define CALICO_SIMD_AVX2_DISPATCH
+#endif
+#if defined(CALICO_SIMD_AVX2) || defined(CALICO_SIMD_AVX2_DISPATCH)
+#   include <immintrin.h>
+#elif defined(CALICO_SIMD_SSE2)
+#   include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#   include <intrin.h>
+#endif
+#if defined(CALICO_SIMD_AVX2_DISPATCH) && !defined(_MSC_VER)
+#   define CALICO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#   define CALICO_TARGET_AVX2
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#   define CALICO_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#   define CALICO_NO_SANITIZE_ADDRESS
+#endif
+namespace cal {
+namespace _priv {
+
+// Returns the index of the lowest set bit of a nonzero integer.
+inline unsigned count_trailing_zeros(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(x));
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    unsigned n = 0;
+    for (; !(x & 1u); x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+inline unsigned count_trailing_zeros(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    const std::uint32_t lo = static_cast<std::uint32_t>(x);
+    return lo ? count_trailing_zeros(lo)
+              : 32 + count_trailing_zeros(static_cast<std::uint32_t>(x >> 32));
+#endif
+}
+
+// Returns the index of the highest set bit of a nonzero integer.
+inline unsigned floor_log2(std::uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - static_cast<unsigned>(__builtin_clz(x));
+#elif defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse(&i, x);
+    return static_cast<unsigned>(i);
+#else
+    unsigned n = 0;
+    while (x >>= 1)
+        ++n;
+    return n;
+#endif
+}
+
+// Whether the terminator of a null-terminated array of `T` can be found by
+// looking for an aligned run of zero bytes.
+template<class T, class U = typename std::remove_cv<T>::type>
+struct zero_scannable : std::integral_constant<bool,
+    (std::is_integral<U>::value || std::is_pointer<U>::value)
+    && (sizeof(U) == 1 || sizeof(U) == 2 || sizeof(U) == 4 || sizeof(U) == 8)
+    && std::alignment_of<U>::value == sizeof(U)> {};
+
+#ifdef CALICO_SIMD_SSE2
+
+// Each of these returns a mask in which bit `i * Size` is set if and only if
+// element `i` of the block is zero.
+
+template<std::size_t Size>
+inline std::uint32_t sse2_zero_mask(__m128i v);
+
+template<>
+inline std::uint32_t sse2_zero_mask<1>(__m128i v) {
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())));
+}
+
+template<>
+inline std::uint32_t sse2_zero_mask<2>(__m128i v) {
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_setzero_si128()))) & 0x5555u;
+}
+
+template<>
+inline std::uint32_t sse2_zero_mask<4>(__m128i v) {
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi32(v, _mm_setzero_si128()))) & 0x1111u;
+}
+
+// SSE2 lacks a 64-bit comparison, so both 32-bit halves must be zero.
+template<>
+inline std::uint32_t sse2_zero_mask<8>(__m128i v) {
+    const std::uint32_t m = static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi32(v, _mm_setzero_si128())));
+    return m & (m >> 4) & 0x0101u;
+}
+
+#endif
+#ifdef CALICO_SIMD_AVX2
+
+template<std::size_t Size>
+inline std::uint32_t avx2_zero_mask(__m256i v);
+
+template<>
+inline std::uint32_t avx2_zero_mask<1>(__m256i v) {
+    return static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_setzero_si256())));
+}
+
+template<>
+inline std::uint32_t avx2_zero_mask<2>(__m256i v) {
+    return static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi16(v, _mm256_setzero_si256())))
+        & 0x55555555u;
+}
+
+template<>
+inline std::uint32_t avx2_zero_mask<4>(__m256i v) {
+    return static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi32(v, _mm256_setzero_si256())))
+        & 0x11111111u;
+}
+
+template<>
+inline std::uint32_t avx2_zero_mask<8>(__m256i v) {
+    return static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi64(v, _mm256_setzero_si256())))
+        & 0x01010101u;
+}
+
+#endif
+
+// Counts the elements before the first zero element.  `p` must be aligned
+// to `sizeof(T)`.
+template<class T>
+CALICO_NO_SANITIZE_ADDRESS
+inline std::size_t simd_zero_length(const T* p) {
+#if defined(CALICO_SIMD_AVX2)
+    const std::size_t width = 32;
+#elif defined(CALICO_SIMD_SSE2)
+    const std::size_t width = 16;
+#else
+    std::size_t n = 0;
+    while (p[n] != T())
+        ++n;
+    return n;
+#endif
+#ifdef CALICO_SIMD_SSE2
+    const std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+    const std::uintptr_t offset = addr % width;
+    const char* block = reinterpret_cast<const char*>(addr - offset);
+#ifdef CALICO_SIMD_AVX2
+    std::uint32_t m = avx2_zero_mask<sizeof(T)>(
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(block)));
+#else
+    std::uint32_t m = sse2_zero_mask<sizeof(T)>(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(block)));
+#endif
+    // Ignore the elements before `p` in the first block.
+    m &= ~std::uint32_t() << offset;
+    while (!m) {
+        block += width;
+#ifdef CALICO_SIMD_AVX2
+        m = avx2_zero_mask<sizeof(T)>(
+            _mm256_load_si256(reinterpret_cast<const __m256i*>(block)));
+#else
+        m = sse2_zero_mask<sizeof(T)>(
+            _mm_load_si128(reinterpret_cast<const __m128i*>(block)));
+#endif
+    }
+    const char* last = block + count_trailing_zeros(m);
+    return static_cast<std::size_t>(
+        last - reinterpret_cast<const char*>(p)) / sizeof(T);
+#endif
+}
+
+// Element types that are zero-scannable, but might be misaligned.
+template<class T>
+inline std::size_t null_terminated_length(std::true_type, const T* p) {
+    if (reinterpret_cast<std::uintptr_t>(p) % sizeof(T)) {
+        std::size_t n = 0;
+        while (p[n] != T())
+            ++n;
+        return n;
+    }
+    return simd_zero_length(p);
+}
+
+// Any other type: compare against a default-constructed value.
+template<class T>
+inline std::size_t null_terminated_length(std::false_type, const T* p) {
+    const T zero = T();
+    std::size_t n = 0;
+    while (!(p[n] == zero))
+        ++n;
+    return n;
+}
+
+// Returns the number of elements in a null-terminated array.  The C library
+// is used for `char` and `wchar_t` since it is usually just as fast.
+template<class T>
+inline std::size_t null_terminated_length(const T* p) {
+    return null_terminated_length(zero_scannable<T>(), p);
+}
+
+inline std::size_t null_terminated_length(const char* p) {
+    return std::strlen(p);
+}
+
+inline std::size_t null_terminated_length(const wchar_t* p) {
+    return std::wcslen(p);
+}
+
+#ifdef CALICO_SIMD_AVX2_DISPATCH
+#ifdef _MSC_VER
+inline bool detect_avx2() {
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    // The OS must also save the YMM registers (OSXSAVE and AVX bits).
+    __cpuid(info, 1);
+    if ((info[2] & (3 << 27)) != (3 << 27) || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
+#endif
+
+// Whether the processor (and OS) support AVX2.
+inline bool cpu_has_avx2() {
+#ifdef _MSC_VER
+    static const bool result = detect_avx2();
+    return result;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+// A set of bytes prepared for repeated searching.
+//
+// Besides a bitmap, the set is stored as a list of up to 16 bytes (for
+// comparing against each byte in turn) and as a pair of nibble lookup tables
+// (for `pshufb`).  The tables are exact as long as there are at most 8
+// distinct high nibbles among the bytes, since each such nibble is assigned
+// one bit: a byte matches if the entries for its low and high nibbles share
+// a bit.
+struct byte_set {
+
+    byte_set(const char* chars, std::size_t n)
+        : size(), nibbles_exact(true) {
+        std::memset(bits, 0, sizeof(bits));
+        std::memset(bytes, 0, sizeof(bytes));
+        std::memset(lo, 0, sizeof(lo));
+        std::memset(hi, 0, sizeof(hi));
+        unsigned char nibble_bit[16] = {};
+        unsigned next_bit = 0;
+        for (std::size_t i = 0; i != n; ++i) {
+            const unsigned char c = static_cast<unsigned char>(chars[i]);
+            if (contains(c))
+                continue;
+            bits[c >> 5] |= std::uint32_t(1) << (c & 31u);
+            if (size < sizeof(bytes))
+                bytes[size] = c;
+            ++size;
+            const unsigned h = c >> 4u;
+            if (!nibble_bit[h]) {
+                if (next_bit == 8) {
+                    nibbles_exact = false;
+                    continue;
+                }
+                nibble_bit[h] = static_cast<unsigned char>(1u << next_bit++);
+            }
+            lo[c & 15u] = static_cast<unsigned char>(lo[c & 15u]
+                                                     | nibble_bit[h]);
+            hi[h] = static_cast<unsigned char>(hi[h] | nibble_bit[h]);
+        }
+    }
+
+    bool contains(unsigned char c) const {
+        return (bits[c >> 5] >> (c & 31u)) & 1u;
+    }
+
+    std::uint32_t bits[8];
+    unsigned char bytes[16];
+    unsigned char lo[16];
+    unsigned char hi[16];
+    std::size_t size;       // number of distinct bytes
+    bool nibbles_exact;     // whether `lo` and `hi` describe the whole set
+};
+
+// Finds the first byte whose membership in the set equals `member`.
+
+inline const char* scalar_find_set(const char* first,
+                                   const char* last,
+                                   const byte_set& set,
+                                   bool member) {
+    for (; first != last; ++first)
+        if (set.contains(static_cast<unsigned char>(*first)) == member)
+            break;
+    return first;
+}
+
+#ifdef CALICO_SIMD_SSE2
+
+// Requires `set.size <= 16`.
+inline const char* sse2_find_set(const char* first,
+                                 const char* last,
+                                 const byte_set& set,
+                                 bool member) {
+    __m128i needles[16];
+    for (std::size_t i = 0; i != set.size; ++i)
+        needles[i] = _mm_set1_epi8(static_cast<char>(set.bytes[i]));
+    const std::uint32_t flip = member ? 0u : 0xffffu;
+    for (; last - first >= 16; first += 16) {
+        const __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i eq = _mm_setzero_si128();
+        for (std::size_t i = 0; i != set.size; ++i)
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi8(v, needles[i]));
+        const std::uint32_t m =
+            static_cast<std::uint32_t>(_mm_movemask_epi8(eq)) ^ flip;
+        if (m)
+            return first + count_trailing_zeros(m);
+    }
+    return scalar_find_set(first, last, set, member);
+}
+
+// Requires `n >= 2`.
+inline const char* sse2_find_substring(const char* first,
+                                       const char* last,
+                                       const char* needle,
+                                       std::size_t n) {
+    const __m128i head = _mm_set1_epi8(needle[0]);
+    const __m128i tail = _mm_set1_epi8(needle[n - 1]);
+    for (; static_cast<std::size_t>(last - first) >= n - 1 + 16;
+         first += 16) {
+        const __m128i a =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        const __m128i b =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + n - 1));
+        std::uint32_t m = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, head), _mm_cmpeq_epi8(b, tail))));
+        for (; m; m &= m - 1) {
+            const char* p = first + count_trailing_zeros(m);
+            if (!std::memcmp(p + 1, needle + 1, n - 2))
+                return p;
+        }
+    }
+    return std::search(first, last, needle, needle + n);
+}
+
+#endif
+#if defined(CALICO_SIMD_AVX2) || defined(CALICO_SIMD_AVX2_DISPATCH)
+
+// Requires `set.nibbles_exact || set.size <= 16`.
+CALICO_TARGET_AVX2
+inline const char* avx2_find_set(const char* first,
+                                 const char* last,
+                                 const byte_set& set,
+                                 bool member) {
+    const std::uint32_t flip = member ? 0u : 0xffffffffu;
+    if (set.nibbles_exact) {
+        const __m256i lo = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.lo)));
+        const __m256i hi = _mm256_broadcastsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(set.hi)));
+        const __m256i low_nibble = _mm256_set1_epi8(0x0f);
+        for (; last - first >= 32; first += 32) {
+            const __m256i v =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            const __m256i r = _mm256_and_si256(
+                _mm256_shuffle_epi8(lo, _mm256_and_si256(v, low_nibble)),
+                _mm256_shuffle_epi8(hi, _mm256_and_si256(
+                    _mm256_srli_epi16(v, 4), low_nibble)));
+            const std::uint32_t m = ~static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(r, _mm256_setzero_si256()))) ^ flip;
+            if (m)
+                return first + count_trailing_zeros(m);
+        }
+    } else {
+        __m256i needles[16];
+        for (std::size_t i = 0; i != set.size; ++i)
+            needles[i] = _mm256_set1_epi8(static_cast<char>(set.bytes[i]));
+        for (; last - first >= 32; first += 32) {
+            const __m256i v =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            __m256i eq = _mm256_setzero_si256();
+            for (std::size_t i = 0; i != set.size; ++i)
+                eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(v, needles[i]));
+            const std::uint32_t m =
+                static_cast<std::uint32_t>(_mm256_movemask_epi8(eq)) ^ flip;
+            if (m)
+                return first + count_trailing_zeros(m);
+        }
+    }
+    return scalar_find_set(first, last, set, member);
+}
+
+// Requires `n >= 2`.
+CALICO_TARGET_AVX2
+inline const char* avx2_find_substring(const char* first,
+                                       const char* last,
+                                       const char* needle,
+                                       std::size_t n) {
+    const __m256i head = _mm256_set1_epi8(needle[0]);
+    const __m256i tail = _mm256_set1_epi8(needle[n - 1]);
+    for (; static_cast<std::size_t>(last - first) >= n - 1 + 32;
+         first += 32) {
+        const __m256i a =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        const __m256i b = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(first + n - 1));
+        std::uint32_t m = static_cast<std::uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, head),
+                             _mm256_cmpeq_epi8(b, tail))));
+        for (; m; m &= m - 1) {
+            const char* p = first + count_trailing_zeros(m);
+            if (!std::memcmp(p + 1, needle + 1, n - 2))
+                return p;
+        }
+    }
+    return std::search(first, last, needle, needle + n);
+}
+
+#endif
+
+// Returns a mask whose bit `i` is set if `p[i]` is either `a` or `b`, for
+// each `i` in `[0, 64)`.
+inline std::uint64_t match_mask64(const char* p, char a, char b) {
+    std::uint64_t m = 0;
+#ifdef CALICO_SIMD_SSE2
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    for (int i = 0; i != 4; ++i) {
+        const __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        m |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(
+                 _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, va),
+                                                _mm_cmpeq_epi8(v, vb)))))
+          << (16 * i);
+    }
+#else
+    for (int i = 0; i != 64; ++i)
+        m |= static_cast<std::uint64_t>(p[i] == a || p[i] == b) << i;
+#endif
+    return m;
+}
+
+// Returns the first occurrence of `c` in `[first, last)`, or `last`.  The C
+// library's `memchr` is already vectorized, so it is used directly.
+inline const char* find_byte(const char* first, const char* last, char c) {
+    if (first == last)
+        return last;
+    const void* p =
+        std::memchr(first, c, static_cast<std::size_t>(last - first));
+    return p ? static_cast<const char*>(p) : last;
+}
+
+// Returns the first byte in `[first, last)` whose membership in `set` equals
+// `member`, or `last`.
+inline const char* find_set(const char* first,
+                            const char* last,
+                            const byte_set& set,
+                            bool member) {
+#if defined(CALICO_SIMD_AVX2)
+    if (set.nibbles_exact || set.size <= 16)
+        return avx2_find_set(first, last, set, member);
+#elif defined(CALICO_SIMD_AVX2_DISPATCH)
+    if ((set.nibbles_exact || set.size <= 16) && cpu_has_avx2())
+        return avx2_find_set(first, last, set, member);
+#endif
+#ifdef CALICO_SIMD_SSE2
+    if (set.size <= 16)
+        return sse2_find_set(first, last, set, member);
+#endif
+    return scalar_find_set(first, last, set, member);
+}
+
+// Returns the first occurrence of `[needle, needle + n)` in `[first, last)`,
+// or `last`.
+inline const char* find_substring(const char* first,
+                                  const char* last,
+                                  const char* needle,
+                                  std::size_t n) {
+    if (n == 0)
+        return first;
+    if (n == 1)
+        return find_byte(first, last, *needle);
+    if (static_cast<std::size_t>(last - first) < n)
+        return last;
+#if defined(CALICO_SIMD_AVX2)
+    return avx2_find_substring(first, last, needle, n);
+#else
+#if defined(CALICO_SIMD_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+        return avx2_find_substring(first, last, needle, n);
+#endif
+#if defined(CALICO_SIMD_SSE2)
+    return sse2_find_substring(first, last, needle, n);
+#else
+    return std::search(first, last, needle, needle + n);
+#endif
+#endif
+}
+
+// A set of ASCII bytes consisting of the range `[lo, hi]` and the byte
+// `extra`, which is enough to describe the character classes of `<cctype>`
+// that the string utilities need.
+struct byte_class {
+    char lo;
+    char hi;
+    char extra;
+
+    bool contains(char c) const {
+        return static_cast<unsigned char>(c - lo)
+               <= static_cast<unsigned char>(hi - lo)
+            || c == extra;
+    }
+};
+
+// Whitespace as classified by `std::isspace` in the C locale.
+inline byte_class space_class() {
+    const byte_class k = {'\t', '\r', ' '};
+    return k;
+}
+
+inline byte_class digit_class() {
+    const byte_class k = {'0', '9', '0'};
+    return k;
+}
+
+// Returns `c` with its case toggled if it lies within `[lo, lo + 25]`,
+// where `lo` is either `'A'` or `'a'`.
+inline char toggle_case(char c, char lo) {
+    return static_cast<unsigned char>(c - lo) < 26
+         ? static_cast<char>(c ^ 0x20) : c;
+}
+
+// Returns a mask with 0x20 in each byte of `v` that lies within
+// `[lo, lo + 25]`, where `lo` is either `'A'` or `'a'`.  Since each byte is
+// masked to 7 bits before the additions, they never carry into the next
+// byte.
+inline std::uint64_t swar_case_mask(std::uint64_t v, char lo) {
+    const std::uint64_t ones = 0x0101010101010101u;
+    const std::uint64_t low7 = v & 0x7f7f7f7f7f7f7f7fu;
+    const std::uint64_t ge = low7 + (0x80u - static_cast<unsigned char>(lo))
+                                    * ones;
+    const std::uint64_t gt = low7 + (0x80u - 26u
+                                     - static_cast<unsigned char>(lo)) * ones;
+    return (ge & ~gt & ~v & 0x8080808080808080u) >> 2;
+}
+
+inline const char* scalar_find_class(const char* first,
+                                     const char* last,
+                                     const byte_class& k,
+                                     bool member) {
+    for (; first != last; ++first)
+        if (k.contains(*first) == member)
+            break;
+    return first;
+}
+
+inline const char* scalar_find_class_end(const char* first,
+                                         const char* last,
+                                         const byte_class& k,
+                                         bool member) {
+    for (; last != first; --last)
+        if (k.contains(last[-1]) == member)
+            break;
+    return last;
+}
+
+inline void scalar_convert_case(const char* first,
+                                const char* last,
+                                char* out,
+                                char lo) {
+    for (; first != last; ++first, ++out)
+        *out = toggle_case(*first, lo);
+}
+
+inline std::size_t scalar_mismatch_ignore_case(const char* a,
+                                               const char* b,
+                                               std::size_t n) {
+    std::size_t i = 0;
+    for (; i != n; ++i)
+        if (toggle_case(a[i], 'A') != toggle_case(b[i], 'A'))
+            break;
+    return i;
+}
+
+#ifdef CALICO_SIMD_SSE2
+
+// Sets each byte to all ones if it lies within `[lo, hi]` and to zero
+// otherwise.  Both bounds must be ASCII.
+inline __m128i sse2_in_range(__m128i v, char lo, char hi) {
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+        _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+inline std::uint32_t sse2_class_mask(__m128i v, const byte_class& k) {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_or_si128(
+        sse2_in_range(v, k.lo, k.hi),
+        _mm_cmpeq_epi8(v, _mm_set1_epi8(k.extra)))));
+}
+
+inline __m128i sse2_toggle_case(__m128i v, char lo) {
+    return _mm_xor_si128(v, _mm_and_si128(
+        sse2_in_range(v, lo, static_cast<char>(lo + 25)),
+        _mm_set1_epi8(0x20)));
+}
+
+inline const char* sse2_find_class(const char* first,
+                                   const char* last,
+                                   const byte_class& k,
+                                   bool member) {
+    const std::uint32_t flip = member ? 0u : 0xffffu;
+    for (; last - first >= 16; first += 16) {
+        const std::uint32_t m = sse2_class_mask(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), k)
+            ^ flip;
+        if (m)
+            return first + count_trailing_zeros(m);
+    }
+    return scalar_find_class(first, last, k, member);
+}
+
+inline const char* sse2_find_class_end(const char* first,
+                                       const char* last,
+                                       const byte_class& k,
+                                       bool member) {
+    const std::uint32_t flip = member ? 0u : 0xffffu;
+    for (; last - first >= 16; last -= 16) {
+        const std::uint32_t m = sse2_class_mask(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(last - 16)), k)
+            ^ flip;
+        if (m)
+            return last - 15 + floor_log2(m);
+    }
+    return scalar_find_class_end(first, last, k, member);
+}
+
+inline void sse2_convert_case(const char* first,
+                              const char* last,
+                              char* out,
+                              char lo) {
+    for (; last - first >= 16; first += 16, out += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), sse2_toggle_case(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), lo));
+    scalar_convert_case(first, last, out, lo);
+}
+
+inline std::size_t sse2_mismatch_ignore_case(const char* a,
+                                             const char* b,
+                                             std::size_t n) {
+    std::size_t i = 0;
+    for (; n - i >= 16; i += 16) {
+        const __m128i u = sse2_toggle_case(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), 'A');
+        const __m128i v = sse2_toggle_case(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)), 'A');
+        const std::uint32_t m = ~static_cast<std::uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(u, v))) & 0xffffu;
+        if (m)
+            return i + count_trailing_zeros(m);
+    }
+    return i + scalar_mismatch_ignore_case(a + i, b + i, n - i);
+}
+
+#endif
+#if defined(CALICO_SIMD_AVX2) || defined(CALICO_SIMD_AVX2_DISPATCH)
+
+CALICO_TARGET_AVX2
+inline __m256i avx2_in_range(__m256i v, char lo, char hi) {
+    return _mm256_and_si256(
+        _mm256_cmpgt_epi8(v, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), v));
+}
+
+CALICO_TARGET_AVX2
+inline std::uint32_t avx2_class_mask(__m256i v, const byte_class& k) {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(
+        avx2_in_range(v, k.lo, k.hi),
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8(k.extra)))));
+}
+
+CALICO_TARGET_AVX2
+inline __m256i avx2_toggle_case(__m256i v, char lo) {
+    return _mm256_xor_si256(v, _mm256_and_si256(
+        avx2_in_range(v, lo, static_cast<char>(lo + 25)),
+        _mm256_set1_epi8(0x20)));
+}
+
+CALICO_TARGET_AVX2
+inline const char* avx2_find_class(const char* first,
+                                   const char* last,
+                                   const byte_class& k,
+                                   bool member) {
+    const std::uint32_t flip = member ? 0u : 0xffffffffu;
+    for (; last - first >= 32; first += 32) {
+        const std::uint32_t m = avx2_class_mask(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), k)
+            ^ flip;
+        if (m)
+            return first + count_trailing_zeros(m);
+    }
+    return scalar_find_class(first, last, k, member);
+}
+
+CALICO_TARGET_AVX2
+inline const char* avx2_find_class_end(const char* first,
+                                       const char* last,
+                                       const byte_class& k,
+                                       bool member) {
+    const std::uint32_t flip = member ? 0u : 0xffffffffu;
+    for (; last - first >= 32; last -= 32) {
+        const std::uint32_t m = avx2_class_mask(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(last - 32)),
+            k) ^ flip;
+        if (m)
+            return last - 31 + floor_log2(m);
+    }
+    return scalar_find_class_end(first, last, k, member);
+}
+
+CALICO_TARGET_AVX2
+inline void avx2_convert_case(const char* first,
+                              const char* last,
+                              char* out,
+                              char lo) {
+    for (; last - first >= 32; first += 32, out += 32)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), avx2_toggle_case(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first)), lo));
+    scalar_convert_case(first, last, out, lo);
+}
+
+CALICO_TARGET_AVX2
+inline std::size_t avx2_mismatch_ignore_case(const char* a,
+                                             const char* b,
+                                             std::size_t n) {
+    std::size_t i = 0;
+    for (; n - i >= 32; i += 32) {
+        const __m256i u = avx2_toggle_case(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)), 'A');
+        const __m256i v = avx2_toggle_case(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)), 'A');
+        const std::uint32_t m = ~static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(u, v)));
+        if (m)
+            return i + count_trailing_zeros(m);
+    }
+    return i + scalar_mismatch_ignore_case(a + i, b + i, n - i);
+}
+
+#endif
+
+// Returns the first byte in `[first, last)` whose membership in `k` equals
+// `member`, or `last`.
+inline const char* find_class(const char* first,
+                              const char* last,
+                              const byte_class& k,
+                              bool member) {
+#if defined(CALICO_SIMD_AVX2)
+    return avx2_find_class(first, last, k, member);
+#else
+#if defined(CALICO_SIMD_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+        return avx2_find_class(first, last, k, member);
+#endif
+#if defined(CALICO_SIMD_SSE2)
+    return sse2_find_class(first, last, k, member);
+#else
+    return scalar_find_class(first, last, k, member);
+#endif
+#endif
+}
+
+// Returns one past the last byte in `[first, last)` whose membership in `k`
+// equals `member`, or `first`.
+inline const char* find_class_end(const char* first,
+                                  const char* last,
+                                  const byte_class& k,
+                                  bool member) {
+#if defined(CALICO_SIMD_AVX2)
+    return avx2_find_class_end(first, last, k, member);
+#else
+#if defined(CALICO_SIMD_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+        return avx2_find_class_end(first, last, k, member);
+#endif
+#if defined(CALICO_SIMD_SSE2)
+    return sse2_find_class_end(first, last, k, member);
+#else
+    return scalar_find_class_end(first, last, k, member);
+#endif
+#endif
+}
+
+// Copies `[first, last)` to `out`, which may equal `first`, toggling the
+// case of the bytes in `[lo, lo + 25]`, where `lo` is either `'A'` (to
+// convert to lowercase) or `'a'` (to convert to uppercase).
+inline void convert_case(const char* first,
+                         const char* last,
+                         char* out,
+                         char lo) {
+#if defined(CALICO_SIMD_AVX2)
+    avx2_convert_case(first, last, out, lo);
+#else
+#if defined(CALICO_SIMD_AVX2_DISPATCH)
+    if (cpu_has_avx2()) {
+        avx2_convert_case(first, last, out, lo);
+        return;
+    }
+#endif
+#if defined(CALICO_SIMD_SSE2)
+    sse2_convert_case(first, last, out, lo);
+#else
+    scalar_convert_case(first, last, out, lo);
+#endif
+#endif
+}
+
+// Returns the index of the first byte at which `a` and `b` differ when ASCII
+// letters are converted to lowercase, or `n` if there is none.
+inline std::size_t mismatch_ignore_case(const char* a,
+                                        const char* b,
+                                        std::size_t n) {
+#if defined(CALICO_SIMD_AVX2)
+    return avx2_mismatch_ignore_case(a, b, n);
+#else
+#if defined(CALICO_SIMD_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+        return avx2_mismatch_ignore_case(a, b, n);
+#endif
+#if defined(CALICO_SIMD_SSE2)
+    return sse2_mismatch_ignore_case(a, b, n);
+#else
+    return scalar_mismatch_ignore_case(a, b, n);
+#endif
+#endif
+}
+}
+}
+#endif
@@ -4,13 +4,25 @@
 ///
 /// Functions and types related to string-manipulation.
 ///
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iterator>
+#include <memory>
+#include <ostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
 #include <vector>
+#include "charconv.hpp"
+#include "iterator.hpp"
+#include "simd.hpp"
 #if __cplusplus < 201103L
 extern "C" int snprintf(char*, std::size_t, const char*, ...);
 #endif
@@ -38,24 +50,253 @@ inline std::string to_string(const char* s) { return s; }
 inline std::string to_string(char c) { return std::string(1, c); }
 
 namespace _priv {
-template<class T, class String>
-inline T parse(const String& s) {
+// Formats an arithmetic value on the stack so that only the resulting string
+// is allocated.
+template<class T>
+inline std::string to_string_via_chars(T x) {
+    char buf[32];
+    return std::string(buf, to_chars(buf, buf + sizeof(buf), x).ptr);
+}
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(short x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(unsigned short x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(int x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(unsigned x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(long x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(unsigned long x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(long long x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts an integer to its decimal representation.
+inline std::string to_string(unsigned long long x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts a floating-point number to a decimal representation with the
+/// fewest significant digits that round-trip, as written by `to_chars`.
+///
+/// @see to_chars(char*, char*, double)
+inline std::string to_string(float x) {
+    return _priv::to_string_via_chars(x);
+}
+
+/// Converts a floating-point number to a decimal representation with the
+/// fewest significant digits that round-trip, as written by `to_chars`.
+///
+/// @see to_chars(char*, char*, double)
+inline std::string to_string(double x) {
+    return _priv::to_string_via_chars(x);
+}
+
+namespace _priv {
+template<class T>
+inline void to_chars_append_impl(std::string& s, T x) {
+    char buf[32];
+    s.append(buf, to_chars(buf, buf + sizeof(buf), x).ptr);
+}
+}
+
+/// Appends the decimal representation of an integer to a string.  Unlike
+/// `s += to_string(value)`, no temporary string is created.
+template<class T> inline
+typename std::enable_if<std::is_integral<T>::value
+                        && !std::is_same<T, bool>::value
+                        && !std::is_same<T, char>::value>::type
+to_chars_append(std::string& s, T value) {
+    _priv::to_chars_append_impl(s, value);
+}
+
+/// Appends a character to a string, as `to_string` and `format` write it.
+inline void to_chars_append(std::string& s, char value) { s += value; }
+
+/// Appends a floating-point number to a string as written by `to_chars`,
+/// i.e. with the fewest significant digits that round-trip.
+///
+/// @see to_chars(char*, char*, double)
+inline void to_chars_append(std::string& s, float value) {
+    _priv::to_chars_append_impl(s, value);
+}
+
+/// Appends a floating-point number to a string as written by `to_chars`,
+/// i.e. with the fewest significant digits that round-trip.
+///
+/// @see to_chars(char*, char*, double)
+inline void to_chars_append(std::string& s, double value) {
+    _priv::to_chars_append_impl(s, value);
+}
+
+/// An `OutputIterator` that appends characters to the end of a string.
+///
+/// This is similar to `std::back_insert_iterator<std::string>`, except that
+/// functions that know about it (such as `format_to`) can append whole runs
+/// of characters at once via `str`.
+class string_appender {
+public:
+
+    /// Iterator category.
+    typedef std::output_iterator_tag iterator_category;
+
+    /// Value type.
+    typedef void value_type;
+
+    /// Difference type.
+    typedef std::ptrdiff_t difference_type;
+
+    /// Pointer type.
+    typedef void pointer;
+
+    /// Reference type.
+    typedef void reference;
+
+    /// Constructs an iterator that appends to `s`.
+    explicit string_appender(std::string& s) : _s(&s) {}
+
+    /// Returns the string being appended to.
+    std::string& str() const { return *_s; }
+
+    /// Appends a character.
+    string_appender& operator=(char c) {
+        _s->push_back(c);
+        return *this;
+    }
+
+    /// Returns the iterator itself.
+    string_appender& operator*() { return *this; }
+
+    /// Does nothing.
+    string_appender& operator++() { return *this; }
+
+    /// Does nothing.
+    string_appender& operator++(int) { return *this; }
+
+private:
+    std::string* _s;
+};
+
+namespace _priv {
+
+// Whether `T` is handled by `from_chars` rather than by streams.
+template<class T>
+struct has_from_chars : std::integral_constant<bool,
+    std::is_same<T, float>::value || std::is_same<T, double>::value
+    || (std::is_integral<T>::value
+        && !std::is_same<T, bool>::value
+        && !std::is_same<T, char>::value
+        && !std::is_same<T, signed char>::value
+        && !std::is_same<T, unsigned char>::value
+        && !std::is_same<T, wchar_t>::value
+        && !std::is_same<T, char16_t>::value
+        && !std::is_same<T, char32_t>::value)> {};
+
+inline bool is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Numbers: skip whitespace and a leading plus sign like `>>` does, then
+// defer to `from_chars`.
+template<class T>
+inline from_chars_result parse(std::true_type,
+                               const char* first,
+                               const char* last,
+                               T& value) {
+    const char* p = first;
+    while (p != last && is_space(*p))
+        ++p;
+    if (p != last && *p == '+' && p + 1 != last && p[1] != '-')
+        ++p;
+    from_chars_result r = from_chars(p, last, value);
+    if (r.ec == std::errc::invalid_argument)
+        r.ptr = first;
+    return r;
+}
+
+// Everything else goes through the stream extraction operator.
+template<class T>
+inline from_chars_result parse(std::false_type,
+                               const char* first,
+                               const char* last,
+                               T& value) {
+    std::istringstream stream(std::string(first, last));
     T x;
-    std::istringstream stream(s);
-    stream >> x;
-    return x;
+    if (!(stream >> x)) {
+        from_chars_result r = {first, std::errc::invalid_argument};
+        return r;
+    }
+    value = x;
+    from_chars_result r = {
+        stream.eof() ? last : first + static_cast<std::ptrdiff_t>(
+                                          stream.tellg()),
+        std::errc()
+    };
+    return r;
 }
+
 }
 
-/// Extracts an object of type `T` from a string using the stream extraction
-/// operator (`>>`).
+/// Extracts an object of type `T` from the beginning of `[first, last)` and
+/// reports where parsing stopped.
+///
+/// Integers and floating-point numbers are parsed with `from_chars` after
+/// skipping leading whitespace and an optional plus sign, so they never
+/// allocate or consult the locale.  Other types are extracted using the
+/// stream extraction operator (`>>`).
+///
+/// On failure, `value` is left unmodified and the `ec` member of the result
+/// is set to `std::errc::invalid_argument` or (for numbers that do not fit)
+/// `std::errc::result_out_of_range`.
 template<class T>
-inline T parse(const std::string& s) { _priv::parse<T>(s); }
+inline from_chars_result parse(const char* first, const char* last, T& value) {
+    return _priv::parse(_priv::has_from_chars<T>(), first, last, value);
+}
 
-/// Extracts an object of type `T` from a string using the stream extraction
-/// operator (`>>`).
+/// Extracts an object of type `T` from a string.  If there is no valid
+/// value, a value-initialized `T` is returned.
+///
+/// @see parse(const char*, const char*, T&)
 template<class T>
-inline T parse(const char* s) { _priv::parse<T>(s); }
+inline T parse(const std::string& s) {
+    T x = T();
+    parse(s.data(), s.data() + s.size(), x);
+    return x;
+}
+
+/// Extracts an object of type `T` from a null-terminated string.  If there
+/// is no valid value, a value-initialized `T` is returned.
+///
+/// @see parse(const char*, const char*, T&)
+template<class T>
+inline T parse(const char* s) {
+    T x = T();
+    parse(s, s + std::char_traits<char>::length(s), x);
+    return x;
+}
 
 //////////////////////////////////////////////////////////////////////////////
 // Null-terminated iterator
@@ -118,6 +359,12 @@ public:
     explicit null_terminated_iterator(pointer ptr, bool end = false)
         : _p(end ? 0 : ptr) {}
 
+    /// Returns the underlying pointer, which may be null if this is a
+    /// past-the-end iterator.
+    pointer base() const {
+        return _p;
+    }
+
     /// Dereferences the iterator.
     reference operator*() const {
         return *_p;
@@ -188,38 +435,1105 @@ inline null_terminated_iterator<T> null_terminated_end(T* ptr) {
     return null_terminated_iterator<T>(ptr, true);
 }
 
-/// Returns a formatted string similar to `sprintf` but without all the hassle
-/// of memory management.
+/// A random-access range over a null-terminated array.
+///
+/// The length of the array is determined once upon construction using a
+/// vectorized scan for the terminator where possible (see `simd.hpp`).
+/// Unlike `null_terminated_iterator`, the iterators are plain pointers, so
+/// `size` is O(1) and algorithms over the range are free to use random
+/// access or to vectorize.
+///
+/// The range is invalidated if the length of the array changes.
+///
+/// @tparam T  The element type of the array.  Must be `DefaultConstructible`
+///            and `EqualityComparable`.
+///
+/// @see null_terminated_iterator
+template<class T>
+class null_terminated_range
+    : public container_base<null_terminated_range<T>, T*, T*, std::size_t> {
+public:
+
+    /// Constructs a range from a pointer to the first element.  A null
+    /// pointer is treated as an empty array.
+    explicit null_terminated_range(T* ptr)
+        : _data(ptr), _size(ptr ? _priv::null_terminated_length(ptr) : 0) {}
+
+    /// Constructs a range that starts at the given iterator.
+    explicit null_terminated_range(const null_terminated_iterator<T>& first)
+        : null_terminated_range(first.base()) {}
+
+    /// Returns a pointer to the first element.
+    T* data() const { return _data; }
+
+    /// Returns the number of elements, excluding the terminator.
+    std::size_t size() const { return _size; }
+
+    /// Returns an iterator to the first element.
+    T* begin() const { return _data; }
+
+    /// Returns an iterator to the terminator.
+    T* end() const { return _data + _size; }
+
+    /// Accesses the element at a given index without bounds-checking.
+    T& operator[](std::size_t index) const { return _data[index]; }
+
+private:
+    T* _data;
+    std::size_t _size;
+};
+
+/// Returns a random-access range over a null-terminated array.
+///
+/// @param ptr   A pointer to the first element.
+///
+/// @see null_terminated_range
+template<class T>
+inline null_terminated_range<T> null_terminated(T* ptr) {
+    return null_terminated_range<T>(ptr);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// String reference
+
+/// A non-owning reference to a contiguous sequence of characters.
+///
+/// The characters are not copied, so they must outlive the reference.  Unlike
+/// a C string, the sequence need not be null-terminated, which allows
+/// substrings to be referred to without copying them.
+///
+/// @tparam Char    The character type.
+/// @tparam Traits  The character traits used for comparison and searching.
+template<class Char, class Traits = std::char_traits<Char> >
+class basic_string_ref
+    : public container_base<basic_string_ref<Char, Traits>,
+                            const Char*, const Char*, std::size_t> {
+public:
+
+    /// Character traits type.
+    typedef Traits traits_type;
+
+    /// Returned by the `find` functions if there is no match.
+    static const std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// Constructs an empty reference.
+    basic_string_ref() : _data(), _size() {}
+
+    /// Refers to a null-terminated string.
+    basic_string_ref(const Char* s) : _data(s), _size(Traits::length(s)) {}
+
+    /// Refers to the `n` characters starting at `s`.
+    basic_string_ref(const Char* s, std::size_t n) : _data(s), _size(n) {}
+
+    /// Refers to the contents of a string.
+    template<class Allocator>
+    basic_string_ref(const std::basic_string<Char, Traits, Allocator>& s)
+        : _data(s.data()), _size(s.size()) {}
+
+    /// Refers to the null-terminated string starting at the iterator.  A
+    /// past-the-end iterator results in an empty reference.
+    explicit basic_string_ref(const null_terminated_iterator<const Char>& i)
+        : _data(i.base()),
+          _size(i.base() ? _priv::null_terminated_length(i.base()) : 0) {}
+
+    /// Refers to the characters of a contiguous range.
+    basic_string_ref(const iterator_range<const Char*>& r)
+        : _data(r.first), _size(static_cast<std::size_t>(r.last - r.first)) {}
+
+    /// Refers to the characters of a contiguous mutable range.
+    basic_string_ref(const iterator_range<Char*>& r)
+        : _data(r.first), _size(static_cast<std::size_t>(r.last - r.first)) {}
+
+    /// Refers to the characters of a null-terminated range.
+    basic_string_ref(const null_terminated_range<const Char>& r)
+        : _data(r.data()), _size(r.size()) {}
+
+    /// Returns a pointer to the first character.
+    const Char* data() const { return _data; }
+
+    /// Returns the number of characters.
+    std::size_t size() const { return _size; }
+
+    /// Returns the number of characters.
+    std::size_t length() const { return _size; }
+
+    /// Returns an iterator to the first character.
+    const Char* begin() const { return _data; }
+
+    /// Returns an iterator past the last character.
+    const Char* end() const { return _data + _size; }
+
+    /// Accesses the character at a given index without bounds-checking.
+    const Char& operator[](std::size_t index) const { return _data[index]; }
+
+    /// Returns a reference to at most `n` characters starting at `pos`.
+    ///
+    /// @throws std::out_of_range  If `pos > size()`.
+    basic_string_ref substr(std::size_t pos, std::size_t n = npos) const {
+        if (pos > _size)
+            throw std::out_of_range("cal::basic_string_ref::substr");
+        return basic_string_ref(_data + pos, std::min(n, _size - pos));
+    }
+
+    /// Removes the first `n` characters, which must exist.
+    void remove_prefix(std::size_t n) {
+        _data += n;
+        _size -= n;
+    }
+
+    /// Removes the last `n` characters, which must exist.
+    void remove_suffix(std::size_t n) { _size -= n; }
+
+    /// Returns the index of the first occurrence of `c` at or after `pos`,
+    /// or `npos` if there is none.
+    std::size_t find(Char c, std::size_t pos = 0) const {
+        if (pos >= _size)
+            return npos;
+        const Char* p = Traits::find(_data + pos, _size - pos, c);
+        return p ? static_cast<std::size_t>(p - _data) : npos;
+    }
+
+    /// Returns the index of the first occurrence of `s` at or after `pos`,
+    /// or `npos` if there is none.
+    std::size_t find(basic_string_ref s, std::size_t pos = 0) const {
+        if (pos > _size || s._size > _size - pos)
+            return npos;
+        const Char* p = std::search(_data + pos, end(), s.begin(), s.end(),
+                                    Traits::eq);
+        return p == end() && s._size ? npos
+                                     : static_cast<std::size_t>(p - _data);
+    }
+
+    /// Returns whether the string begins with `s`.
+    bool starts_with(basic_string_ref s) const {
+        return _size >= s._size && !Traits::compare(_data, s._data, s._size);
+    }
+
+    /// Returns whether the string ends with `s`.
+    bool ends_with(basic_string_ref s) const {
+        return _size >= s._size
+            && !Traits::compare(end() - s._size, s._data, s._size);
+    }
+
+    /// Compares lexicographically.  Returns a negative value, zero, or a
+    /// positive value if this string is respectively less than, equal to, or
+    /// greater than `s`.
+    int compare(basic_string_ref s) const {
+        const int r = Traits::compare(_data, s._data,
+                                      std::min(_size, s._size));
+        return r ? r : _size < s._size ? -1 : _size > s._size ? 1 : 0;
+    }
+
+    /// Copies the characters into a new string.
+    std::basic_string<Char, Traits> str() const {
+        return std::basic_string<Char, Traits>(_data, _size);
+    }
+
+    /// Compares two strings for equality.
+    friend bool operator==(basic_string_ref a, basic_string_ref b) {
+        return a._size == b._size
+            && !Traits::compare(a._data, b._data, a._size);
+    }
+
+    /// Compares two strings for inequality.
+    friend bool operator!=(basic_string_ref a, basic_string_ref b) {
+        return !(a == b);
+    }
+
+    /// Compares two strings lexicographically.
+    friend bool operator<(basic_string_ref a, basic_string_ref b) {
+        return a.compare(b) < 0;
+    }
+
+    /// Compares two strings lexicographically.
+    friend bool operator>(basic_string_ref a, basic_string_ref b) {
+        return a.compare(b) > 0;
+    }
+
+    /// Compares two strings lexicographically.
+    friend bool operator<=(basic_string_ref a, basic_string_ref b) {
+        return a.compare(b) <= 0;
+    }
+
+    /// Compares two strings lexicographically.
+    friend bool operator>=(basic_string_ref a, basic_string_ref b) {
+        return a.compare(b) >= 0;
+    }
+
+    /// Writes the characters to a stream.
+    friend std::basic_ostream<Char, Traits>&
+    operator<<(std::basic_ostream<Char, Traits>& stream, basic_string_ref s) {
+        return stream.write(s._data, static_cast<std::streamsize>(s._size));
+    }
+
+private:
+    const Char* _data;
+    std::size_t _size;
+};
+
+template<class Char, class Traits>
+const std::size_t basic_string_ref<Char, Traits>::npos;
+
+/// A reference to a sequence of `char`s.
+typedef basic_string_ref<char> string_ref;
+
+/// A reference to a sequence of `wchar_t`s.
+typedef basic_string_ref<wchar_t> wstring_ref;
+
+/// Copies the referenced characters into a string.
+inline std::string to_string(string_ref s) { return s.str(); }
+
+/// Extracts an object of type `T` from a string, string reference, or C
+/// string and reports where parsing stopped.
+///
+/// @see parse(const char*, const char*, T&)
+template<class T>
+inline from_chars_result parse(string_ref s, T& value) {
+    return parse(s.begin(), s.end(), value);
+}
+
+/// Extracts an object of type `T` from a string reference.  If there is no
+/// valid value, a value-initialized `T` is returned.
+///
+/// @see parse(const char*, const char*, T&)
+template<class T>
+inline T parse(string_ref s) {
+    T x = T();
+    parse(s, x);
+    return x;
+}
+
+namespace _priv {
+
+struct identity_word {
+    std::uint64_t operator()(std::uint64_t v) const { return v; }
+};
+
+// A fast non-cryptographic hash of a byte string that consumes 8 bytes per
+// step, intended for hash tables keyed by short strings.  Each 8-byte word
+// (zero-padded at the end) is passed through `fold` before it is mixed in.
+template<class Fold>
+inline std::size_t hash_bytes(const char* p, std::size_t n, Fold fold) {
+    const std::uint64_t k = 0x9e3779b97f4a7c15u;
+    std::uint64_t h = n * k;
+    for (; n >= 8; p += 8, n -= 8) {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        h = (h ^ fold(v)) * k;
+        h ^= h >> 29;
+    }
+    if (n) {
+        std::uint64_t v = 0;
+        std::memcpy(&v, p, n);
+        h = (h ^ fold(v)) * k;
+        h ^= h >> 29;
+    }
+    h = (h ^ h >> 32) * k;
+    return static_cast<std::size_t>(h ^ h >> 29);
+}
+
+inline std::size_t hash_bytes(const char* p, std::size_t n) {
+    return hash_bytes(p, n, identity_word());
+}
+
+}
+
+namespace _priv {
+
+template<class Traits, class Char>
+inline const Char* split_find(const Char* first, const Char* last, Char c) {
+    if (first == last)
+        return last;
+    const Char* p = Traits::find(first, static_cast<std::size_t>(last - first),
+                                 c);
+    return p ? p : last;
+}
+
+template<class Traits, class Char>
+inline const Char* split_find(const Char* first,
+                              const Char* last,
+                              basic_string_ref<Char, Traits> delim) {
+    if (delim.empty())
+        return last;
+    return std::search(first, last, delim.begin(), delim.end(), Traits::eq);
+}
+
+template<class Char>
+inline std::size_t split_size(Char) { return 1; }
+
+template<class Char, class Traits>
+inline std::size_t split_size(basic_string_ref<Char, Traits> delim) {
+    return delim.size();
+}
+
+}
+
+/// An `InputIterator` over the pieces of a string between delimiters.
+///
+/// The pieces are references into the original string, so no allocations are
+/// made.  A default-constructed iterator is the past-the-end iterator.
+///
+/// @tparam Delimiter  Either `Char` or `basic_string_ref<Char, Traits>`.
+///
+/// @see split
+template<class Char, class Traits, class Delimiter>
+class split_iterator
+    : public input_iterator_base<split_iterator<Char, Traits, Delimiter>,
+                                 basic_string_ref<Char, Traits>,
+                                 basic_string_ref<Char, Traits> > {
+public:
+
+    /// Constructs a past-the-end iterator.
+    split_iterator()
+        : _first(), _last(), _token_end(), _delim(), _done(true) {}
+
+    /// Constructs an iterator to the first piece of `s`.
+    split_iterator(basic_string_ref<Char, Traits> s, const Delimiter& delim)
+        : _first(s.data()), _last(s.data() + s.size()), _delim(delim),
+          _done(false) {
+        _find();
+    }
+
+    /// Returns the current piece.
+    basic_string_ref<Char, Traits> operator*() const {
+        return basic_string_ref<Char, Traits>(
+            _first, static_cast<std::size_t>(_token_end - _first));
+    }
+
+    /// Advances to the next piece.
+    split_iterator& operator++() {
+        if (_token_end == _last) {
+            _done = true;
+        } else {
+            _first = _token_end + _priv::split_size(_delim);
+            _find();
+        }
+        return *this;
+    }
+
+    using input_iterator_base<split_iterator,
+                              basic_string_ref<Char, Traits>,
+                              basic_string_ref<Char, Traits> >::operator++;
+
+    /// Compares two iterators for equality.
+    bool operator==(const split_iterator& other) const {
+        return _done == other._done && (_done || _first == other._first);
+    }
+
+private:
+    void _find() {
+        _token_end = _priv::split_find<Traits>(_first, _last, _delim);
+    }
+
+    const Char* _first;
+    const Char* _last;
+    const Char* _token_end;
+    Delimiter _delim;
+    bool _done;
+};
+
+/// Returns a lazy range of the pieces of `s` separated by `delim`.
+///
+/// A string with `n` delimiters yields `n + 1` pieces, some of which may be
+/// empty.  Each piece is a reference into `s`.
+template<class Char, class Traits> inline
+iterator_range<split_iterator<Char, Traits, Char> >
+split(basic_string_ref<Char, Traits> s, Char delim) {
+    typedef split_iterator<Char, Traits, Char> iterator;
+    return make_range(iterator(s, delim), iterator());
+}
+
+/// Returns a lazy range of the pieces of `s` separated by the string
+/// `delim`.  An empty delimiter yields `s` as the only piece.
+///
+/// @see split(basic_string_ref<Char, Traits>, Char)
+template<class Char, class Traits> inline
+iterator_range<split_iterator<Char, Traits, basic_string_ref<Char, Traits> > >
+split(basic_string_ref<Char, Traits> s, basic_string_ref<Char, Traits> delim) {
+    typedef split_iterator<Char, Traits, basic_string_ref<Char, Traits> >
+        iterator;
+    return make_range(iterator(s, delim), iterator());
+}
+
+/// @see split(basic_string_ref<Char, Traits>, Char)
+inline iterator_range<split_iterator<char, std::char_traits<char>, char> >
+split(string_ref s, char delim) {
+    return split<char, std::char_traits<char> >(s, delim);
+}
+
+/// @see split(basic_string_ref<Char, Traits>, basic_string_ref<Char, Traits>)
+inline iterator_range<split_iterator<char, std::char_traits<char>,
+                                     string_ref> >
+split(string_ref s, string_ref delim) {
+    return split<char, std::char_traits<char> >(s, delim);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Searching
+//
+// These use the vectorized kernels in `simd.hpp`.  Each algorithm accepts
+// anything convertible to a `string_ref` (including `std::string` and
+// `iterator_range<const char*>`) and returns a pointer to the match, or the
+// end of the range if there is none.  The overloads for
+// `null_terminated_iterator` return a `null_terminated_iterator` to the match
+// or a past-the-end iterator.
+
+/// Returns a pointer to the first occurrence of `c` in `s`.
+inline const char* find(string_ref s, char c) {
+    return _priv::find_byte(s.begin(), s.end(), c);
+}
+
+/// Returns a pointer to the first character of `s` that appears in `set`.
+inline const char* find_first_of(string_ref s, string_ref set) {
+    return _priv::find_set(s.begin(), s.end(),
+                           _priv::byte_set(set.data(), set.size()), true);
+}
+
+/// Returns a pointer to the first character of `s` that does not appear in
+/// `set`.
+inline const char* find_first_not_of(string_ref s, string_ref set) {
+    return _priv::find_set(s.begin(), s.end(),
+                           _priv::byte_set(set.data(), set.size()), false);
+}
+
+/// Returns a pointer to the first occurrence of `needle` in `s`.
+inline const char* search(string_ref s, string_ref needle) {
+    return _priv::find_substring(s.begin(), s.end(),
+                                 needle.data(), needle.size());
+}
+
+/// @see find(string_ref, char)
+inline null_terminated_iterator<const char>
+find(const null_terminated_iterator<const char>& first, char c) {
+    return null_terminated_iterator<const char>(
+        find(string_ref(first), c));
+}
+
+/// @see find_first_of(string_ref, string_ref)
+inline null_terminated_iterator<const char>
+find_first_of(const null_terminated_iterator<const char>& first,
+              string_ref set) {
+    return null_terminated_iterator<const char>(
+        find_first_of(string_ref(first), set));
+}
+
+/// @see find_first_not_of(string_ref, string_ref)
+inline null_terminated_iterator<const char>
+find_first_not_of(const null_terminated_iterator<const char>& first,
+                  string_ref set) {
+    return null_terminated_iterator<const char>(
+        find_first_not_of(string_ref(first), set));
+}
+
+/// @see search(string_ref, string_ref)
+inline null_terminated_iterator<const char>
+search(const null_terminated_iterator<const char>& first, string_ref needle) {
+    return null_terminated_iterator<const char>(
+        search(string_ref(first), needle));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ASCII case and classification
+//
+// These only treat ASCII letters, digits, and whitespace specially and leave
+// every other byte alone, so they are safe to use on UTF-8.  Like the
+// searching algorithms, they use the vectorized kernels in `simd.hpp`.
+// Whitespace means the characters classified by `std::isspace` in the C
+// locale.  The in-place variants accept either an `std::string` or an
+// `iterator_range<char*>` and return their argument.
+
+/// Converts the ASCII letters of a string to lowercase in place.
+inline std::string& to_lower_in_place(std::string& s) {
+    char* const p = &s[0];
+    _priv::convert_case(p, p + s.size(), p, 'A');
+    return s;
+}
+
+/// @see to_lower_in_place(std::string&)
+inline iterator_range<char*> to_lower_in_place(iterator_range<char*> r) {
+    _priv::convert_case(r.first, r.last, r.first, 'A');
+    return r;
+}
+
+/// Converts the ASCII letters of a string to uppercase in place.
+inline std::string& to_upper_in_place(std::string& s) {
+    char* const p = &s[0];
+    _priv::convert_case(p, p + s.size(), p, 'a');
+    return s;
+}
+
+/// @see to_upper_in_place(std::string&)
+inline iterator_range<char*> to_upper_in_place(iterator_range<char*> r) {
+    _priv::convert_case(r.first, r.last, r.first, 'a');
+    return r;
+}
+
+/// Returns a copy of a string with its ASCII letters converted to
+/// lowercase.
+inline std::string to_lower(string_ref s) {
+    std::string r(s.size(), '\0');
+    _priv::convert_case(s.begin(), s.end(), &r[0], 'A');
+    return r;
+}
+
+/// Returns a copy of a string with its ASCII letters converted to
+/// uppercase.
+inline std::string to_upper(string_ref s) {
+    std::string r(s.size(), '\0');
+    _priv::convert_case(s.begin(), s.end(), &r[0], 'a');
+    return r;
+}
+
+/// Returns a reference to a string without its leading whitespace.
+inline string_ref trim_left(string_ref s) {
+    const char* const p = _priv::find_class(s.begin(), s.end(),
+                                            _priv::space_class(), false);
+    return string_ref(p, static_cast<std::size_t>(s.end() - p));
+}
+
+/// Returns a reference to a string without its trailing whitespace.
+inline string_ref trim_right(string_ref s) {
+    const char* const p = _priv::find_class_end(s.begin(), s.end(),
+                                                _priv::space_class(), false);
+    return string_ref(s.begin(), static_cast<std::size_t>(p - s.begin()));
+}
+
+/// Returns a reference to a string without its leading and trailing
+/// whitespace.
+inline string_ref trim(string_ref s) { return trim_right(trim_left(s)); }
+
+/// Returns the subrange without the leading and trailing whitespace.
+inline iterator_range<char*> trim(iterator_range<char*> r) {
+    const string_ref t = trim(string_ref(r));
+    return make_range(r.first + (t.begin() - r.first),
+                      r.first + (t.end() - r.first));
+}
+
+/// Removes the leading and trailing whitespace of a string in place.
+inline std::string& trim_in_place(std::string& s) {
+    const string_ref t = trim(string_ref(s));
+    s.erase(static_cast<std::size_t>(t.end() - s.data()));
+    s.erase(0, static_cast<std::size_t>(t.begin() - s.data()));
+    return s;
+}
+
+/// Returns whether a string consists entirely of whitespace.  An empty
+/// string does.
+inline bool is_all_space(string_ref s) {
+    return _priv::find_class(s.begin(), s.end(),
+                             _priv::space_class(), false) == s.end();
+}
+
+/// Returns whether a string consists entirely of the digits `0` to `9`.  An
+/// empty string does.
+inline bool is_all_digits(string_ref s) {
+    return _priv::find_class(s.begin(), s.end(),
+                             _priv::digit_class(), false) == s.end();
+}
+
+/// Compares two strings lexicographically as if their ASCII letters were
+/// converted to lowercase.
+///
+/// @return A negative number, zero, or a positive number if `a` is less
+///         than, equal to, or greater than `b` respectively.
+inline int compare_ignore_case(string_ref a, string_ref b) {
+    const std::size_t n = std::min(a.size(), b.size());
+    const std::size_t i = _priv::mismatch_ignore_case(a.data(), b.data(), n);
+    if (i != n)
+        return static_cast<unsigned char>(_priv::toggle_case(a[i], 'A'))
+             - static_cast<unsigned char>(_priv::toggle_case(b[i], 'A'));
+    return a.size() < b.size() ? -1 : a.size() > b.size() ? 1 : 0;
+}
+
+/// Returns whether two strings are equal apart from the case of their ASCII
+/// letters.
+inline bool equal_ignore_case(string_ref a, string_ref b) {
+    return a.size() == b.size()
+        && _priv::mismatch_ignore_case(a.data(), b.data(), a.size())
+           == a.size();
+}
+
+namespace _priv {
+
+struct lower_word {
+    std::uint64_t operator()(std::uint64_t v) const {
+        return v | swar_case_mask(v, 'A');
+    }
+};
+
+}
+
+/// Hashes a string as if its ASCII letters were converted to lowercase,
+/// without copying it, so strings that are equal according to
+/// `equal_ignore_case` have equal hashes.
+inline std::size_t hash_ignore_case(string_ref s) {
+    return _priv::hash_bytes(s.data(), s.size(), _priv::lower_word());
+}
+
+/// A function object that calls `hash_ignore_case`.  Together with
+/// `ignore_case_equal`, it makes the keys of an unordered container
+/// case-insensitive.
+struct ignore_case_hash {
+    /// Returns `hash_ignore_case(s)`.
+    std::size_t operator()(string_ref s) const { return hash_ignore_case(s); }
+};
+
+/// A function object that calls `equal_ignore_case`.
+struct ignore_case_equal {
+    /// Returns `equal_ignore_case(a, b)`.
+    bool operator()(string_ref a, string_ref b) const {
+        return equal_ignore_case(a, b);
+    }
+};
+
+/// A function object that orders strings by `compare_ignore_case`.
+struct ignore_case_less {
+    /// Returns `compare_ignore_case(a, b) < 0`.
+    bool operator()(string_ref a, string_ref b) const {
+        return compare_ignore_case(a, b) < 0;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// Concatenation
+
+namespace _priv {
+
+// An argument of `concat` whose length is known before it is written.
+// Integers are only measured up front and later written straight into the
+// destination; floating-point numbers and characters are kept in a small
+// buffer.
+class concat_piece {
+public:
+
+    concat_piece(string_ref s)
+        : _kind(chars), _negative(), _data(s.data()), _size(s.size()),
+          _value() {}
+
+    concat_piece(const null_terminated_iterator<const char>& i)
+        : concat_piece(string_ref(i)) {}
+
+    concat_piece(const null_terminated_iterator<char>& i)
+        : concat_piece(null_terminated_iterator<const char>(i.base())) {}
+
+    concat_piece(char c)
+        : _kind(buffered), _negative(), _data(), _size(1), _value() {
+        _buf[0] = c;
+    }
+
+    template<class T>
+    concat_piece(T x, typename std::enable_if<
+                     std::is_integral<T>::value
+                     && !std::is_same<T, bool>::value
+                     && !std::is_same<T, char>::value>::type* = 0)
+        : _kind(integer), _negative(x < T()), _data(),
+          _value(static_cast<unsigned long long>(x)) {
+        if (_negative)
+            _value = 0 - _value;
+        _size = static_cast<std::size_t>(_negative + decimal_length(_value));
+    }
+
+    concat_piece(float x)
+        : _kind(buffered), _negative(), _data(), _value() { format(x); }
+
+    concat_piece(double x)
+        : _kind(buffered), _negative(), _data(), _value() { format(x); }
+
+    // Without this, both would be ambiguous between the overloads above.
+    template<class T>
+    concat_piece(T, typename std::enable_if<
+                     std::is_same<T, bool>::value
+                     || std::is_same<T, long double>::value>::type* = 0) {
+        static_assert(!std::is_same<T, T>::value,
+                      "concat: bool and long double are not supported");
+    }
+
+    std::size_t size() const { return _size; }
+
+    // If the characters lie within `[first, last)`, moves them to the same
+    // offset relative to `to`.  Used when the referenced string is about to
+    // be reallocated.
+    void rebase(const char* first, const char* last, const char* to) {
+        const std::less<const char*> less;
+        if (_kind == chars && _size && !less(_data, first)
+            && less(_data, last))
+            _data = to + (_data - first);
+    }
+
+    // Writes the characters to `p` and returns the end of the output.
+    char* write(char* p) const {
+        switch (_kind) {
+        case chars:
+            std::char_traits<char>::copy(p, _data, _size);
+            break;
+        case buffered:
+            std::char_traits<char>::copy(p, _buf, _size);
+            break;
+        case integer:
+            if (_negative)
+                *p = '-';
+            write_digits_backward(p + _size, _value);
+            break;
+        }
+        return p + _size;
+    }
+
+private:
+
+    template<class T>
+    void format(T x) {
+        _size = static_cast<std::size_t>(
+            to_chars(_buf, _buf + sizeof(_buf), x).ptr - _buf);
+    }
+
+    enum { chars, buffered, integer } _kind;
+    bool _negative;
+    const char* _data;
+    std::size_t _size;
+    unsigned long long _value;
+    char _buf[32];
+};
+
+}
+
+/// Appends the concatenation of the arguments to `s`.
+///
+/// Each argument may be anything convertible to a `string_ref` (such as an
+/// `std::string`, a C string, an `inline_string`, or a pointer and a length
+/// given as `string_ref(p, n)`), a `null_terminated_iterator`, a `char`, or
+/// a number other than `bool`.  Numbers are written in the same way as
+/// `to_chars`.
+///
+/// Unlike a chain of `+=`s, the exact length of the output is computed
+/// first, so the string is grown by at most one allocation and no
+/// intermediate strings are built.  The arguments may refer to `s` itself.
+///
+/// @return `s`
+template<class ...T>
+std::string& append(std::string& s, const T&... args) {
+    _priv::concat_piece pieces[] = {
+        _priv::concat_piece(args)..., _priv::concat_piece(string_ref())
+    };
+    std::size_t n = 0;
+    for (const _priv::concat_piece& piece : pieces)
+        n += piece.size();
+    const std::size_t old_size = s.size();
+    const char* const old_data = s.data();
+    s.resize(old_size + n);
+    for (_priv::concat_piece& piece : pieces)
+        piece.rebase(old_data, old_data + old_size, s.data());
+    char* p = &s[0] + old_size;
+    for (const _priv::concat_piece& piece : pieces)
+        p = piece.write(p);
+    return s;
+}
+
+/// Concatenates the arguments into a new string with a single allocation.
+///
+/// Example: `concat("id=", 42, ' ', name)`.
+///
+/// @see append(std::string&, const T&...)
+template<class ...T>
+std::string concat(const T&... args) {
+    std::string s;
+    append(s, args...);
+    return s;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Tokenizer
+
+class token_range;
+
+/// An `InputIterator` over the tokens of a `token_range`.
+class token_iterator
+    : public input_iterator_base<token_iterator, string_ref, string_ref> {
+public:
+
+    /// Constructs a past-the-end iterator.
+    token_iterator() : _first(), _last(), _token_end(), _delims() {}
+
+    /// Returns the current token.
+    string_ref operator*() const {
+        return string_ref(_first,
+                          static_cast<std::size_t>(_token_end - _first));
+    }
+
+    /// Advances to the next token.
+    token_iterator& operator++() {
+        _seek(_token_end);
+        return *this;
+    }
+
+    using input_iterator_base<token_iterator,
+                              string_ref,
+                              string_ref>::operator++;
+
+    /// Compares two iterators for equality.
+    bool operator==(const token_iterator& other) const {
+        return _first == other._first;
+    }
+
+private:
+    friend class token_range;
+
+    token_iterator(string_ref s, const _priv::byte_set& delims)
+        : _last(s.end()), _delims(&delims) {
+        _seek(s.begin());
+    }
+
+    // Skips the delimiters at `p` and finds the end of the following token.
+    // If there are no tokens left, the iterator becomes past-the-end.
+    void _seek(const char* p) {
+        _first = _priv::find_set(p, _last, *_delims, false);
+        if (_first == _last) {
+            _first = 0;
+            return;
+        }
+        _token_end = _priv::find_set(_first, _last, *_delims, true);
+    }
+
+    const char* _first;
+    const char* _last;
+    const char* _token_end;
+    const _priv::byte_set* _delims;
+};
+
+/// A lazy range over the tokens of a string, which are the maximal
+/// non-empty runs of characters that are not delimiters.
+///
+/// Unlike `split`, consecutive delimiters are treated as one and no empty
+/// tokens are produced.  The delimiters are preprocessed once, after which
+/// each token is found by vectorized scans rather than by testing each
+/// character.  Iterators refer to the range, so the range must outlive
+/// them.
+///
+/// @see tokenize
+class token_range : public container_base<token_range, token_iterator> {
+public:
+
+    /// Constructs a range over the tokens in `s` separated by any of the
+    /// characters in `delims`.
+    token_range(string_ref s, string_ref delims)
+        : _s(s), _delims(delims.data(), delims.size()) {}
+
+    /// Returns an iterator to the first token.
+    token_iterator begin() const { return token_iterator(_s, _delims); }
+
+    /// Returns a past-the-end iterator.
+    token_iterator end() const { return token_iterator(); }
+
+private:
+    string_ref _s;
+    _priv::byte_set _delims;
+};
+
+/// Returns a lazy range of the tokens in `s` separated by any of the
+/// characters in `delims`.
+///
+/// @see token_range
+inline token_range tokenize(string_ref s, string_ref delims) {
+    return token_range(s, delims);
+}
+
+/// Formats a string similar to `sprintf` into `s`, replacing its contents.
+///
+/// Output shorter than 256 characters is formatted in a single pass into a
+/// stack buffer and then copied into `s`, reusing its existing capacity.
+/// Reusing the same `s` across calls therefore avoids allocations for short
+/// output.  Longer output requires a second pass into a new string, which
+/// then replaces `s`, so the arguments may refer to `s` itself.
 ///
 /// **Warning:** Failing to provide sufficient arguments or arguments of the
 /// right type will result in undefined behavior since this function is built
 /// on top of `snprintf`.
 template<class ...T>
-std::string format_str(const char* format, T&&... t) {
+void format_str_to(std::string& s, const char* format, T&&... t) {
     using namespace std;
+    char buf[256];
+    int n = snprintf(buf, sizeof(buf), format, t...);
+    if (n < 0)
+        throw runtime_error("cal::format_str: snprintf failed");
+    const size_t len = static_cast<size_t>(n);
+    if (len < sizeof(buf)) {
+        s.assign(buf, len);
+        return;
+    }
     // Since "modifying" the last terminating null character may be undefined
     // behavior, we're going to start off with an extra character and the
     // remove it later.  See: http://stackoverflow.com/questions/12740403
-    int n = snprintf(0, 0, format, forward<T>(t)...) + 1;
-    if (n <= 0)
-        throw runtime_error("cal::format_str: 1st snprintf failed");
-    string s(n, 0);
-    n = snprintf(&s[0], static_cast<std::size_t>(n), format, forward<T>(t)...);
+    string out(len + 1, '\0');
+    n = snprintf(&out[0], len + 1, format, t...);
     if (n < 0)
         throw runtime_error("cal::format_str: 2nd snprintf failed");
-    s.resize(static_cast<size_t>(n));
+    out.resize(len);
+    s.swap(out);
+}
+
+/// Returns a formatted string similar to `sprintf` but without all the hassle
+/// of memory management.
+///
+/// **Warning:** Failing to provide sufficient arguments or arguments of the
+/// right type will result in undefined behavior since this function is built
+/// on top of `snprintf`.  See `cal::format` for a type-safe alternative.
+///
+/// @see format_str_to
+template<class ...T>
+std::string format_str(const char* format, T&&... t) {
+    std::string s;
+    format_str_to(s, format, std::forward<T>(t)...);
     return s;
 }
 
 /// Returns a copy of the given `string` as a `vector` of characters.
 ///
 /// This function can be used to obtain a copy of the `string`'s character
-/// buffer.
+/// buffer.  To obtain a mutable buffer without copying, move the string
+/// into a `char_buffer` instead.
 template<class T>
 std::vector<T> str_to_vector(const std::basic_string<T>& s) {
     const T* begin = s.c_str();
     return std::vector<T>(begin, begin + s.size() + 1);
 }
 
+/// An owning, mutable, null-terminated buffer of characters, intended for
+/// passing to C APIs that expect a `char*`.
+///
+/// The storage is either an `std::string` or a raw allocation adopted
+/// together with the function that frees it.  Adopting either one does not
+/// copy the characters, and `release` hands a string back without copying
+/// if the buffer was created from one.  The buffer can be moved but not
+/// copied.
+///
+/// The character at `data()[size()]` is always a null terminator, which
+/// must not be overwritten.
+class char_buffer
+    : public container_base<char_buffer, const char*, char*, std::size_t> {
+public:
+
+    /// Constructs an empty buffer.
+    char_buffer() : _raw(), _raw_size(), _deallocate() {}
+
+    /// Constructs a buffer of `n` copies of `c`.
+    explicit char_buffer(std::size_t n, char c = '\0')
+        : _str(n, c), _raw(), _raw_size(), _deallocate() {}
+
+    /// Copies a sequence of characters.
+    explicit char_buffer(string_ref s)
+        : _str(s.str()), _raw(), _raw_size(), _deallocate() {}
+
+    /// Takes over the storage of a string without copying it.
+    char_buffer(std::string&& s)
+        : _str(std::move(s)), _raw(), _raw_size(), _deallocate() {}
+
+    /// Takes ownership of an array allocated with `new[]`, which must have
+    /// room for at least `size + 1` characters.  A terminator is written at
+    /// index `size`.
+    char_buffer(std::unique_ptr<char[]> p, std::size_t size)
+        : _raw(), _raw_size(), _deallocate() {
+        adopt(p.get(), size, &delete_array);
+        p.release();
+    }
+
+    /// Takes ownership of an array of at least `size + 1` characters that is
+    /// to be freed by calling `deallocate` (such as `std::free` for memory
+    /// obtained from `std::malloc`).  A terminator is written at index
+    /// `size`.
+    char_buffer(char* p, std::size_t size, void (*deallocate)(void*))
+        : _raw(), _raw_size(), _deallocate() {
+        adopt(p, size, deallocate);
+    }
+
+    char_buffer(const char_buffer&) = delete;
+
+    char_buffer& operator=(const char_buffer&) = delete;
+
+    /// Moves the storage out of another buffer, leaving it empty.
+    char_buffer(char_buffer&& other)
+        : _str(std::move(other._str)),
+          _raw(other._raw),
+          _raw_size(other._raw_size),
+          _deallocate(other._deallocate) {
+        other._str.clear();
+        other._raw = nullptr;
+        other._raw_size = 0;
+    }
+
+    /// Replaces the storage with that of another buffer, leaving it empty.
+    char_buffer& operator=(char_buffer&& other) {
+        char_buffer(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~char_buffer() {
+        if (_raw)
+            _deallocate(_raw);
+    }
+
+    /// Returns a pointer to the first character.
+    char* data() { return _raw ? _raw : &_str[0]; }
+
+    /// Returns a pointer to the first character.
+    const char* data() const { return _raw ? _raw : _str.data(); }
+
+    /// Returns a pointer to the null-terminated characters.
+    const char* c_str() const { return data(); }
+
+    /// Returns the number of characters, excluding the terminator.
+    std::size_t size() const { return _raw ? _raw_size : _str.size(); }
+
+    /// Accesses the character at a given index without bounds-checking.
+    char& operator[](std::size_t index) { return data()[index]; }
+
+    /// Accesses the character at a given index without bounds-checking.
+    const char& operator[](std::size_t index) const {
+        return data()[index];
+    }
+
+    /// Refers to the characters.
+    operator string_ref() const { return string_ref(data(), size()); }
+
+    /// Returns the contents as a string and leaves the buffer empty.  If the
+    /// buffer was created from a string, the same storage is returned without
+    /// copying.
+    std::string release() {
+        std::string s;
+        if (_raw) {
+            s.assign(_raw, _raw_size);
+            _deallocate(_raw);
+            _raw = nullptr;
+            _raw_size = 0;
+        } else {
+            s.swap(_str);
+        }
+        return s;
+    }
+
+    /// Swaps the storage of two buffers.
+    void swap(char_buffer& other) {
+        _str.swap(other._str);
+        std::swap(_raw, other._raw);
+        std::swap(_raw_size, other._raw_size);
+        std::swap(_deallocate, other._deallocate);
+    }
+
+private:
+    static void delete_array(void* p) { delete[] static_cast<char*>(p); }
+
+    void adopt(char* p, std::size_t size, void (*deallocate)(void*)) {
+        if (!p)
+            return;
+        p[size] = '\0';
+        _raw = p;
+        _raw_size = size;
+        _deallocate = deallocate;
+    }
+
+    std::string _str;
+    char* _raw;
+    std::size_t _raw_size;
+    void (*_deallocate)(void*);
+};
+
 }
 #endif
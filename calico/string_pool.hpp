@@ -0,0 +1,280 @@
+#ifndef QWJZHNTEKRLXVOMDPAUC
+#define QWJZHNTEKRLXVOMDPAUC
+/// @file
+///
+/// Interning of strings into compact integer handles.
+///
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "simd.hpp"
+#include "string.hpp"
+namespace cal {
+
+/// A thread-safe pool of unique, immutable strings.
+///
+/// Interning a string copies it into the pool (unless an equal string is
+/// already there) and returns a 32-bit `handle` to it.  Handles from the
+/// same pool are equal if and only if their strings are equal, so they can
+/// be compared and hashed in constant time and used as compact keys in place
+/// of the strings themselves.
+///
+/// The characters are stored null-terminated in large arena chunks that are
+/// never moved or freed until the pool is destroyed, so the result of `str`
+/// and `c_str` remains valid for the lifetime of the pool.
+///
+/// The pool is split into 16 shards selected by the hash of the string, each
+/// with its own lock and hash table, so threads interning different strings
+/// rarely contend.  Looking up the string of a handle (`str` and `c_str`)
+/// takes no lock at all and may proceed concurrently with interning.
+class string_pool {
+
+    struct entry {
+        const char* data;
+        std::uint32_t size;
+        std::uint32_t hash;
+    };
+
+    static const unsigned shard_bits = 4;
+    static const std::size_t shard_count = std::size_t(1) << shard_bits;
+
+    // Entries of a shard are stored in blocks of doubling size so that they
+    // never move once created: block `k` holds `64 << k` entries.
+    static const unsigned block_bits = 6;
+    static const unsigned block_count = 32 - shard_bits - block_bits;
+    static const std::uint32_t max_shard_size =
+        ((std::uint32_t(1) << block_count) - 1) << block_bits;
+
+    static const std::size_t chunk_size = 16384;
+
+public:
+
+    /// A compact reference to a string in a `string_pool`.
+    ///
+    /// A default-constructed handle is null and does not refer to any
+    /// string.
+    class handle {
+    public:
+
+        /// Constructs a null handle.
+        handle() : _value(0xffffffff) {}
+
+        /// Reconstructs a handle from the result of `value()`.
+        explicit handle(std::uint32_t value) : _value(value) {}
+
+        /// Returns the integer representation of the handle.
+        std::uint32_t value() const { return _value; }
+
+        /// Returns whether the handle refers to a string.
+        explicit operator bool() const { return _value != 0xffffffff; }
+
+        /// Compares two handles for equality.
+        friend bool operator==(handle a, handle b) {
+            return a._value == b._value;
+        }
+
+        /// Compares two handles for inequality.
+        friend bool operator!=(handle a, handle b) {
+            return a._value != b._value;
+        }
+
+        /// Orders handles arbitrarily (but consistently) for use in ordered
+        /// containers.  This is not the lexicographic order of the strings.
+        friend bool operator<(handle a, handle b) {
+            return a._value < b._value;
+        }
+
+    private:
+        std::uint32_t _value;
+    };
+
+    /// Constructs an empty pool.
+    string_pool() {}
+
+    string_pool(const string_pool&) = delete;
+
+    string_pool& operator=(const string_pool&) = delete;
+
+    /// Returns the handle of the string equal to `s`, adding a copy of `s`
+    /// to the pool if it is not already there.
+    ///
+    /// @throws std::length_error  If the pool or the string is too large.
+    handle intern(string_ref s) {
+        if (s.size() > 0xffffffffu)
+            throw std::length_error("cal::string_pool::intern: "
+                                    "string too long");
+        const std::uint32_t hash = hash_of(s);
+        const std::size_t index = hash >> (32 - shard_bits);
+        shard& sh = _shards[index];
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        if ((sh.size + 1u) * std::size_t(4) > sh.slots.size() * 3)
+            rehash(sh);
+        std::uint32_t& slot = sh.slots[probe(sh, s, hash)];
+        if (slot)
+            return make_handle(index, slot - 1);
+        if (sh.size == max_shard_size)
+            throw std::length_error("cal::string_pool::intern: "
+                                    "too many strings");
+        entry& e = allocate_entry(sh);
+        e.data = store(sh, s);
+        e.size = static_cast<std::uint32_t>(s.size());
+        e.hash = hash;
+        slot = ++sh.size;
+        return make_handle(index, slot - 1);
+    }
+
+    /// Returns the handle of the string equal to `s` if it is in the pool,
+    /// or a null handle otherwise.
+    handle find(string_ref s) const {
+        if (s.size() > 0xffffffffu)
+            return handle();
+        const std::uint32_t hash = hash_of(s);
+        const std::size_t index = hash >> (32 - shard_bits);
+        const shard& sh = _shards[index];
+        std::lock_guard<std::mutex> lock(sh.mutex);
+        if (sh.slots.empty())
+            return handle();
+        const std::uint32_t slot = sh.slots[probe(sh, s, hash)];
+        return slot ? make_handle(index, slot - 1) : handle();
+    }
+
+    /// Returns the string of a non-null handle obtained from this pool.
+    string_ref str(handle h) const {
+        const entry& e = get(h);
+        return string_ref(e.data, e.size);
+    }
+
+    /// Returns the null-terminated string of a non-null handle obtained from
+    /// this pool.
+    const char* c_str(handle h) const { return get(h).data; }
+
+    /// Returns the number of distinct strings in the pool.
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (const shard& sh : _shards) {
+            std::lock_guard<std::mutex> lock(sh.mutex);
+            n += sh.size;
+        }
+        return n;
+    }
+
+private:
+
+    struct shard {
+        shard() : size(), chunk_pos(), chunk_left() {}
+        mutable std::mutex mutex;
+        std::uint32_t size;
+        std::unique_ptr<entry[]> blocks[block_count];
+        // Open-addressed table of one plus the index of each entry, with
+        // zero marking an empty slot.
+        std::vector<std::uint32_t> slots;
+        std::vector<std::unique_ptr<char[]> > chunks;
+        char* chunk_pos;
+        std::size_t chunk_left;
+    };
+
+    static std::uint32_t hash_of(string_ref s) {
+        return static_cast<std::uint32_t>(_priv::hash_bytes(s.data(),
+                                                            s.size()));
+    }
+
+    static handle make_handle(std::size_t index, std::uint32_t i) {
+        return handle(i << shard_bits | static_cast<std::uint32_t>(index));
+    }
+
+    static entry& locate(const shard& sh, std::uint32_t i) {
+        const unsigned k = _priv::floor_log2((i >> block_bits) + 1);
+        return sh.blocks[k][i - (((std::uint32_t(1) << k) - 1)
+                                 << block_bits)];
+    }
+
+    const entry& get(handle h) const {
+        const std::uint32_t v = h.value();
+        return locate(_shards[v & (shard_count - 1)], v >> shard_bits);
+    }
+
+    // Returns the slot of the entry equal to `s`, or the empty slot where it
+    // belongs.
+    static std::size_t probe(const shard& sh, string_ref s,
+                             std::uint32_t hash) {
+        const std::size_t mask = sh.slots.size() - 1;
+        for (std::size_t p = hash & mask; ; p = (p + 1) & mask) {
+            const std::uint32_t slot = sh.slots[p];
+            if (!slot)
+                return p;
+            const entry& e = locate(sh, slot - 1);
+            if (e.hash == hash && e.size == s.size()
+                && std::char_traits<char>::compare(e.data, s.data(),
+                                                   s.size()) == 0)
+                return p;
+        }
+    }
+
+    static void rehash(shard& sh) {
+        std::vector<std::uint32_t> slots(std::max(sh.slots.size() * 2,
+                                                  std::size_t(64)));
+        const std::size_t mask = slots.size() - 1;
+        for (std::uint32_t i = 0; i != sh.size; ++i) {
+            std::size_t p = locate(sh, i).hash & mask;
+            while (slots[p])
+                p = (p + 1) & mask;
+            slots[p] = i + 1;
+        }
+        sh.slots.swap(slots);
+    }
+
+    static entry& allocate_entry(shard& sh) {
+        const std::uint32_t i = sh.size;
+        const unsigned k = _priv::floor_log2((i >> block_bits) + 1);
+        if (!sh.blocks[k])
+            sh.blocks[k].reset(new entry[std::size_t(1) << (k + block_bits)]);
+        return locate(sh, i);
+    }
+
+    // Copies the string into the arena, giving large strings a chunk of
+    // their own so as not to waste the remainder of the current one.
+    static const char* store(shard& sh, string_ref s) {
+        const std::size_t n = s.size() + 1;
+        char* p;
+        if (n > chunk_size / 4) {
+            sh.chunks.emplace_back(new char[n]);
+            p = sh.chunks.back().get();
+        } else {
+            if (n > sh.chunk_left) {
+                sh.chunks.emplace_back(new char[chunk_size]);
+                sh.chunk_pos = sh.chunks.back().get();
+                sh.chunk_left = chunk_size;
+            }
+            p = sh.chunk_pos;
+            sh.chunk_pos += n;
+            sh.chunk_left -= n;
+        }
+        std::char_traits<char>::copy(p, s.data(), s.size());
+        p[s.size()] = '\0';
+        return p;
+    }
+
+    shard _shards[shard_count];
+};
+
+}
+
+namespace std {
+
+/// Hashes a `string_pool::handle`.
+template<>
+struct hash<cal::string_pool::handle> {
+    /// Returns the hash of the handle.
+    std::size_t operator()(cal::string_pool::handle h) const {
+        return h.value();
+    }
+};
+
+}
+#endif
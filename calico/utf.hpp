@@ -0,0 +1,871 @@
+#ifndef FRGEPAHUIHCQVGNKNMJX
+#define FRGEPAHUIHCQVGNKNMJX
+/// @file
+///
+/// Validation of UTF-8 and conversion between UTF-8, UTF-16, and UTF-32.
+///
+/// UTF-8 is stored as `char`.  UTF-16 and UTF-32 may be stored in any
+/// integral type of 2 and 4 bytes respectively, such as `char16_t`,
+/// `char32_t`, or `wchar_t` (which is UTF-16 on Windows and UTF-32
+/// elsewhere).
+///
+/// The conversions operate on caller-provided buffers and never allocate.
+/// Each converts a whole range in a single pass, so the output buffer must
+/// be large enough for the worst case, which is documented with each
+/// function.  The string-returning overloads do exactly that and then shrink
+/// the result to fit.
+///
+/// Runs of ASCII are handled 16 bytes at a time with SSE2.  UTF-8
+/// validation uses AVX2 (dispatched at run time, as in simd.hpp) to check 32
+/// bytes at a time regardless of their content.
+///
+/// `utf8_iterator` walks the code points of a UTF-8 string in either
+/// direction.  To count or skip many code points at once, `utf8_length` and
+/// `utf8_advance` are much faster than stepping an iterator.
+///
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include "iterator.hpp"
+#include "simd.hpp"
+#include "string.hpp"
+namespace cal {
+
+/// How invalid input is treated during conversion.
+enum class utf_errors {
+    /// Stop at the first invalid sequence and report it.
+    strict,
+    /// Substitute U+FFFD for each maximal invalid subsequence and continue,
+    /// as recommended by the Unicode Standard (section 3.9).
+    replace
+};
+
+/// The result of a UTF conversion.
+template<class In, class Out>
+struct utf_result {
+    /// Points to the end of the input on success; otherwise, to the start of
+    /// the first invalid sequence.
+    const In* ptr;
+
+    /// Points to the end of the output that has been written.
+    Out* out;
+
+    /// `std::errc()` on success, or `std::errc::illegal_byte_sequence` if
+    /// the input is invalid.
+    std::errc ec;
+};
+
+namespace _priv {
+
+// Returned by the decoders for an invalid sequence.
+static const std::uint32_t utf_invalid = 0xffffffff;
+
+template<class In, class Out>
+inline utf_result<In, Out> make_utf_result(const In* ptr, Out* out,
+                                           std::errc ec = std::errc()) {
+    utf_result<In, Out> r = {ptr, out, ec};
+    return r;
+}
+
+// Returns the number of leading ASCII characters in `[first, last)`.
+inline std::size_t ascii_length(const char* first, const char* last) {
+    const char* p = first;
+#ifdef CALICO_SIMD_SSE2
+    for (; last - p >= 16; p += 16) {
+        const std::uint32_t m = static_cast<std::uint32_t>(_mm_movemask_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+        if (m)
+            return static_cast<std::size_t>(p - first)
+                 + count_trailing_zeros(m);
+    }
+#else
+    for (; last - p >= 8; p += 8) {
+        std::uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+        if (v & 0x8080808080808080u)
+            break;
+    }
+#endif
+    while (p != last && !(*p & 0x80))
+        ++p;
+    return static_cast<std::size_t>(p - first);
+}
+
+// Decodes the non-ASCII sequence at `p` and advances past it.  On error,
+// `p` is advanced past the maximal subpart of an ill-formed sequence (at
+// least one byte) and `utf_invalid` is returned.
+inline std::uint32_t utf8_decode(const char*& p, const char* last) {
+    const unsigned char lead = static_cast<unsigned char>(*p);
+    const char* q = p + 1;
+    unsigned n;
+    std::uint32_t c;
+    unsigned char lo = 0x80, hi = 0xbf;
+    if (lead < 0xc2 || lead > 0xf4) {
+        p = q;
+        return utf_invalid;
+    } else if (lead < 0xe0) {
+        n = 1;
+        c = lead & 0x1fu;
+    } else if (lead < 0xf0) {
+        n = 2;
+        c = lead & 0x0fu;
+        if (lead == 0xe0)
+            lo = 0xa0;                  // overlong
+        else if (lead == 0xed)
+            hi = 0x9f;                  // surrogate
+    } else {
+        n = 3;
+        c = lead & 0x07u;
+        if (lead == 0xf0)
+            lo = 0x90;                  // overlong
+        else if (lead == 0xf4)
+            hi = 0x8f;                  // beyond U+10FFFF
+    }
+    for (; n; --n, ++q) {
+        if (q == last
+            || static_cast<unsigned char>(*q) < lo
+            || static_cast<unsigned char>(*q) > hi) {
+            p = q;
+            return utf_invalid;
+        }
+        const unsigned char b = static_cast<unsigned char>(*q);
+        c = c << 6 | (b & 0x3fu);
+        lo = 0x80;
+        hi = 0xbf;
+    }
+    p = q;
+    return c;
+}
+
+// Writes a scalar value as UTF-8.
+inline char* utf8_encode(std::uint32_t c, char* out) {
+    if (c < 0x80) {
+        *out++ = static_cast<char>(c);
+    } else if (c < 0x800) {
+        *out++ = static_cast<char>(0xc0 | c >> 6);
+        *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+        *out++ = static_cast<char>(0xe0 | c >> 12);
+        *out++ = static_cast<char>(0x80 | (c >> 6 & 0x3f));
+        *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+        *out++ = static_cast<char>(0xf0 | c >> 18);
+        *out++ = static_cast<char>(0x80 | (c >> 12 & 0x3f));
+        *out++ = static_cast<char>(0x80 | (c >> 6 & 0x3f));
+        *out++ = static_cast<char>(0x80 | (c & 0x3f));
+    }
+    return out;
+}
+
+// Writes a scalar value as UTF-16.
+template<class Char16>
+inline Char16* utf16_encode(std::uint32_t c, Char16* out) {
+    if (c < 0x10000) {
+        *out++ = static_cast<Char16>(c);
+    } else {
+        c -= 0x10000;
+        *out++ = static_cast<Char16>(0xd800 | c >> 10);
+        *out++ = static_cast<Char16>(0xdc00 | (c & 0x3ff));
+    }
+    return out;
+}
+
+// Copies the leading ASCII of `[first, last)` into `out`, widening each
+// byte to a code unit of `Char`, and returns the number of characters
+// copied.  Whole blocks are stored even if they are only partly ASCII, so
+// `out` must have room for `last - first` code units.
+template<class Char>
+inline std::size_t widen_ascii(const char* first,
+                               const char* last,
+                               Char* out) {
+    const char* p = first;
+    if (p == last || *p & 0x80)
+        return 0;
+#ifdef CALICO_SIMD_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; last - p >= 16; p += 16, out += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i lo = _mm_unpacklo_epi8(v, zero);
+        const __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i* dest = reinterpret_cast<__m128i*>(out);
+        if (sizeof(Char) == 2) {
+            _mm_storeu_si128(dest, lo);
+            _mm_storeu_si128(dest + 1, hi);
+        } else {
+            _mm_storeu_si128(dest, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(dest + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(dest + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(dest + 3, _mm_unpackhi_epi16(hi, zero));
+        }
+        const std::uint32_t m =
+            static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+        if (m)
+            return static_cast<std::size_t>(p - first)
+                 + count_trailing_zeros(m);
+    }
+#endif
+    for (; p != last && !(*p & 0x80); ++p)
+        *out++ = static_cast<Char>(*p);
+    return static_cast<std::size_t>(p - first);
+}
+
+// Copies the leading ASCII code units of `[first, last)` into `out` as
+// bytes and returns the number of units copied.  Whole blocks are stored
+// even if they are only partly ASCII, so `out` must have room for
+// `last - first` bytes.
+template<class Char>
+inline std::size_t narrow_ascii(const Char* first,
+                                const Char* last,
+                                char* out) {
+    const Char* p = first;
+    if (p == last || static_cast<std::uint32_t>(*p) >= 0x80)
+        return 0;
+#ifdef CALICO_SIMD_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    const std::size_t block = 16 / sizeof(Char) * 2;
+    for (; static_cast<std::size_t>(last - p) >= block;
+         p += block, out += block) {
+        const __m128i* src = reinterpret_cast<const __m128i*>(p);
+        __m128i a = _mm_loadu_si128(src);
+        __m128i b = _mm_loadu_si128(src + 1);
+        std::uint32_t m;
+        if (sizeof(Char) == 2) {
+            const __m128i high = _mm_set1_epi16(static_cast<short>(0xff80));
+            m = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(
+                _mm_cmpeq_epi16(_mm_and_si128(a, high), zero),
+                _mm_cmpeq_epi16(_mm_and_si128(b, high), zero))));
+        } else {
+            const __m128i high = _mm_set1_epi32(~0x7f);
+            m = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_packs_epi32(
+                _mm_cmpeq_epi32(_mm_and_si128(a, high), zero),
+                _mm_cmpeq_epi32(_mm_and_si128(b, high), zero))));
+            a = _mm_packs_epi32(a, zero);
+            b = _mm_packs_epi32(b, zero);
+            a = _mm_unpacklo_epi64(a, b);
+            b = zero;
+        }
+        // Non-ASCII units may become arbitrary bytes here, but they are
+        // overwritten by the caller.
+        const __m128i bytes = _mm_packus_epi16(a, b);
+        if (sizeof(Char) == 2)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        else
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+        if (m != 0xffffu) {
+            const unsigned n = count_trailing_zeros(~m);
+            return static_cast<std::size_t>(p - first)
+                 + (sizeof(Char) == 2 ? n : n / 2);
+        }
+    }
+#endif
+    for (; p != last && static_cast<std::uint32_t>(*p) < 0x80; ++p)
+        *out++ = static_cast<char>(*p);
+    return static_cast<std::size_t>(p - first);
+}
+
+inline const char* scalar_utf8_find_invalid(const char* first,
+                                            const char* last) {
+    const char* p = first;
+    while (true) {
+        p += ascii_length(p, last);
+        if (p == last)
+            return last;
+        const char* q = p;
+        if (utf8_decode(q, last) == utf_invalid)
+            return p;
+        p = q;
+    }
+}
+
+#if defined(CALICO_SIMD_AVX2) || defined(CALICO_SIMD_AVX2_DISPATCH)
+
+// Lookup tables for the validation algorithm of John Keiser and Daniel
+// Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte",
+// Software: Practice and Experience 51 (5), 2021.  Each bit marks a kind of
+// error that a pair of adjacent bytes may exhibit; an error occurs if all
+// three nibbles agree on it.
+template<class = void>
+struct utf8_tables {
+    static const unsigned char data[3][16];
+};
+template<class T>
+const unsigned char utf8_tables<T>::data[3][16] = {
+    // high nibble of the first byte
+    {0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+     0x80, 0x80, 0x80, 0x80, 0x21, 0x01, 0x15, 0x49},
+    // low nibble of the first byte
+    {0xe7, 0xa3, 0x83, 0x83, 0x8b, 0xcb, 0xcb, 0xcb,
+     0xcb, 0xcb, 0xcb, 0xcb, 0xcb, 0xdb, 0xcb, 0xcb},
+    // high nibble of the second byte
+    {0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+     0xe6, 0xae, 0xba, 0xba, 0x01, 0x01, 0x01, 0x01}
+};
+
+CALICO_TARGET_AVX2
+inline __m256i avx2_utf8_table(int i) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(utf8_tables<>::data[i])));
+}
+
+// Returns a nonzero vector if the block `in`, preceded by `prev`, contains
+// an invalid sequence, excluding any left incomplete at its end.
+CALICO_TARGET_AVX2
+inline __m256i avx2_utf8_errors(__m256i in, __m256i prev) {
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i shifted = _mm256_permute2x128_si256(prev, in, 0x21);
+    const __m256i prev1 = _mm256_alignr_epi8(in, shifted, 15);
+    const __m256i prev2 = _mm256_alignr_epi8(in, shifted, 14);
+    const __m256i prev3 = _mm256_alignr_epi8(in, shifted, 13);
+    const __m256i special = _mm256_and_si256(
+        _mm256_and_si256(
+            _mm256_shuffle_epi8(avx2_utf8_table(0), _mm256_and_si256(
+                _mm256_srli_epi16(prev1, 4), nibble)),
+            _mm256_shuffle_epi8(avx2_utf8_table(1),
+                                _mm256_and_si256(prev1, nibble))),
+        _mm256_shuffle_epi8(avx2_utf8_table(2), _mm256_and_si256(
+            _mm256_srli_epi16(in, 4), nibble)));
+    // The third and fourth bytes of a sequence must be continuations; the
+    // tables alone only mark them as "two continuations in a row".
+    const __m256i third = _mm256_subs_epu8(
+        prev2, _mm256_set1_epi8(static_cast<char>(0xe0 - 1)));
+    const __m256i fourth = _mm256_subs_epu8(
+        prev3, _mm256_set1_epi8(static_cast<char>(0xf0 - 1)));
+    const __m256i must_continue = _mm256_and_si256(
+        _mm256_cmpgt_epi8(_mm256_or_si256(third, fourth),
+                          _mm256_setzero_si256()),
+        _mm256_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_xor_si256(must_continue, special);
+}
+
+CALICO_TARGET_AVX2
+inline const char* avx2_utf8_find_invalid(const char* first,
+                                          const char* last) {
+    // Nonzero where a sequence starting in the last 3 bytes is incomplete.
+    const __m256i max = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        static_cast<char>(0xf0 - 1), static_cast<char>(0xe0 - 1),
+        static_cast<char>(0xc0 - 1));
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    const char* p = first;
+    bool error = false;
+    for (; last - p >= 32; p += 32) {
+        const __m256i in =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i e;
+        if (!_mm256_movemask_epi8(in)) {
+            e = incomplete;
+            incomplete = _mm256_setzero_si256();
+        } else {
+            e = avx2_utf8_errors(in, prev);
+            incomplete = _mm256_subs_epu8(in, max);
+        }
+        prev = in;
+        if (!_mm256_testz_si256(e, e)) {
+            error = true;
+            break;
+        }
+    }
+    if (!error) {
+        // Pad the tail with zeros, which also exposes any sequence left
+        // incomplete at the end.
+        char buf[32] = {};
+        std::memcpy(buf, p, static_cast<std::size_t>(last - p));
+        const __m256i e = avx2_utf8_errors(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf)), prev);
+        if (_mm256_testz_si256(e, e))
+            return last;
+    }
+    // The block at `p` contains an error, possibly in a sequence that
+    // started in the last 3 bytes of the previous block.  Restart the scalar
+    // decoder from the first sequence that begins there.
+    const char* q = p - first < 3 ? first : p - 3;
+    while (q != p && (*q & 0xc0) == 0x80)
+        ++q;
+    return scalar_utf8_find_invalid(q, last);
+}
+
+#endif
+}
+
+/// Returns the start of the first invalid sequence in a UTF-8 string, or
+/// `last` if the string is valid.
+///
+/// Overlong encodings, surrogates, and values beyond U+10FFFF are invalid.
+inline const char* utf8_find_invalid(const char* first, const char* last) {
+#if defined(CALICO_SIMD_AVX2)
+    return _priv::avx2_utf8_find_invalid(first, last);
+#else
+#if defined(CALICO_SIMD_AVX2_DISPATCH)
+    if (_priv::cpu_has_avx2())
+        return _priv::avx2_utf8_find_invalid(first, last);
+#endif
+    return _priv::scalar_utf8_find_invalid(first, last);
+#endif
+}
+
+/// Returns whether a string is valid UTF-8.
+///
+/// @see utf8_find_invalid
+inline bool utf8_valid(string_ref s) {
+    return utf8_find_invalid(s.begin(), s.end()) == s.end();
+}
+
+/// Converts UTF-8 to UTF-16.
+///
+/// The output must have room for `last - first` code units.
+template<class Char16> inline
+utf_result<char, Char16> utf8_to_utf16(const char* first,
+                                       const char* last,
+                                       Char16* out,
+                                       utf_errors errors = utf_errors::strict) {
+    static_assert(std::is_integral<Char16>::value && sizeof(Char16) == 2,
+                  "UTF-16 code units must be 16-bit integers");
+    const char* p = first;
+    while (true) {
+        const std::size_t n = _priv::widen_ascii(p, last, out);
+        p += n;
+        out += n;
+        if (p == last)
+            return _priv::make_utf_result(last, out);
+        const char* q = p;
+        std::uint32_t c = _priv::utf8_decode(q, last);
+        if (c == _priv::utf_invalid) {
+            if (errors == utf_errors::strict)
+                return _priv::make_utf_result(
+                    p, out, std::errc::illegal_byte_sequence);
+            c = 0xfffd;
+        }
+        out = _priv::utf16_encode(c, out);
+        p = q;
+    }
+}
+
+/// Converts UTF-8 to UTF-32.
+///
+/// The output must have room for `last - first` code units.
+template<class Char32> inline
+utf_result<char, Char32> utf8_to_utf32(const char* first,
+                                       const char* last,
+                                       Char32* out,
+                                       utf_errors errors = utf_errors::strict) {
+    static_assert(std::is_integral<Char32>::value && sizeof(Char32) == 4,
+                  "UTF-32 code units must be 32-bit integers");
+    const char* p = first;
+    while (true) {
+        const std::size_t n = _priv::widen_ascii(p, last, out);
+        p += n;
+        out += n;
+        if (p == last)
+            return _priv::make_utf_result(last, out);
+        const char* q = p;
+        std::uint32_t c = _priv::utf8_decode(q, last);
+        if (c == _priv::utf_invalid) {
+            if (errors == utf_errors::strict)
+                return _priv::make_utf_result(
+                    p, out, std::errc::illegal_byte_sequence);
+            c = 0xfffd;
+        }
+        *out++ = static_cast<Char32>(c);
+        p = q;
+    }
+}
+
+/// Converts UTF-16 to UTF-8.  Unpaired surrogates are invalid.
+///
+/// The output must have room for `3 * (last - first)` bytes.
+template<class Char16> inline
+utf_result<Char16, char> utf16_to_utf8(const Char16* first,
+                                       const Char16* last,
+                                       char* out,
+                                       utf_errors errors = utf_errors::strict) {
+    static_assert(std::is_integral<Char16>::value && sizeof(Char16) == 2,
+                  "UTF-16 code units must be 16-bit integers");
+    const Char16* p = first;
+    while (true) {
+        const std::size_t n = _priv::narrow_ascii(p, last, out);
+        p += n;
+        out += n;
+        if (p == last)
+            return _priv::make_utf_result(last, out);
+        std::uint32_t c = static_cast<std::uint16_t>(*p);
+        if ((c & 0xf800) != 0xd800) {
+            ++p;
+        } else if (c < 0xdc00 && last - p > 1
+                   && (static_cast<std::uint16_t>(p[1]) & 0xfc00) == 0xdc00) {
+            c = 0x10000 + ((c & 0x3ff) << 10)
+              + (static_cast<std::uint16_t>(p[1]) & 0x3ffu);
+            p += 2;
+        } else if (errors == utf_errors::strict) {
+            return _priv::make_utf_result(
+                p, out, std::errc::illegal_byte_sequence);
+        } else {
+            c = 0xfffd;
+            ++p;
+        }
+        out = _priv::utf8_encode(c, out);
+    }
+}
+
+/// Converts UTF-32 to UTF-8.  Surrogates and values beyond U+10FFFF are
+/// invalid.
+///
+/// The output must have room for `4 * (last - first)` bytes.
+template<class Char32> inline
+utf_result<Char32, char> utf32_to_utf8(const Char32* first,
+                                       const Char32* last,
+                                       char* out,
+                                       utf_errors errors = utf_errors::strict) {
+    static_assert(std::is_integral<Char32>::value && sizeof(Char32) == 4,
+                  "UTF-32 code units must be 32-bit integers");
+    const Char32* p = first;
+    while (true) {
+        const std::size_t n = _priv::narrow_ascii(p, last, out);
+        p += n;
+        out += n;
+        if (p == last)
+            return _priv::make_utf_result(last, out);
+        std::uint32_t c = static_cast<std::uint32_t>(*p);
+        if (c > 0x10ffff || (c & 0xfffff800) == 0xd800) {
+            if (errors == utf_errors::strict)
+                return _priv::make_utf_result(
+                    p, out, std::errc::illegal_byte_sequence);
+            c = 0xfffd;
+        }
+        out = _priv::utf8_encode(c, out);
+        ++p;
+    }
+}
+
+namespace _priv {
+
+// Converts a whole string through a buffer sized for the worst case, then
+// trims it.  Throws `std::range_error` if the input is invalid in strict
+// mode.
+template<class Out, class In>
+inline std::basic_string<Out> utf_convert(
+    const In* first,
+    const In* last,
+    std::size_t max_ratio,
+    utf_errors errors,
+    utf_result<In, Out> (*convert)(const In*, const In*, Out*, utf_errors),
+    const char* what) {
+    std::basic_string<Out> s(max_ratio * static_cast<std::size_t>(
+                                 last - first), Out());
+    if (s.empty())
+        return s;
+    const utf_result<In, Out> r = convert(first, last, &s[0], errors);
+    if (r.ec != std::errc())
+        throw std::range_error(what);
+    s.resize(static_cast<std::size_t>(r.out - &s[0]));
+    s.shrink_to_fit();
+    return s;
+}
+
+}
+
+/// Converts a UTF-8 string to UTF-16.
+///
+/// @throw std::range_error if `errors` is `utf_errors::strict` and the
+///        string is invalid.
+template<class Char16 = char16_t> inline
+std::basic_string<Char16> utf8_to_utf16(
+    string_ref s,
+    utf_errors errors = utf_errors::strict) {
+    return _priv::utf_convert<Char16>(
+        s.begin(), s.end(), 1, errors,
+        utf8_to_utf16<Char16>, "cal::utf8_to_utf16: invalid UTF-8");
+}
+
+/// Converts a UTF-8 string to UTF-32.
+///
+/// @throw std::range_error if `errors` is `utf_errors::strict` and the
+///        string is invalid.
+template<class Char32 = char32_t> inline
+std::basic_string<Char32> utf8_to_utf32(
+    string_ref s,
+    utf_errors errors = utf_errors::strict) {
+    return _priv::utf_convert<Char32>(
+        s.begin(), s.end(), 1, errors,
+        utf8_to_utf32<Char32>, "cal::utf8_to_utf32: invalid UTF-8");
+}
+
+/// Converts a UTF-16 string to UTF-8.
+///
+/// @throw std::range_error if `errors` is `utf_errors::strict` and the
+///        string is invalid.
+template<class Char16> inline
+std::string utf16_to_utf8(const std::basic_string<Char16>& s,
+                          utf_errors errors = utf_errors::strict) {
+    return _priv::utf_convert<char>(
+        s.data(), s.data() + s.size(), 3, errors,
+        utf16_to_utf8<Char16>, "cal::utf16_to_utf8: invalid UTF-16");
+}
+
+/// Converts a UTF-32 string to UTF-8.
+///
+/// @throw std::range_error if `errors` is `utf_errors::strict` and the
+///        string is invalid.
+template<class Char32> inline
+std::string utf32_to_utf8(const std::basic_string<Char32>& s,
+                          utf_errors errors = utf_errors::strict) {
+    return _priv::utf_convert<char>(
+        s.data(), s.data() + s.size(), 4, errors,
+        utf32_to_utf8<Char32>, "cal::utf32_to_utf8: invalid UTF-32");
+}
+
+namespace _priv {
+
+inline bool utf8_is_continuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xc0) == 0x80;
+}
+
+// Counts the bytes in `[first, last)` that are not continuation bytes.
+inline std::size_t scalar_utf8_count_leads(const char* first,
+                                           const char* last) {
+    std::size_t n = 0;
+    for (const char* p = first; p != last; ++p)
+        n += !utf8_is_continuation(*p);
+    return n;
+}
+
+#ifdef CALICO_SIMD_SSE2
+inline std::size_t sse2_utf8_count_leads(const char* first,
+                                         const char* last) {
+    const __m128i bound = _mm_set1_epi8(-0x40);
+    const char* p = first;
+    std::size_t continuations = 0;
+    while (last - p >= 16) {
+        // Count the continuation bytes (those below 0xc0 as signed bytes)
+        // in per-lane counters, which are summed before they can overflow.
+        const std::size_t blocks = std::min<std::size_t>(
+            static_cast<std::size_t>(last - p) / 16, 255);
+        const char* const stop = p + 16 * blocks;
+        __m128i counts = _mm_setzero_si128();
+        for (; p != stop; p += 16) {
+            const __m128i v =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            counts = _mm_sub_epi8(counts, _mm_cmpgt_epi8(bound, v));
+        }
+        const __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        continuations += static_cast<std::size_t>(
+            _mm_cvtsi128_si32(sums)
+            + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+    }
+    return static_cast<std::size_t>(p - first) - continuations
+         + scalar_utf8_count_leads(p, last);
+}
+#endif
+
+#if defined(CALICO_SIMD_AVX2) || defined(CALICO_SIMD_AVX2_DISPATCH)
+CALICO_TARGET_AVX2
+inline std::size_t avx2_utf8_count_leads(const char* first,
+                                         const char* last) {
+    const __m256i bound = _mm256_set1_epi8(-0x40);
+    const char* p = first;
+    std::size_t continuations = 0;
+    while (last - p >= 32) {
+        const std::size_t blocks = std::min<std::size_t>(
+            static_cast<std::size_t>(last - p) / 32, 255);
+        const char* const stop = p + 32 * blocks;
+        __m256i counts = _mm256_setzero_si256();
+        for (; p != stop; p += 32) {
+            const __m256i v =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            counts = _mm256_sub_epi8(counts, _mm256_cmpgt_epi8(bound, v));
+        }
+        const __m256i sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+        const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums),
+                                           _mm256_extracti128_si256(sums, 1));
+        continuations += static_cast<std::size_t>(
+            _mm_cvtsi128_si32(half)
+            + _mm_cvtsi128_si32(_mm_srli_si128(half, 8)));
+    }
+    return static_cast<std::size_t>(p - first) - continuations
+         + scalar_utf8_count_leads(p, last);
+}
+#endif
+
+inline std::size_t utf8_count_leads(const char* first, const char* last) {
+#if defined(CALICO_SIMD_AVX2)
+    return avx2_utf8_count_leads(first, last);
+#else
+#if defined(CALICO_SIMD_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+        return avx2_utf8_count_leads(first, last);
+#endif
+#ifdef CALICO_SIMD_SSE2
+    return sse2_utf8_count_leads(first, last);
+#else
+    return scalar_utf8_count_leads(first, last);
+#endif
+#endif
+}
+
+}
+
+/// A `BidirectionalIterator` over the code points of a UTF-8 string.
+///
+/// Each maximal subpart of an ill-formed sequence is treated as a single
+/// U+FFFD, as in `utf_errors::replace`, in both directions.  The iterator
+/// remembers the bounds of the string so that it never reads outside of it.
+///
+/// ASCII characters are handled without entering the decoder, but the
+/// iterator still moves one code point at a time.  To skip over many code
+/// points, use `utf8_advance`.
+class utf8_iterator
+    : public input_iterator_base<utf8_iterator, char32_t, char32_t> {
+public:
+
+    /// Iterator category.
+    typedef std::bidirectional_iterator_tag iterator_category;
+
+    /// Constructs a singular iterator.
+    utf8_iterator() : _first(), _p(), _last() {}
+
+    /// Constructs an iterator at `p` in the string `[first, last)`.  `p`
+    /// must be the start of a code point (or of an invalid sequence) or
+    /// `last`.
+    utf8_iterator(const char* first, const char* p, const char* last)
+        : _first(first), _p(p), _last(last) {}
+
+    /// Returns a pointer to the first byte of the current code point.
+    const char* base() const { return _p; }
+
+    /// Decodes the current code point.
+    char32_t operator*() const {
+        if (!(*_p & 0x80))
+            return static_cast<char32_t>(*_p);
+        const char* p = _p;
+        const std::uint32_t c = _priv::utf8_decode(p, _last);
+        return c == _priv::utf_invalid ? 0xfffd : static_cast<char32_t>(c);
+    }
+
+    /// Advances to the next code point.
+    utf8_iterator& operator++() {
+        if (*_p & 0x80)
+            _priv::utf8_decode(_p, _last);
+        else
+            ++_p;
+        return *this;
+    }
+
+    using input_iterator_base<utf8_iterator, char32_t, char32_t>::operator++;
+
+    /// Moves back to the previous code point.
+    utf8_iterator& operator--() {
+        // Every byte that is not a continuation byte starts a code point
+        // (or an invalid sequence), so the previous one starts at the
+        // nearest such byte, unless it does not extend all the way to `_p`,
+        // in which case the last byte is a stray continuation byte.
+        const char* const q = _p - 1;
+        if (!(*q & 0x80)) {
+            _p = q;
+            return *this;
+        }
+        const char* lead = q;
+        while (lead != _first && _p - lead < 4
+               && _priv::utf8_is_continuation(*lead))
+            --lead;
+        _p = q;
+        if (!_priv::utf8_is_continuation(*lead)) {
+            const char* end = lead;
+            _priv::utf8_decode(end, _last);
+            if (end == q + 1)
+                _p = lead;
+        }
+        return *this;
+    }
+
+    /// Moves back to the previous code point and returns the iterator prior
+    /// to the decrement.
+    utf8_iterator operator--(int) {
+        utf8_iterator i = *this;
+        --*this;
+        return i;
+    }
+
+    /// Compares two iterators for equality.
+    bool operator==(const utf8_iterator& other) const {
+        return _p == other._p;
+    }
+
+private:
+    const char* _first;
+    const char* _p;
+    const char* _last;
+};
+
+/// A lazy range of the code points of a UTF-8 string.
+///
+/// @see utf8_iterator
+class utf8_range : public container_base<utf8_range, utf8_iterator> {
+public:
+
+    /// Constructs a range over the code points of `s`.
+    explicit utf8_range(string_ref s) : _s(s) {}
+
+    /// Returns an iterator to the first code point.
+    utf8_iterator begin() const {
+        return utf8_iterator(_s.begin(), _s.begin(), _s.end());
+    }
+
+    /// Returns a past-the-end iterator.
+    utf8_iterator end() const {
+        return utf8_iterator(_s.begin(), _s.end(), _s.end());
+    }
+
+private:
+    string_ref _s;
+};
+
+/// Returns a lazy range of the code points of a UTF-8 string.
+///
+/// @see utf8_iterator
+inline utf8_range utf8_chars(string_ref s) { return utf8_range(s); }
+
+/// Returns the number of code points in a valid UTF-8 string.
+///
+/// This counts the bytes that are not continuation bytes, 32 bytes at a time
+/// with AVX2 (or 16 with SSE2), regardless of their content.  For invalid
+/// input, the result is therefore not necessarily the number of code points
+/// produced by `utf8_iterator`.
+///
+/// Together with `utf8_advance`, this converts between byte offsets and
+/// code point offsets: the code point offset of byte `i` is
+/// `utf8_length(s.substr(0, i))`.
+inline std::size_t utf8_length(string_ref s) {
+    return _priv::utf8_count_leads(s.begin(), s.end());
+}
+
+/// Returns a pointer to the `n`-th code point of the UTF-8 string
+/// `[first, last)`, or `last` if there are not that many.
+///
+/// Runs of ASCII are skipped 16 bytes at a time and only multi-byte
+/// sequences are decoded, which are counted exactly as `utf8_iterator`
+/// would, even if they are invalid.
+inline const char* utf8_advance(const char* first,
+                                const char* last,
+                                std::size_t n) {
+    const char* p = first;
+    while (n && p != last) {
+        const std::size_t k = _priv::ascii_length(
+            p, static_cast<std::size_t>(last - p) > n ? p + n : last);
+        p += k;
+        n -= k;
+        if (n && p != last) {
+            _priv::utf8_decode(p, last);
+            --n;
+        }
+    }
+    return p;
+}
+
+}
+#endif
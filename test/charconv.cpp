@@ -0,0 +1,280 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+#include <calico/charconv.hpp>
+using namespace cal;
+
+template<class T>
+std::string show(T x) {
+    char buf[64];
+    to_chars_result r = to_chars(buf, buf + sizeof(buf), x);
+    assert(r.ec == std::errc());
+    return std::string(buf, r.ptr);
+}
+
+void test_integers() {
+    assert(show(0) == "0");
+    assert(show(7) == "7");
+    assert(show(-42) == "-42");
+    assert(show(100u) == "100");
+    assert(show(static_cast<short>(-32768)) == "-32768");
+    assert(show(static_cast<unsigned short>(65535)) == "65535");
+    assert(show(std::numeric_limits<int>::min()) == "-2147483648");
+    assert(show(std::numeric_limits<long long>::min())
+           == "-9223372036854775808");
+    assert(show(std::numeric_limits<unsigned long long>::max())
+           == "18446744073709551615");
+    for (int i = -1000; i != 1000; ++i)
+        assert(std::atoi(show(i).c_str()) == i);
+
+    char buf[3];
+    assert(to_chars(buf, buf + 3, 999).ec == std::errc());
+    assert(to_chars(buf, buf + 3, 1000).ec == std::errc::value_too_large);
+    assert(to_chars(buf, buf + 3, -99).ec == std::errc());
+    assert(to_chars(buf, buf + 3, -100).ec == std::errc::value_too_large);
+}
+
+void test_doubles() {
+    assert(show(0.0) == "0");
+    assert(show(-0.0) == "-0");
+    assert(show(3.2) == "3.2");
+    assert(show(0.1) == "0.1");
+    assert(show(-0.5) == "-0.5");
+    assert(show(100.0) == "100");
+    assert(show(123456789.0) == "123456789");
+    assert(show(0.001) == "0.001");
+    assert(show(0.0001) == "1e-04");
+    assert(show(1e15) == "1e+15");
+    assert(show(1e23) == "1e+23");
+    assert(show(1.5e300) == "1.5e+300");
+    assert(show(5e-324) == "5e-324");
+    assert(show(2.2250738585072014e-308) == "2.2250738585072014e-308");
+    assert(show(std::numeric_limits<double>::max())
+           == "1.7976931348623157e+308");
+    assert(show(9007199254740993.0) == "9007199254740992");
+    assert(show(5088143117563430912.0) == "5088143117563430912");
+    assert(show(-4611686018427387904.0) == "-4611686018427387904");
+    assert(show(1180591620717411303424.0) == "1180591620717411303424");
+    assert(show(std::numeric_limits<double>::infinity()) == "inf");
+    assert(show(-std::numeric_limits<double>::infinity()) == "-inf");
+    assert(show(std::numeric_limits<double>::quiet_NaN()) == "nan");
+
+    // every output must parse back to the same value
+    std::uint64_t state = 0x9e3779b97f4a7c15u;
+    for (int i = 0; i != 100000; ++i) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        double x;
+        std::memcpy(&x, &state, sizeof(x));
+        if (x != x || x - x != 0)
+            continue;
+        double y = std::strtod(show(x).c_str(), 0);
+        assert(std::memcmp(&x, &y, sizeof(x)) == 0);
+    }
+
+    char buf[4];
+    assert(to_chars(buf, buf + 4, 1.25).ec == std::errc());
+    assert(to_chars(buf, buf + 4, 1.125).ec == std::errc::value_too_large);
+}
+
+void test_floats() {
+    assert(show(0.1f) == "0.1");
+    assert(show(3.2f) == "3.2");
+    assert(show(16777216.0f) == "16777216");
+    assert(show(1073741824.0f) == "1073741824");
+    assert(show(1e10f) == "1e+10");
+    assert(show(std::numeric_limits<float>::max()) == "3.4028235e+38");
+    assert(show(std::numeric_limits<float>::denorm_min()) == "1e-45");
+    for (std::uint32_t bits = 0x00000001u;
+         bits < 0x7f800000u;
+         bits += 0x00012345u) {
+        float x;
+        std::memcpy(&x, &bits, sizeof(x));
+        float y = std::strtof(show(x).c_str(), 0);
+        assert(x == y);
+    }
+}
+
+template<class T>
+std::errc read(const char* s, T& x, std::ptrdiff_t used) {
+    const char* last = s + std::strlen(s);
+    from_chars_result r = from_chars(s, last, x);
+    assert(r.ptr - s == used);
+    return r.ec;
+}
+
+void test_parse_integers() {
+    int i = 0;
+    assert(read("123", i, 3) == std::errc() && i == 123);
+    assert(read("-42abc", i, 3) == std::errc() && i == -42);
+    assert(read("007", i, 3) == std::errc() && i == 7);
+    assert(read("2147483647", i, 10) == std::errc() && i == 2147483647);
+    assert(read("-2147483648", i, 11) == std::errc()
+           && i == std::numeric_limits<int>::min());
+    i = 5;
+    assert(read("2147483648", i, 10) == std::errc::result_out_of_range);
+    assert(read("-", i, 0) == std::errc::invalid_argument);
+    assert(read("+1", i, 0) == std::errc::invalid_argument);
+    assert(read(" 1", i, 0) == std::errc::invalid_argument);
+    assert(i == 5);
+
+    unsigned u = 5;
+    assert(read("-1", u, 0) == std::errc::invalid_argument && u == 5);
+    unsigned long long ull = 0;
+    assert(read("18446744073709551615", ull, 20) == std::errc()
+           && ull == std::numeric_limits<unsigned long long>::max());
+    assert(read("18446744073709551616", ull, 20)
+           == std::errc::result_out_of_range);
+    short h = 0;
+    assert(read("-32768", h, 6) == std::errc() && h == -32768);
+    assert(read("32768", h, 5) == std::errc::result_out_of_range);
+}
+
+void test_parse_floats() {
+    double d = 0;
+    assert(read("3.25", d, 4) == std::errc() && d == 3.25);
+    assert(read("-.5e1x", d, 5) == std::errc() && d == -5);
+    assert(read("1.", d, 2) == std::errc() && d == 1);
+    assert(read("1e", d, 1) == std::errc() && d == 1);
+    assert(read("1e+", d, 1) == std::errc() && d == 1);
+    assert(read("0.1", d, 3) == std::errc() && d == 0.1);
+    assert(read("1e23", d, 4) == std::errc() && d == 1e23);
+    assert(read("0.000000001234567890123", d, 23) == std::errc()
+           && d == 1.234567890123e-9);
+    assert(read("12345678901234567890123.5", d, 25) == std::errc()
+           && d == 12345678901234567890123.5);
+    assert(read("9007199254740993", d, 16) == std::errc()
+           && d == 9007199254740992.0);
+    assert(read("2.4703282292062328e-324", d, 23) == std::errc()
+           && d == std::numeric_limits<double>::denorm_min());
+    assert(read("1.7976931348623157e308", d, 22) == std::errc()
+           && d == std::numeric_limits<double>::max());
+    // exact halfway between 1 and the next double rounds to even, while any
+    // digit beyond it rounds up
+    assert(read("1.00000000000000011102230246251565404236316680908203125",
+                d, 55) == std::errc() && d == 1);
+    assert(read("1.000000000000000111022302462515654042363166809082031251",
+                d, 56) == std::errc() && d > 1);
+    assert(read("-inf", d, 4) == std::errc()
+           && d == -std::numeric_limits<double>::infinity());
+    assert(read("Infinity", d, 8) == std::errc()
+           && d == std::numeric_limits<double>::infinity());
+    assert(read("nan(0x1)", d, 8) == std::errc() && d != d);
+    d = 7;
+    assert(read("1e400", d, 5) == std::errc::result_out_of_range);
+    assert(read("1e-400", d, 6) == std::errc::result_out_of_range);
+    assert(read(".", d, 0) == std::errc::invalid_argument);
+    assert(read("e5", d, 0) == std::errc::invalid_argument);
+    assert(d == 7);
+
+    float f = 0;
+    assert(read("0.1", f, 3) == std::errc() && f == 0.1f);
+    assert(read("3.4028235e38", f, 12) == std::errc()
+           && f == std::numeric_limits<float>::max());
+    assert(read("3.5e38", f, 6) == std::errc::result_out_of_range);
+
+    // every formatted value must parse back to the same value
+    std::uint64_t state = 0x2545f4914f6cdd1du;
+    for (int i = 0; i != 100000; ++i) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        double x;
+        std::memcpy(&x, &state, sizeof(x));
+        if (x != x || x - x != 0)
+            continue;
+        char buf[64];
+        char* last = to_chars(buf, buf + sizeof(buf), x).ptr;
+        double y;
+        assert(from_chars(buf, last, y).ptr == last);
+        assert(std::memcmp(&x, &y, sizeof(x)) == 0);
+    }
+}
+
+template<class T>
+std::errc column(const char* s, std::vector<T>& v, std::ptrdiff_t used,
+                 char delimiter = ',') {
+    v.clear();
+    const parse_column_result r =
+        parse_column(s, s + std::strlen(s), v, delimiter);
+    assert(r.ptr - s == used && r.count == v.size());
+    return r.ec;
+}
+
+void test_parse_column() {
+    std::vector<int> v;
+    assert(column("", v, 0) == std::errc() && v.empty());
+    assert(column("1,-22,333\n4444,0\r\n-2147483648\n", v, 30)
+           == std::errc());
+    assert((v == std::vector<int>{1, -22, 333, 4444, 0,
+                                  std::numeric_limits<int>::min()}));
+    assert(column("7;8", v, 3, ';') == std::errc() && v.size() == 2);
+    assert(column("1,,2", v, 2) == std::errc::invalid_argument
+           && v.size() == 1);
+    assert(column("1,2x,3", v, 2) == std::errc::invalid_argument);
+    assert(column("1, 2", v, 2) == std::errc::invalid_argument);
+    assert(column("1,\n", v, 2) == std::errc::invalid_argument);
+    assert(column("1,2,", v, 4) == std::errc::invalid_argument
+           && v.size() == 2);
+    assert(column("1;2;", v, 4, ';') == std::errc::invalid_argument);
+    assert(column("1\n2\n", v, 4, '\n') == std::errc() && v.size() == 2);
+    assert(column("1\r", v, 0) == std::errc::invalid_argument);
+    assert(column("5,2147483648", v, 2) == std::errc::result_out_of_range);
+    assert(column("00000000000000000000000042", v, 26) == std::errc()
+           && v[0] == 42);
+
+    std::vector<unsigned long long> u;
+    assert(column("18446744073709551615,12345678901234567", u, 38)
+           == std::errc());
+    assert(u[0] == std::numeric_limits<unsigned long long>::max()
+           && u[1] == 12345678901234567u);
+    assert(column("18446744073709551616", u, 0)
+           == std::errc::result_out_of_range);
+    assert(column("-1", u, 0) == std::errc::invalid_argument);
+
+    std::vector<double> d;
+    assert(column("0.5,-1e3\n3.14159265358979,inf", d, 29) == std::errc());
+    assert(d[0] == 0.5 && d[1] == -1000 && d[2] == 3.14159265358979
+           && d[3] == std::numeric_limits<double>::infinity());
+    assert(column("1.5,.,2", d, 4) == std::errc::invalid_argument);
+
+    // agrees with `from_chars` on fields of every length
+    std::string text;
+    std::vector<long long> expected;
+    std::uint64_t state = 1;
+    for (int i = 0; i != 2000; ++i) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        const long long x = static_cast<long long>(state)
+                         >> (state >> 58);
+        char buf[32];
+        text.append(buf, to_chars(buf, buf + sizeof(buf), x).ptr);
+        text += i % 7 ? ',' : '\n';
+        expected.push_back(x);
+    }
+    text.back() = '\n';
+    std::vector<long long> values;
+    const parse_column_result r =
+        parse_column(text.data(), text.data() + text.size(), values);
+    assert(r.ec == std::errc() && values == expected);
+
+    text.clear();
+    for (int i = 0; i != 100; ++i)
+        text += "123456789,-7\r\n";
+    text.replace(1000, 3, "1 3");
+    values.clear();
+    const parse_column_result e =
+        parse_column(text.data(), text.data() + text.size(), values);
+    assert(e.ec == std::errc::invalid_argument && e.ptr == &text[994]);
+    assert(e.count == 142 && values[141] == -7 && values[140] == 123456789);
+}
+
+int main() {
+    test_integers();
+    test_doubles();
+    test_floats();
+    test_parse_integers();
+    test_parse_floats();
+    test_parse_column();
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <calico/csv.hpp>
+using namespace cal;
+
+namespace {
+
+// Returns the (row, column) of the error raised by reading all of `text`,
+// or (0, 0) if there is none.
+template<class... Ts>
+std::pair<int, int> error_at(const std::string& text) {
+    csv_reader<Ts...> reader(text);
+    typename csv_reader<Ts...>::row_type row;
+    try {
+        while (reader.read(row)) {}
+    } catch (const csv_error& e) {
+        return std::make_pair(static_cast<int>(e.row()),
+                              static_cast<int>(e.column()));
+    }
+    return std::make_pair(0, 0);
+}
+
+void test_rows() {
+    const std::string text =
+        "name,x,y,z\r\n"
+        "origin,0,0,0\r\n"
+        "\r\n"
+        "\"a, \"\"quoted\"\"\nname\",1.5,-2,3e2\n"
+        "\"\",4,5,6";
+    csv_reader<std::string, ntuple_t<double, 3> > reader(text);
+    static_assert(std::is_same<
+                      decltype(reader)::row_type,
+                      std::tuple<std::string, double, double, double> >::value,
+                  "");
+    const std::vector<std::string> header = reader.read_header();
+    assert((header == std::vector<std::string>{"name", "x", "y", "z"}));
+    std::vector<std::tuple<std::string, double, double, double> > rows;
+    for (const auto& row : reader)
+        rows.push_back(row);
+    assert(rows.size() == 3);
+    assert(rows[0] == std::make_tuple("origin", 0.0, 0.0, 0.0));
+    assert(rows[1]
+           == std::make_tuple("a, \"quoted\"\nname", 1.5, -2.0, 300.0));
+    assert(rows[2] == std::make_tuple("", 4.0, 5.0, 6.0));
+    assert(reader.read_header().empty());
+
+    // tab-separated, with string_ref fields pointing into the buffer
+    csv_reader<string_ref, int> tsv("a\t1\n\"b\"\"c\"\t2\n", '\t');
+    std::tuple<string_ref, int> row;
+    assert(tsv.read(row) && row == std::make_tuple(string_ref("a"), 1));
+    assert(tsv.read(row) && row == std::make_tuple(string_ref("b\"c"), 2));
+    assert(!tsv.read(row));
+}
+
+void test_errors() {
+    assert((error_at<int, int>("1,2\n3,4\n") == std::make_pair(0, 0)));
+    assert((error_at<int, int>("1,2\n3\n") == std::make_pair(2, 2)));
+    assert((error_at<int, int>("1,2,3\n") == std::make_pair(1, 3)));
+    assert((error_at<int, int>("1,2\n\n3,x\n") == std::make_pair(2, 2)));
+    assert((error_at<int, int>("1,\n") == std::make_pair(1, 2)));
+    assert((error_at<int, int>("1,99999999999\n") == std::make_pair(1, 2)));
+    assert((error_at<std::string>("\"ab\"c\n") == std::make_pair(1, 1)));
+    assert((error_at<std::string>("\"ab\n") == std::make_pair(1, 1)));
+
+    // the reader carries on with the next record after an error
+    csv_reader<int> reader("1\nx\n3\n");
+    std::tuple<int> row;
+    assert(reader.read(row) && std::get<0>(row) == 1);
+    try {
+        reader.read(row);
+        assert(false);
+    } catch (const csv_error& e) {
+        assert(std::string(e.what()) == "cal::csv_reader: row 2, column 1: "
+                                        "invalid value");
+    }
+    assert(reader.read(row) && std::get<0>(row) == 3);
+}
+
+void test_columns() {
+    csv_reader<int, std::string, double> reader("1,a,0.5\n2,b,1.5\n3,c,x\n");
+    csv_reader<int, std::string, double>::columns_type columns;
+    assert(reader.read_columns(columns, 1) == 1);
+    try {
+        reader.read_columns(columns);
+        assert(false);
+    } catch (const csv_error& e) {
+        assert(e.row() == 3 && e.column() == 3);
+    }
+    // the rows before the error are kept, and the partial row is not
+    assert((std::get<0>(columns) == std::vector<int>{1, 2}));
+    assert((std::get<1>(columns) == std::vector<std::string>{"a", "b"}));
+    assert((std::get<2>(columns) == std::vector<double>{0.5, 1.5}));
+    assert(reader.read_columns(columns) == 0);
+}
+
+// Reads a file through a tiny buffer, so that records straddle chunks and
+// some do not fit at all.
+void test_file() {
+    std::FILE* file = std::tmpfile();
+    assert(file);
+    std::string expected;
+    long sum = 0;
+    for (int i = 0; i != 2000; ++i) {
+        const std::string label(static_cast<std::size_t>(i % 97), 'x');
+        std::fprintf(file, "%d,\"%s\"\n", i, label.c_str());
+        sum += i;
+        expected += label;
+    }
+    std::rewind(file);
+    csv_reader<long, std::string> reader(file, ',', 8);
+    std::string labels;
+    long total = 0;
+    for (const auto& row : reader) {
+        total += std::get<0>(row);
+        labels += std::get<1>(row);
+    }
+    assert(total == sum && labels == expected);
+    std::fclose(file);
+}
+
+// The last record has no line break and does not fit in the initial chunk,
+// so reading it moves and reallocates the buffer.
+void test_unterminated_last_record() {
+    csv_reader<int, int> reader("1234,678", ',', 4);
+    std::tuple<int, int> row;
+    assert(reader.read(row) && row == std::make_tuple(1234, 678));
+    assert(!reader.read(row));
+
+    for (std::size_t chunk = 1; chunk != 24; ++chunk) {
+        std::FILE* file = std::tmpfile();
+        assert(file);
+        std::fputs("1,\"ab\"\n22,\"c,d\"\n\n333,\"e\"\"f\"", file);
+        std::rewind(file);
+        csv_reader<int, std::string> r(file, ',', chunk);
+        std::vector<std::tuple<int, std::string> > rows(r.begin(), r.end());
+        assert(rows.size() == 3);
+        assert(rows[0] == std::make_tuple(1, std::string("ab")));
+        assert(rows[1] == std::make_tuple(22, std::string("c,d")));
+        assert(rows[2] == std::make_tuple(333, std::string("e\"f")));
+        std::fclose(file);
+    }
+}
+
+}
+
+int main() {
+    test_rows();
+    test_errors();
+    test_columns();
+    test_file();
+    test_unterminated_last_record();
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include <cassert>
+#include <iterator>
+#include <list>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <calico/format.hpp>
+
+namespace {
+
+bool throws_format_error(const char* format, int x) {
+    try {
+        cal::format(format, x);
+    } catch (const cal::format_error&) {
+        return true;
+    }
+    return false;
+}
+
+}
+
+int main() {
+    using namespace cal;
+    using _priv::format_arg_kinds;
+    using _priv::format_check;
+
+    assert(format("plain") == "plain");
+    assert(format("{{}} {}", 1) == "{} 1");
+    assert(format("{} + {} = {}", 1, 2u, 3ll) == "1 + 2 = 3");
+    assert(format("{}", -9223372036854775807ll - 1)
+           == "-9223372036854775808");
+    assert(format("{:5}|{:<5}|{:^5}|{:*>5}", 42, 42, 42, 42)
+           == "   42|42   | 42  |***42");
+    assert(format("{:+}|{: }|{:05}|{:+05}", 7, 7, -7, 7)
+           == "+7| 7|-0007|+0007");
+    assert(format("{:x}|{:#X}|{:o}|{:#o}|{:#b}", 255, 255, 8, 8, 5)
+           == "ff|0XFF|10|010|0b101");
+    assert(format("{:#06x}", 255) == "0x00ff");
+    assert(format("{:c}{}{:d}", 104, 'i', '!') == "hi33");
+    assert(format("{}|{:>6}", true, false) == "true| false");
+
+    assert(format("{}|{}|{}", 0.1, -2.5f, 1e100) == "0.1|-2.5|1e+100");
+    assert(format("{:.3f}|{:e}|{:.2G}", 3.14159, 1500.0, 1e-10)
+           == "3.142|1.500000e+03|1E-10");
+    assert(format("{:+}|{:08.2f}|{:<8.1f}|", 1.5, -3.14159, 2.25)
+           == "+1.5|-0003.14|2.2     |");
+    assert(format("{:.1f}", 1e300).size() == 303);
+    assert(format("{}", 0.5L) == "0.5");
+
+    assert(format("{}|{:.3}|{:>4}|{:-^7}", "abc", std::string("abcdef"),
+                  "ab", "mid") == "abc|abc|  ab|--mid--");
+    assert(format("{}", static_cast<const char*>(nullptr)) == "(null)");
+    assert(format("[{:>4.1}]", string_ref("ab")) == "[   a]");
+    assert(format("{}", std::make_tuple(1, "two", 3.5)) == "(1, two, 3.5)");
+    assert(format("{:>8}", std::make_tuple(1, std::make_tuple(2, 3)))
+           == "(1, (2, 3))");
+    assert(format("[{:>8}]", std::make_tuple(1, 2)) == "[  (1, 2)]");
+
+    std::string s;
+    format_to(std::back_inserter(s), "{}-{}", 'a', 1);
+    assert(s == "a-1");
+
+    s = "x=";
+    format_append(s, "{:>3}|{}", 7, std::make_tuple(1.5, 'c'));
+    assert(s == "x=  7|(1.5, c)");
+    assert(formatted_size("{:>3}|{}", 7, std::make_tuple(1.5, 'c')) == 12);
+    assert(formatted_size("{:.2f}{{", 1e20) == 25);
+    assert(format_to(counting_output_iterator(), "{:x}", 255).count() == 2);
+
+    assert(CALICO_FORMAT("{:04}", 5) == "0005");
+    assert(CALICO_FORMAT("none") == "none");
+
+    // the table built at compile time agrees with the run-time parser
+#define CHECK_CONST_FORMAT(...) \
+    assert(CALICO_FORMAT(__VA_ARGS__) == format(__VA_ARGS__))
+    CHECK_CONST_FORMAT("");
+    CHECK_CONST_FORMAT("}}{{ and a longer literal {{escaped}}");
+    CHECK_CONST_FORMAT("{{}} {}", 1);
+    CHECK_CONST_FORMAT("a longer literal {{escaped}} text {:>10.3}", "s");
+    CHECK_CONST_FORMAT("{:*^9}|{:+#x}|{:08.3f}|{:<5}|{}}}",
+                       42, 255, 3.14159, true, 'c');
+    CHECK_CONST_FORMAT("{:.2s}{:}{: }{:{<4}{:-^#12b}", "abc", 5, 6, 7, 8);
+    CHECK_CONST_FORMAT("{:.0e}/{:G}/{:100000000000x}", 1e10, 1e-10, 1);
+#undef CHECK_CONST_FORMAT
+    s.clear();
+    CALICO_FORMAT_TO(std::back_inserter(s), "{:.1f}", 0.25);
+    assert(s == "0.2");
+
+    static_assert(format_check("{} {:x}", decltype(format_arg_kinds(
+        "", 1, 2))()), "");
+    static_assert(format_check("a longer literal {{escaped}} text {:>10.3}",
+                               decltype(format_arg_kinds("", "s"))()), "");
+    static_assert(!format_check("{}", decltype(format_arg_kinds(""))()), "");
+    static_assert(!format_check("", decltype(format_arg_kinds("", 1))()), "");
+    static_assert(!format_check("{:f}", decltype(format_arg_kinds(
+        "", 1))()), "");
+    static_assert(!format_check("{:d}", decltype(format_arg_kinds(
+        "", 1.0))()), "");
+    static_assert(!format_check("{:+}", decltype(format_arg_kinds(
+        "", "s"))()), "");
+    static_assert(!format_check("{:.2}", decltype(format_arg_kinds(
+        "", 1))()), "");
+    static_assert(!format_check("}", decltype(format_arg_kinds(""))()), "");
+    static_assert(!format_check("{:5", decltype(format_arg_kinds(
+        "", 1))()), "");
+
+    const std::vector<int> v = {3, -1, 4};
+    assert(join(v, ", ") == "3, -1, 4");
+    assert(join(std::vector<int>(), ", ").empty());
+    assert(join(std::list<std::string>{"a", "b"}, "") == "ab");
+    assert(join(transform(v, [](int x) { return x * 0.5; }), " ") ==
+           "1.5 -0.5 2");
+    const char* words[] = {"x", "y"};
+    assert(join(words, "::") == "x::y");
+    std::string joined = "[";
+    join_to(string_appender(joined), integer_range(4), ",") = ']';
+    assert(joined == "[0,1,2,3]");
+    char buf[16];
+    *join_to(buf, std::vector<char>{'p', 'q'}, "-") = '\0';
+    assert(std::string(buf) == "p-q");
+
+    assert(throws_format_error("{} {}", 1));
+    assert(throws_format_error("", 1));
+    assert(throws_format_error("{:s}", 1));
+    assert(throws_format_error("{", 1));
+    assert(throws_format_error("{}}", 1));
+    assert(!throws_format_error("{:>+#08x}", 1));
+    return 0;
+}
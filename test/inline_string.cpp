@@ -0,0 +1,87 @@
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+#include <calico/inline_string.hpp>
+using namespace cal;
+
+namespace {
+
+template<class F>
+bool throws_length_error(F f) {
+    try {
+        f();
+    } catch (const std::length_error&) {
+        return true;
+    }
+    return false;
+}
+
+}
+
+int main() {
+    static_assert(std::is_trivially_copyable<inline_string<30> >::value, "");
+    static_assert(sizeof(inline_string<30>) == 32, "");
+    static_assert(sizeof(inline_string<300>) == 304, "");
+    static_assert(inline_string<30>::capacity() == 30, "");
+
+    inline_string<8> s;
+    assert(s.empty() && s.size() == 0 && *s.c_str() == '\0');
+    s = "key";
+    s += '_';
+    s.append("42");
+    assert(s == "key_42" && "key_42" == s && s.size() == 6);
+    assert(s == std::string("key_42") && s != string_ref("key"));
+    assert(s.c_str()[6] == '\0' && s.front() == 'k' && s.back() == '2');
+    assert(std::string(s.begin(), s.end()) == "key_42");
+    assert(s.at(4) == '4' && s[0] == 'k');
+    s[0] = 'K';
+    assert(s.str() == "Key_42");
+
+    const inline_string<8> copy = s;
+    s.pop_back();
+    assert(copy == "Key_42" && s == "Key_4" && copy != s && s < copy);
+    s.resize(7, '!');
+    assert(s == "Key_4!!");
+    s.clear();
+    assert(s.empty() && s == "");
+
+    // overflow throws and leaves the string unchanged
+    s = "12345678";
+    assert(throws_length_error([&] { s.push_back('9'); }));
+    assert(throws_length_error([&] { s.append("x"); }));
+    assert(throws_length_error([] { inline_string<2> t("abc"); }));
+    assert(s == "12345678");
+
+    // conversions
+    assert((to_inline_string<20>(-1234567890123ll) == "-1234567890123"));
+    assert((to_inline_string<8>(0.25) == "0.25"));
+    assert(throws_length_error([] { to_inline_string<3>(1000); }));
+    inline_string<16> f;
+    format_str_to(f, "%s-%03d", "id", 7);
+    assert(f == "id-007");
+    assert(throws_length_error([&] { format_str_to(f, "%020d", 1); }));
+    assert(f == "id-007");
+    assert(parse<int>(inline_string<8>(" 17")) == 17);
+    int i = 0;
+    assert(parse(inline_string<8>("9x"), i).ec == std::errc() && i == 9);
+    assert(parse<int>(string_ref("-3")) == -3);
+    assert(to_string(copy) == "Key_42");
+    std::ostringstream stream;
+    stream << copy;
+    assert(stream.str() == "Key_42");
+
+    // dense arrays and hashing
+    std::vector<inline_string<15> > keys;
+    std::unordered_set<inline_string<15> > set;
+    for (int k = 0; k != 100; ++k) {
+        keys.push_back(to_inline_string<15>(k * 7919));
+        set.insert(keys.back());
+    }
+    assert(set.size() == 100 && set.count(inline_string<15>("7919")));
+    assert(!set.count(inline_string<15>("7918")));
+    return 0;
+}
@@ -1,7 +1,11 @@
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 #include <iostream>
 #include <list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 #include <calico/iterator.hpp>
 using namespace cal;
@@ -57,8 +61,190 @@ void statictest() {
     }
 }
 
+void test_chunks() {
+    std::vector<int> v;
+    for (int i = 0; i != 10; ++i)
+        v.push_back(i);
+
+    // nearly equal parts, larger ones first
+    auto parts = chunks(v, 4);
+    assert(parts.size() == 4);
+    const std::size_t sizes[] = {3, 3, 2, 2};
+    int next = 0;
+    for (std::size_t k = 0; k != parts.size(); ++k) {
+        assert(parts[k].size() == sizes[k]);
+        for (int x : parts[k])
+            assert(x == next++);
+    }
+    assert(next == 10);
+    assert(chunks(v, 1).front().size() == 10);
+    assert(chunks(v, 12).size() == 12 && chunks(v, 12)[11].empty());
+    assert(chunks(std::vector<int>(), 3).size() == 3);
+
+    // the sub-ranges are mutable if the underlying range is
+    for (auto part : chunks(make_range(v.begin(), v.end()), 3))
+        for (int& x : part)
+            x *= 2;
+    assert(v[9] == 18);
+
+    // fixed-size blocks, composed with reverse_range and transform
+    auto blocks = chunks_of(v, 4);
+    assert(blocks.size() == 3 && blocks.back().size() == 2);
+    assert(chunks_of(v, 5).size() == 2 && chunks_of(v, 20).size() == 1);
+    assert(chunks_of(std::vector<int>(), 4).empty());
+    std::vector<int> firsts;
+    for (auto block : reverse_range(blocks))
+        firsts.push_back(block.front());
+    assert((firsts == std::vector<int>{16, 8, 0}));
+    auto block_sizes = transform(blocks, [](const iterator_range<
+        std::vector<int>::const_iterator>& b) { return b.size(); });
+    assert(block_sizes.size() == 3 && block_sizes[2] == 2);
+
+    // strides, including ones that do not divide the size
+    const std::vector<int> digits = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto odd = stride(digits, 2);
+    assert(odd.size() == 5 && odd[4] == 9 && odd.back() == 9);
+    std::vector<int> reversed(odd.rbegin(), odd.rend());
+    assert((reversed == std::vector<int>{9, 7, 5, 3, 1}));
+    auto thirds = stride(v, 3);
+    assert(thirds.size() == 4);
+    assert(thirds.end() - thirds.begin() == 4);
+    assert(*(thirds.end() - 1) == 18 && thirds.begin() + 4 == thirds.end());
+    assert(stride(v, 1).size() == 10 && stride(v, 100).size() == 1);
+
+    // forward iterators are supported too
+    std::list<int> l(v.begin(), v.end());
+    int sum = 0;
+    for (int x : stride(l, 4))
+        sum += x;
+    assert(sum == 0 + 8 + 16);
+    std::vector<std::size_t> list_sizes;
+    for (auto part : chunks(l, 3))
+        list_sizes.push_back(part.size());
+    assert((list_sizes == std::vector<std::size_t>{4, 3, 3}));
+}
+
+void test_zip() {
+    std::vector<int> a = {1, 2, 3, 4};
+    const std::vector<double> b = {0.5, 1.5, 2.5};
+
+    // random-access: stops at the shorter range, writes through
+    auto z = zip(a, b);
+    static_assert(std::is_same<decltype(z.begin())::iterator_category,
+                               std::random_access_iterator_tag>::value, "");
+    static_assert(std::is_same<decltype(z.begin())::reference,
+                               std::tuple<int&, const double&> >::value, "");
+    assert(z.size() == 3);
+    for (auto&& t : z)
+        std::get<0>(t) *= 10;
+    assert((a == std::vector<int>{10, 20, 30, 4}));
+    assert(std::get<1>(z[2]) == 2.5 && std::get<0>(z.back()) == 30);
+    assert(z.end() - z.begin() == 3 && z.begin() + 3 == z.end());
+    assert(std::get<0>(*--z.end()) == 30);
+    double sum = 0;
+    for (auto&& t : reverse_range(z))
+        sum = sum * 10 + std::get<1>(t);
+    assert(sum == 2.5 * 100 + 1.5 * 10 + 0.5);
+
+    // three ranges, including an integer_range
+    int n = 0;
+    for (auto&& t : zip(index_range(a), a, b)) {
+        assert(std::get<1>(t) == a[std::get<0>(t)]);
+        ++n;
+    }
+    assert(n == 3);
+
+    // otherwise forward: stops at whichever range ends first
+    std::list<int> l = {7, 8};
+    auto zl = zip(l, a);
+    static_assert(std::is_same<decltype(zl.begin())::iterator_category,
+                               std::forward_iterator_tag>::value, "");
+    assert(std::get<1>(zl[1]) == 20);
+    assert(zl.size() == 2);
+    for (auto&& t : zl)
+        std::get<0>(t) += std::get<1>(t);
+    assert((l == std::list<int>{17, 28}));
+    assert(zip(a, l).size() == 2);
+    assert(zip(a, std::list<int>()).empty());
+}
+
+void test_cached_transform() {
+    const std::vector<int> v = {3, 1, 4, 1, 5, 9, 2, 6};
+    int calls = 0;
+    auto square = [&](int x) {
+        ++calls;
+        return std::vector<int>(static_cast<std::size_t>(x), x);
+    };
+
+    // plain transform re-evaluates on every dereference
+    auto plain = transform(v, square);
+    assert(plain.begin()->size() == 3 && calls == 1);
+    assert((*plain.begin()).size() == 3 && calls == 2);
+
+    // the cached one evaluates once per position
+    calls = 0;
+    auto cached = transform(v, square, cache_tag());
+    static_assert(std::is_same<decltype(cached.begin())::reference,
+                               const std::vector<int>&>::value, "");
+    static_assert(std::is_same<decltype(cached.begin())::iterator_category,
+                               std::forward_iterator_tag>::value, "");
+    static_assert(std::is_same<decltype(cached.front()),
+                               std::vector<int> >::value, "");
+    auto it = cached.begin();
+    assert(it->size() == 3 && (*it)[0] == 3 && it->back() == 3);
+    assert(calls == 1);
+    const auto copy = it;
+    assert(copy->size() == 3 && calls == 1);
+    ++it;
+    assert(it->size() == 1 && it->front() == 1 && calls == 2);
+    std::advance(it, 3);
+    assert(it->size() == 5 && calls == 3);
+    assert(std::distance(copy, it) == 4);
+    assert(cached.front().size() == 3 && cached[7].size() == 6);
+    assert(cached.at(5).size() == 9 && calls == 6);
+    assert(cached.size() == 8);
+
+    // each element is evaluated once by a loop that looks at it twice
+    calls = 0;
+    auto largest = cached.begin();
+    std::size_t best = 0;
+    for (auto i = cached.begin(); i != cached.end(); ++i)
+        if (i->size() > best) {
+            best = i->size();
+            largest = i;
+        }
+    assert(std::distance(cached.begin(), largest) == 5
+           && largest->size() == 9);
+    assert(calls == 8);
+
+    // iterators can be assigned even though the lambda cannot
+    auto found = std::max_element(
+        cached.begin(), cached.end(),
+        [](const std::vector<int>& a, const std::vector<int>& b) {
+            return a.size() < b.size();
+        });
+    assert(found == largest);
+
+    // a failed evaluation leaves nothing cached
+    calls = 0;
+    auto throwing = transform(v, [&](int x) -> int {
+        if (calls++ == 0)
+            throw std::runtime_error("first call");
+        return x * 2;
+    }, cache_tag());
+    auto t = throwing.begin();
+    try {
+        *t;
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    assert(*t == 6 && *t == 6 && calls == 2);
+}
 
 int main() {
+    test_chunks();
+    test_zip();
+    test_cached_transform();
+
     integer_iterator<int> nats(0), end(37);
     auto adder = [](int x) { return x + 42; };
     int j = 42;
@@ -71,10 +257,18 @@ int main() {
         assert(i == j);
         --j;
     }
+    assert(j == 41);
     ++j;
     auto&& rev = reverse_range(transform(make_range(nats, end), adder));
     for (auto&& i = rev.crbegin(), end = rev.crend(); i != end; ++i) {
         assert(*i == j);
         ++j;
     }
+    assert(j == 79);
+
+    counting_output_iterator counter;
+    std::fill_n(counter, 5, 'x');
+    assert(counter.count() == 0); // copied by value
+    counter = std::fill_n(counter, 5, 'x');
+    assert(counter.count() == 5);
 }
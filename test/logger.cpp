@@ -0,0 +1,131 @@
+#include <atomic>
+#include <cassert>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <calico/logger.hpp>
+using namespace cal;
+
+namespace {
+
+// Collects the output of a logger.
+struct collector {
+    std::mutex mutex;
+    std::string text;
+    std::atomic<bool> paused{false};
+    std::atomic<bool> waiting{false};
+
+    logger::sink_type sink() {
+        return [this](string_ref s) {
+            while (paused) {
+                waiting = true;
+                std::this_thread::yield();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            text.append(s.data(), s.size());
+        };
+    }
+
+    std::vector<std::string> lines() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<std::string> v;
+        for (string_ref line : split(text, '\n'))
+            v.push_back(line.str());
+        v.pop_back();
+        return v;
+    }
+};
+
+void test_format() {
+    collector out;
+    {
+        logger log(out.sink());
+        std::string temporary = "temporary";
+        assert(log.log("plain"));
+        log.log("{} + {} = {:.2f}", 1, 2u, 3.0);
+        log.log("{} {} {} {}", temporary, string_ref("ref"), 'c', true);
+        temporary = "overwritten";
+        log.log("{:>6}|{:x}", "right", 255);
+        log.log("{} {}", "missing argument");
+        log.flush();
+        const std::vector<std::string> lines = out.lines();
+        assert(lines.size() == 5);
+        assert(lines[0] == "plain" && lines[1] == "1 + 2 = 3.00");
+        assert(lines[2] == "temporary ref c true");
+        assert(lines[3] == " right|ff");
+        assert(lines[4] == "[cal::logger: cal::format: too few arguments]");
+        log.log("after flush");
+    }
+    assert(out.lines().back() == "after flush");
+}
+
+void test_threads(log_overflow overflow) {
+    collector out;
+    logger log(out.sink(), 1024, overflow);
+    std::vector<std::thread> threads;
+    for (int t = 0; t != 4; ++t)
+        threads.emplace_back([&log, t] {
+            for (int i = 0; i != 5000; ++i)
+                log.log("{} {}", t, i);
+        });
+    for (std::thread& thread : threads)
+        thread.join();
+    log.flush();
+    const std::vector<std::string> lines = out.lines();
+    assert(lines.size() + log.dropped() == 20000);
+    if (overflow == log_overflow::block)
+        assert(lines.size() == 20000);
+    // each thread's messages arrive in order
+    int last[4] = {-1, -1, -1, -1};
+    for (const std::string& line : lines) {
+        const int t = parse<int>(line);
+        const int i = parse<int>(line.substr(2));
+        assert(t >= 0 && t < 4 && i > last[t]);
+        last[t] = i;
+    }
+}
+
+void test_overflow() {
+    collector out;
+    logger log(out.sink(), 256, log_overflow::drop);
+    out.paused = true;
+    log.log("first");
+    while (!out.waiting)
+        std::this_thread::yield();
+    // the background thread is now stuck in the sink, so the ring fills up
+    unsigned queued = 0;
+    for (int i = 0; i != 100; ++i)
+        queued += log.log("message {}", i);
+    assert(queued > 0 && queued < 100 && log.dropped() == 100u - queued);
+    assert(!log.log("{}", std::string(100, 'x')));
+    out.paused = false;
+    log.flush();
+    assert(out.lines().size() == 1u + queued);
+    assert(out.lines().back() == "message " + to_string(queued - 1u));
+}
+
+// A thread that logs to many short-lived loggers must not keep their rings
+// alive.
+void test_lifetime() {
+    for (int i = 0; i != 200; ++i) {
+        collector out;
+        logger log(out.sink(), 1 << 20);
+        assert(log.log("round {}", i));
+        log.flush();
+        assert(out.lines() == std::vector<std::string>{"round " +
+                                                       to_string(i)});
+    }
+    assert(_priv::thread_log_rings().rings.size() <= 1);
+}
+
+}
+
+int main() {
+    test_format();
+    test_threads(log_overflow::block);
+    test_threads(log_overflow::drop);
+    test_overflow();
+    test_lifetime();
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <set>
+#include <vector>
+#include <calico/nd_range.hpp>
+using namespace cal;
+
+namespace {
+
+template<class Range>
+std::vector<typename Range::value_type> collect(const Range& r) {
+    return std::vector<typename Range::value_type>(r.begin(), r.end());
+}
+
+template<std::size_t N, class T>
+std::vector<std::array<T, N> > collect_each(const nd_range<N, T>& r) {
+    std::vector<std::array<T, N> > v;
+    r.for_each([&](const std::array<T, N>& i) { v.push_back(i); });
+    return v;
+}
+
+void test_row_major() {
+    std::vector<std::array<std::size_t, 2> > expected;
+    for (std::size_t i = 0; i != 3; ++i)
+        for (std::size_t j = 0; j != 4; ++j)
+            expected.push_back({{i, j}});
+    const nd_range<2> r({3, 4});
+    assert(r.size() == 12 && !r.empty());
+    assert(collect(r) == expected);
+    assert(collect_each(r) == expected);
+    assert(collect(r.collapse()) == expected);
+    assert(r.collapse().size() == 12 && r.collapse()[5] == expected[5]);
+
+    // signed indices with lower bounds
+    std::vector<std::array<int, 3> > expected3;
+    for (int i = -1; i != 1; ++i)
+        for (int j = 2; j != 5; ++j)
+            for (int k = -3; k != -1; ++k)
+                expected3.push_back({{i, j, k}});
+    const nd_range<3, int> r3({{-1, 2, -3}}, {{1, 5, -1}});
+    assert(r3.size() == 12);
+    assert((r3.extents() == std::array<std::size_t, 3>{{2, 3, 2}}));
+    assert(collect(r3) == expected3);
+    assert(collect_each(r3) == expected3);
+    assert(collect(r3.collapse()) == expected3);
+
+    const nd_range<1> line({5});
+    assert(line.size() == 5 && line.begin()->at(0) == 0);
+
+    // empty along any dimension
+    assert(nd_range<2>({0, 4}).empty());
+    assert(nd_range<2>({4, 0}).empty());
+    assert(nd_range<2>({4, 0}).collapse().empty());
+    assert(collect_each(nd_range<2>({4, 0})).empty());
+    assert((nd_range<2, int>({{0, 3}}, {{4, 1}}).empty()));
+    assert((nd_range<2, int>({{0, 3}}, {{4, 1}}).size() == 0));
+}
+
+void test_tiled() {
+    // 3 x 5 in 2 x 2 tiles, including partial tiles on both edges
+    const nd_range<2> r =
+        nd_range<2>({3, 5}).tiled(nd_range<2>::shape_type{{2, 2}});
+    const std::size_t expected[][2] = {
+        {0, 0}, {0, 1}, {1, 0}, {1, 1},
+        {0, 2}, {0, 3}, {1, 2}, {1, 3},
+        {0, 4}, {1, 4},
+        {2, 0}, {2, 1},
+        {2, 2}, {2, 3},
+        {2, 4},
+    };
+    const auto visited = collect(r);
+    assert(visited.size() == 15);
+    for (std::size_t k = 0; k != visited.size(); ++k)
+        assert(visited[k][0] == expected[k][0]
+               && visited[k][1] == expected[k][1]);
+    assert(collect(r.collapse()) == visited);
+    assert(collect_each(r) == visited);
+
+    // odd shapes and tiles: every index once, and collapse agrees
+    for (std::size_t a = 1; a != 6; ++a)
+        for (std::size_t b = 1; b != 5; ++b)
+            for (std::size_t t = 0; t != 4; ++t) {
+                const nd_range<3, int> box({{2, -1, 0}}, {{
+                    static_cast<int>(2 + a), 3, static_cast<int>(b)}},
+                    {{t, t + 1, 2}});
+                const auto order = collect(box);
+                assert(order.size() == box.size());
+                std::set<std::array<int, 3> > unique(order.begin(),
+                                                     order.end());
+                assert(unique.size() == order.size());
+                const std::vector<std::array<int, 3> > sorted(
+                    unique.begin(), unique.end());
+                assert(collect(nd_range<3, int>(box.lower(), box.upper()))
+                       == sorted);
+                assert(collect(box.collapse()) == order);
+                assert(collect_each(box) == order);
+            }
+
+    // collapse splits into pieces
+    std::size_t count = 0;
+    for (auto piece : chunks(nd_range<2>({37, 41}).tiled().collapse(), 4))
+        count += piece.size();
+    assert(count == 37 * 41);
+}
+
+void test_default_tiles() {
+    assert((nd_range<1>::default_tile_sizes()
+            == std::array<std::size_t, 1>{{0}}));
+    const auto t2 = nd_range<2>::default_tile_sizes();
+    assert(t2[0] == t2[1] && t2[0] > 1);
+    assert(t2[0] * t2[1] * 2 * sizeof(double) <= CALICO_L1_CACHE_SIZE);
+    const auto t4 = nd_range<4>::default_tile_sizes(4);
+    assert(t4[0] == 1 && t4[1] > 1 && t4[2] == t4[3]);
+    assert(t4[3] > t2[1]);
+}
+
+}
+
+int main() {
+    test_row_major();
+    test_tiled();
+    test_default_tiles();
+    return 0;
+}
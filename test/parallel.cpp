@@ -0,0 +1,101 @@
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <calico/parallel.hpp>
+using namespace cal;
+
+namespace {
+
+void test_sum(thread_pool& pool) {
+    std::atomic<long> sum(0);
+    std::atomic<int> calls(0);
+    parallel_for(pool, integer_range(100000L), [&](
+        const iterator_range<integer_iterator<long> >& piece) {
+        long s = 0;
+        for (long i : piece)
+            s += i;
+        sum += s;
+        ++calls;
+    });
+    assert(sum == 100000L * 99999L / 2);
+    assert(calls >= 1);
+
+    // each element is visited exactly once
+    std::vector<int> v(12345);
+    parallel_for_each(pool, index_range(v), [&](std::size_t i) { ++v[i]; },
+                      7);
+    for (int x : v)
+        assert(x == 1);
+    parallel_for_each(pool, v, [](int& x) { x *= 3; });
+    for (int x : v)
+        assert(x == 3);
+
+    parallel_for(pool, integer_range(0), [](
+        const iterator_range<integer_iterator<int> >&) { assert(false); });
+}
+
+void test_nested(thread_pool& pool) {
+    std::vector<std::atomic<int> > cells(64 * 64);
+    parallel_for_each(pool, integer_range(64), [&](int i) {
+        parallel_for_each(pool, integer_range(64), [&](int j) {
+            ++cells[static_cast<std::size_t>(i * 64 + j)];
+        }, 4);
+    }, 1);
+    for (const std::atomic<int>& c : cells)
+        assert(c == 1);
+}
+
+void test_exception(thread_pool& pool) {
+    std::atomic<int> visited(0);
+    try {
+        parallel_for_each(pool, integer_range(10000), [&](int i) {
+            ++visited;
+            if (i == 5000)
+                throw std::runtime_error("boom");
+        }, 10);
+        assert(false);
+    } catch (const std::runtime_error& e) {
+        assert(std::string(e.what()) == "boom");
+    }
+    assert(visited <= 10000);
+
+    // the pool remains usable
+    std::atomic<int> count(0);
+    parallel_for_each(pool, integer_range(1000), [&](int) { ++count; });
+    assert(count == 1000);
+}
+
+// Loops started from several outside threads at once.
+void test_outside_callers(thread_pool& pool) {
+    std::atomic<long> total(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t != 3; ++t)
+        threads.emplace_back([&] {
+            for (int k = 0; k != 20; ++k)
+                parallel_for_each(pool, integer_range(1000), [&](int i) {
+                    total += i;
+                });
+        });
+    for (std::thread& t : threads)
+        t.join();
+    assert(total == 3L * 20L * 999L * 1000L / 2);
+}
+
+}
+
+int main() {
+    for (std::size_t n : {1u, 2u, 4u}) {
+        thread_pool pool(n);
+        assert(pool.concurrency() == n);
+        test_sum(pool);
+        test_nested(pool);
+        test_exception(pool);
+        test_outside_callers(pool);
+    }
+    std::atomic<int> count(0);
+    parallel_for_each(integer_range(100), [&](int) { ++count; });
+    assert(count == 100);
+    return 0;
+}
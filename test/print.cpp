@@ -0,0 +1,123 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <calico/print.hpp>
+using namespace cal;
+
+namespace {
+
+// A pipe whose output can be read back.
+struct pipe_pair {
+    int fds[2];
+    pipe_pair() { assert(::pipe(fds) == 0); }
+    ~pipe_pair() {
+        ::close(fds[0]);
+        if (fds[1] >= 0)
+            ::close(fds[1]);
+    }
+    void close_write() {
+        ::close(fds[1]);
+        fds[1] = -1;
+    }
+    std::string read_all() {
+        std::string s;
+        char buf[4096];
+        ssize_t n;
+        while ((n = ::read(fds[0], buf, sizeof(buf))) > 0)
+            s.append(buf, static_cast<std::size_t>(n));
+        return s;
+    }
+    // Reads whatever is available without blocking.
+    std::string read_available() {
+        std::string s;
+        char buf[4096];
+        for (;;) {
+            const ssize_t n = ::read(fds[0], buf, sizeof(buf));
+            if (n <= 0)
+                return s;
+            s.append(buf, static_cast<std::size_t>(n));
+            if (static_cast<std::size_t>(n) < sizeof(buf))
+                return s;
+        }
+    }
+};
+
+}
+
+int main() {
+    {
+        pipe_pair p;
+        {
+            fd_writer out(p.fds[1], print_flush::full, 64);
+            out.print("{} + {} = {}\n", 1, 2.5, "3.5");
+            assert(out.pending() == "1 + 2.5 = 3.5\n");
+            print(out, "{:>4}|", 'x');
+            out.write("tail");
+            try {
+                out.print("{:d}", "bad");
+                assert(false);
+            } catch (const format_error&) {}
+            assert(out.pending() == "1 + 2.5 = 3.5\n   x|tail");
+            out.flush();
+            assert(out.pending().empty());
+            assert(p.read_available() == "1 + 2.5 = 3.5\n   x|tail");
+
+            // filling the buffer writes it out
+            for (int i = 0; i != 20; ++i)
+                out.print("{:04}", i);
+            assert(out.pending().size() < 64);
+            // large writes bypass the buffer but keep the order
+            out.print("[");
+            out.write(std::string(100, 'y'));
+            out.print("]");
+        }
+        p.close_write();
+        std::string expected;
+        for (int i = 0; i != 20; ++i)
+            expected += format("{:04}", i);
+        expected += "[" + std::string(100, 'y') + "]";
+        assert(p.read_all() == expected);
+    }
+    {
+        pipe_pair p;
+        fd_writer out(p.fds[1], print_flush::line);
+        out.print("no newline");
+        assert(!out.pending().empty());
+        out.print(", done\n");
+        assert(out.pending().empty());
+        fd_writer always(p.fds[1], print_flush::always);
+        always.write("now");
+        assert(always.pending().empty());
+        print(p.fds[1], "{}-{}", 1, 2);
+        assert(p.read_available() == "no newline, done\nnow1-2");
+    }
+    {
+        std::FILE* file = std::tmpfile();
+        print(file, "{} {}\n", "file", 42);
+        {
+            fd_writer out(file);
+            out.print("direct {}\n", 1);
+        }
+        std::rewind(file);
+        char line[32];
+        assert(std::fgets(line, sizeof(line), file)
+               && std::string(line) == "file 42\n");
+        assert(std::fgets(line, sizeof(line), file)
+               && std::string(line) == "direct 1\n");
+        std::fclose(file);
+    }
+    {
+        fd_writer out(-1);
+        out.print("lost");
+        bool threw = false;
+        try {
+            out.flush();
+        } catch (const std::system_error&) {
+            threw = true;
+        }
+        assert(threw && out.pending().empty());
+    }
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <calico/simd.hpp>
+#ifdef __unix__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+using cal::_priv::null_terminated_length;
+
+namespace {
+
+// Checks every combination of starting offset and length within a buffer
+// padded with nonzero garbage on both sides.
+template<class T>
+void test_lengths(T fill) {
+    std::vector<T> buf(256, fill);
+    for (std::size_t start = 0; start != 40; ++start) {
+        for (std::size_t n = 0; n != 100; ++n) {
+            buf[start + n] = T();
+            assert(null_terminated_length(&buf[start]) == n);
+            buf[start + n] = fill;
+        }
+    }
+}
+
+#ifdef __unix__
+// Places the terminator on the last element of a page that is followed by an
+// inaccessible page, so any read past it would fault.
+template<class T>
+void test_page_end(T fill) {
+    const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    void* mem = mmap(0, 2 * page, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(mem != MAP_FAILED);
+    char* base = static_cast<char*>(mem);
+    int r = mprotect(base + page, page, PROT_NONE);
+    assert(r == 0);
+    (void)r;
+    T* last = reinterpret_cast<T*>(base + page) - 1;
+    for (std::size_t n = 0; n != 70; ++n) {
+        last[-static_cast<std::ptrdiff_t>(n)] = fill;
+        *last = T();
+        assert(null_terminated_length(last - n) == n);
+    }
+    munmap(mem, 2 * page);
+}
+#endif
+
+// Compares the search kernels against naive searches over random text
+// drawn from a small alphabet, so that matches are frequent.
+void test_search(std::uint32_t seed) {
+    using namespace cal::_priv;
+    std::string text(300, ' ');
+    for (unsigned round = 0; round != 300; ++round) {
+        for (char& c : text) {
+            seed = seed * 1664525u + 1013904223u;
+            c = "abcdefgh\x80\xff"[(seed >> 24) % 10];
+        }
+        seed = seed * 1664525u + 1013904223u;
+        const std::size_t start = seed % 40, n = seed >> 8 & 255u;
+        const char* first = text.data() + start;
+        const char* last = first + n;
+        const std::size_t k = round % 4 + 1;
+        const std::string needle(text, (seed >> 16) % 250, k);
+        const std::string set =
+            round % 3 ? needle : std::string("\x80\xff" "abcdefghijklmnopq");
+        const byte_set bs(set.data(), set.size());
+
+        const char* expected = std::search(first, last,
+                                           needle.begin(), needle.end());
+        assert(find_substring(first, last, needle.data(), k) == expected);
+        expected = std::find_first_of(first, last, set.begin(), set.end());
+        assert(find_set(first, last, bs, true) == expected);
+        assert(scalar_find_set(first, last, bs, true) == expected);
+        const char* p = first;
+        while (p != last && set.find(*p) != std::string::npos)
+            ++p;
+        assert(find_set(first, last, bs, false) == p);
+#ifdef CALICO_SIMD_SSE2
+        if (bs.size <= 16) {
+            assert(sse2_find_set(first, last, bs, false) == p);
+            assert(sse2_find_set(first, last, bs, true) == expected);
+        }
+        if (k > 1) {
+            expected = std::search(first, last, needle.begin(), needle.end());
+            assert(sse2_find_substring(first, last, needle.data(), k)
+                   == expected);
+        }
+#endif
+    }
+}
+
+struct point {
+    int x, y;
+    bool operator==(const point& p) const { return x == p.x && y == p.y; }
+};
+
+}
+
+int main() {
+    test_lengths<char>('x');
+    test_lengths<signed char>(-1);
+    test_lengths<wchar_t>(L'\x1234');
+    test_lengths<char16_t>(u'\x8000');
+    test_lengths<char32_t>(U'\x10ffff');
+    test_lengths<std::uint64_t>(0x100000000ull);
+    test_lengths<const char*>("");
+#ifdef __unix__
+    test_page_end<char>('x');
+    test_page_end<char16_t>(u'\x0100');
+    test_page_end<char32_t>(1);
+    test_page_end<std::uint64_t>(0xffffffff00000000ull);
+#endif
+
+    for (std::uint32_t seed = 0; seed != 20; ++seed)
+        test_search(seed);
+    const char* chars = "0123456789:;<=>?@ABCDEFGHIJ{|}~pq";
+    const cal::_priv::byte_set nibbles(chars, std::strlen(chars));
+    assert(nibbles.nibbles_exact && nibbles.size == 33);
+    const char* text = "xyz|w";
+    assert(cal::_priv::find_set(text, text + 5, nibbles, true) == text + 3);
+
+    // Elements that are only partially zero must not end the scan.
+    const std::uint64_t halves[] = {0xffffffff00000000ull, 0xffffffffull, 0};
+    assert(null_terminated_length(halves) == 2);
+
+    const point points[] = {{1, 0}, {0, 1}, {0, 0}};
+    assert(null_terminated_length(points) == 2);
+    return 0;
+}
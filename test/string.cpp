@@ -1,5 +1,12 @@
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
 #include <calico/string.hpp>
 
 int main() {
@@ -13,5 +20,206 @@ int main() {
     v[0] = 'd';
     assert(std::string(v.begin(), v.end() - 1) == orig);
     assert(format_str("%.3f", 3.2) == "3.200");
+    std::string long_text(300, 'a');
+    format_str_to(long_text, "%s!", long_text.c_str());
+    assert(long_text == std::string(300, 'a') + '!');
+    assert(to_string(-42) == "-42");
+    assert(to_string(18446744073709551615ull) == "18446744073709551615");
+    assert(to_string(3.2) == "3.2");
+    assert(to_string(0.1f) == "0.1");
+    assert(to_string(1e100) == "1e+100");
+    assert(to_string('x') == "x");
+    assert(to_string(true) == "1");
+    std::string appended = "n=";
+    to_chars_append(appended, -42);
+    to_chars_append(appended, ' ');
+    to_chars_append(appended, 0.25);
+    assert(appended == "n=-42 0.25");
+
+    assert(parse<int>("42") == 42);
+    assert(parse<int>(std::string(" +42 ")) == 42);
+    assert(parse<double>("-2.5e3") == -2500);
+    assert(parse<unsigned>("-1") == 0);
+    assert(parse<std::string>("  word rest") == "word");
+    int i = 7;
+    const std::string num = "  12x";
+    from_chars_result r = parse(num, i);
+    assert(r.ec == std::errc() && i == 12 && *r.ptr == 'x');
+    r = parse(std::string("x12"), i);
+    assert(r.ec == std::errc::invalid_argument && i == 12);
+    r = parse(std::string("99999999999"), i);
+    assert(r.ec == std::errc::result_out_of_range && i == 12);
+    r = parse("34 ", i);
+    assert(r.ec == std::errc() && i == 34 && *r.ptr == ' ');
+    std::string w;
+    const char* text = "abc def";
+    r = parse(text, text + 7, w);
+    assert(r.ec == std::errc() && w == "abc" && r.ptr == text + 3);
+
+    const std::string line = "GET /a/b?x=1 HTTP/1.1";
+    string_ref ref = line;
+    assert(ref.size() == line.size() && ref.data() == line.data());
+    assert(ref.substr(4, 8) == "/a/b?x=1" && ref.substr(18) == "1.1");
+    assert(ref.find(' ') == 3 && ref.find("HTTP") == 13);
+    assert(ref.find('z') == string_ref::npos && ref.find("", 5) == 5);
+    assert(ref.starts_with("GET ") && ref.ends_with("/1.1"));
+    assert(string_ref("abc") < string_ref("abd") && "ab" < string_ref("abc"));
+    assert(!ref.empty() && string_ref().empty() && ref.front() == 'G');
+    assert(string_ref(null_terminated_begin("xyz")) == "xyz");
+    assert(to_string(ref.substr(0, 3)) == "GET");
+    std::ostringstream stream;
+    stream << ref.substr(4, 4);
+    assert(stream.str() == "/a/b");
+
+    const char16_t* wide = u"wide string";
+    auto range = null_terminated(wide);
+    assert(range.size() == 11 && range.end() - range.begin() == 11);
+    assert(range[5] == u's' && *range.end() == 0);
+    assert(null_terminated(static_cast<char*>(nullptr)).empty());
+    assert(null_terminated_range<const char>(null_terminated_begin("ab"))
+           .size() == 2);
+    assert(string_ref(null_terminated("ab\0c")) == "ab");
+
+    std::vector<std::string> pieces;
+    for (string_ref piece : split("a,b,,c", ','))
+        pieces.push_back(piece.str());
+    assert((pieces == std::vector<std::string>{"a", "b", "", "c"}));
+    pieces.clear();
+    for (string_ref piece : split(ref.substr(4, 8), "/"))
+        pieces.push_back(piece.str());
+    assert((pieces == std::vector<std::string>{"", "a", "b?x=1"}));
+    assert(split("", ',').size() == 1);
+    assert(split("a::b::", "::").size() == 3);
+    assert(split("abc", "").size() == 1);
+    auto words = split("one two", ' ');
+    auto it = words.begin();
+    assert(it->size() == 3 && *it++ == "one" && *it == "two");
+    assert(++it == words.end());
+
+    const std::string doc = "key = value; other=\"quoted; text\"\n";
+    assert(find(doc, ';') == doc.data() + 11);
+    assert(find_first_of(doc, "=\"") == doc.data() + 4);
+    assert(find_first_not_of(doc, "aekyv =") == doc.data() + 8);
+    assert(search(doc, "quoted") == doc.data() + 20);
+    assert(search(doc, "missing") == doc.data() + doc.size());
+    assert(find(make_range(doc.data(), doc.data() + 3), 'y')
+           == doc.data() + 2);
+    auto nt = null_terminated_begin(doc.c_str());
+    assert(&*find(nt, 'v') == doc.data() + 6);
+    assert(find_first_of(nt, "#") == null_terminated_end(doc.c_str()));
+    assert(&*search(nt, "other") == doc.data() + 13);
+
+    std::string cat = concat("id=", 42, ' ', std::string("name"), ':', -7,
+                             string_ref("xyz", 2), 0.5, 18446744073709551615ull,
+                             null_terminated_begin("!"));
+    assert(cat == "id=42 name:-7xy0.518446744073709551615!");
+    assert(concat().empty() && concat(0) == "0" && concat('a', "") == "a");
+    assert(concat(make_range(line.data(), line.data() + 3)) == "GET");
+    assert(concat(static_cast<short>(-32768), 1.5f) == "-327681.5");
+    std::string log = "x";
+    append(log, '=', 3u, ", y=", 1e100);
+    assert(&append(log) == &log && log == "x=3, y=1e+100");
+    // arguments that refer to the string being grown
+    std::string self(20, 'a');
+    self.shrink_to_fit();
+    append(self, self, '-', self, string_ref(self.data() + 19, 1));
+    assert(self == std::string(40, 'a') + '-' + std::string(21, 'a'));
+
+    pieces.clear();
+    for (string_ref token : tokenize(" \tlet  x=\t1 ;\n", " \t\n;="))
+        pieces.push_back(token.str());
+    assert((pieces == std::vector<std::string>{"let", "x", "1"}));
+    assert(tokenize("", " ").empty() && tokenize(" ,, ", ", ").empty());
+    assert(tokenize("one", "").size() == 1);
+
+    std::string payload(1000, 'p');
+    const char* storage = payload.data();
+    char_buffer buffer(std::move(payload));
+    assert(buffer.data() == storage && buffer.size() == 1000);
+    assert(buffer.c_str()[1000] == '\0' && buffer.back() == 'p');
+    buffer[0] = 'P';
+    char_buffer moved(std::move(buffer));
+    assert(buffer.empty() && *buffer.c_str() == '\0');
+    assert(moved.data() == storage && string_ref(moved).substr(0, 2) == "Pp");
+    const std::string back = moved.release();
+    assert(back.data() == storage && back.size() == 1000 && moved.empty());
+
+    std::unique_ptr<char[]> array(new char[4]);
+    std::memcpy(array.get(), "abcX", 4);
+    char_buffer adopted(std::move(array), 3);
+    assert(std::string(adopted.c_str()) == "abc" && adopted.size() == 3);
+    char* raw = static_cast<char*>(std::malloc(3));
+    raw[0] = 'h';
+    raw[1] = 'i';
+    adopted = char_buffer(raw, 2, std::free);
+    assert(adopted.data() == raw && std::string(adopted.c_str()) == "hi");
+    std::string word;
+    for (char c : adopted)
+        word += c;
+    assert(word == "hi" && adopted.release() == "hi" && adopted.empty());
+    assert(char_buffer(3, 'z').c_str() == std::string("zzz"));
+    assert(string_ref(char_buffer(string_ref("copy"))) == "copy");
+
+    std::string key = " \t Content-Type\r\n";
+    assert(trim(key) == "Content-Type");
+    assert(trim_left(key) == "Content-Type\r\n");
+    assert(trim_right(key) == " \t Content-Type");
+    assert(to_lower_in_place(trim_in_place(key)) == "content-type");
+    assert(to_upper(key) == "CONTENT-TYPE" && key == "content-type");
+    assert(to_lower("\xc3\x89T\xc3\xa9") == "\xc3\x89t\xc3\xa9");
+    assert(trim("  \v\f ").empty() && trim_in_place(key = " ").empty());
+    char field[] = "  Mixed Case  ";
+    const iterator_range<char*> word_range =
+        to_upper_in_place(trim(make_range(&field[0], field + 14)));
+    assert(word_range.first == field + 2 && word_range.size() == 10);
+    assert(string_ref(field) == "  MIXED CASE  ");
+    assert(is_all_space("") && is_all_space(" \n\t") && !is_all_space(" x"));
+    assert(is_all_digits("0123456789") && !is_all_digits("12a"));
+    assert(!is_all_digits("\xb0") && !is_all_digits("/:"));
+    assert(compare_ignore_case("Apple", "apple") == 0);
+    assert(compare_ignore_case("apple", "Banana") < 0);
+    assert(compare_ignore_case("b", "APPLE") > 0);
+    assert(compare_ignore_case("app", "APPLE") < 0);
+    assert(compare_ignore_case("[", "a") < 0);          // as if lowercase
+    assert(equal_ignore_case("HeLLo", "hello"));
+    assert(!equal_ignore_case("@", "`"));
+    assert(hash_ignore_case("HeLLo World") == hash_ignore_case("hello world"));
+    std::unordered_map<std::string, int, ignore_case_hash, ignore_case_equal>
+        headers;
+    headers["Content-Length"] = 5;
+    assert(headers.count("content-length") && headers.size() == 1);
+
+    // compare the vectorized kernels against <cctype> at every length and
+    // alignment around the block sizes
+    std::string bytes;
+    for (int i = 0; i != 300; ++i)
+        bytes += static_cast<char>(i * 37 % 256);
+    for (std::size_t off = 0; off != 33; ++off) {
+        for (std::size_t n = 0; n != 100; ++n) {
+            const std::string sub = bytes.substr(off, n);
+            std::string lower = sub, upper = sub, spaces(n, ' ');
+            for (std::size_t i = 0; i != n; ++i) {
+                const unsigned char c = static_cast<unsigned char>(sub[i]);
+                if (c < 0x80) {
+                    lower[i] = static_cast<char>(std::tolower(c));
+                    upper[i] = static_cast<char>(std::toupper(c));
+                }
+            }
+            assert(to_lower(sub) == lower && to_upper(sub) == upper);
+            assert(compare_ignore_case(sub, upper) == 0);
+            assert(hash_ignore_case(sub) == hash_ignore_case(upper));
+            if (n) {
+                std::string other = lower;
+                other[n - 1] = static_cast<char>(other[n - 1] ^ 1);
+                assert((compare_ignore_case(lower, other) < 0)
+                       == (to_lower(lower) < to_lower(other)));
+                spaces[n / 2] = sub[0];
+                assert(is_all_space(spaces) == !!std::isspace(
+                           static_cast<unsigned char>(sub[0])));
+                assert(trim(spaces).size()
+                       == (is_all_space(spaces) ? 0u : 1u));
+            }
+        }
+    }
     return 0;
 }
@@ -0,0 +1,62 @@
+#include <cassert>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include <calico/string_pool.hpp>
+using namespace cal;
+
+int main() {
+    string_pool pool;
+    assert(pool.size() == 0 && !pool.find("a") && !string_pool::handle());
+
+    const string_pool::handle a = pool.intern("alpha");
+    const string_pool::handle b = pool.intern(std::string("beta"));
+    const string_pool::handle e = pool.intern("");
+    assert(a && b && e && a != b && a != e);
+    assert(pool.intern(string_ref("alpha!", 5)) == a && pool.find("beta") == b);
+    assert(pool.str(a) == "alpha" && std::string(pool.c_str(b)) == "beta");
+    assert(pool.str(e).empty() && *pool.c_str(e) == '\0');
+    assert(pool.size() == 3);
+    assert(string_pool::handle(a.value()) == a);
+    const std::string big(100000, 'x');
+    assert(pool.str(pool.intern(big)) == big);
+
+    // enough strings to span many blocks and rehashes in every shard
+    std::vector<string_pool::handle> handles;
+    for (int i = 0; i != 50000; ++i)
+        handles.push_back(pool.intern(to_string(i)));
+    std::unordered_set<string_pool::handle> set(handles.begin(),
+                                                handles.end());
+    assert(set.size() == handles.size() && pool.size() == 50004);
+    for (std::size_t i = 0; i != 50000; ++i) {
+        assert(pool.str(handles[i]) == to_string(i));
+        assert(pool.find(to_string(i)) == handles[i]);
+    }
+    assert(!pool.find("50000"));
+
+    // concurrent interning of overlapping sets agrees on the handles
+    string_pool shared;
+    std::vector<std::vector<string_pool::handle> > results(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t != 4; ++t) {
+        threads.emplace_back([&shared, &results, t] {
+            for (std::size_t i = 0; i != 20000; ++i) {
+                const std::size_t k = (i * 7 + t * 1000) % 20000;
+                const string_pool::handle h =
+                    shared.intern("key" + to_string(k));
+                assert(shared.str(h) == "key" + to_string(k));
+                results[t].push_back(h);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    assert(shared.size() == 20000);
+    for (std::size_t t = 0; t != 4; ++t)
+        for (std::size_t i = 0; i != 20000; ++i) {
+            const std::size_t k = (i * 7 + t * 1000) % 20000;
+            assert(results[t][i] == shared.find("key" + to_string(k)));
+        }
+    return 0;
+}
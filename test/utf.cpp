@@ -0,0 +1,200 @@
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <calico/utf.hpp>
+using namespace cal;
+
+namespace {
+
+// Offset of the first invalid sequence, or -1.
+std::ptrdiff_t invalid_at(const std::string& s) {
+    const char* p = utf8_find_invalid(s.data(), s.data() + s.size());
+    const char* q = _priv::scalar_utf8_find_invalid(s.data(),
+                                                    s.data() + s.size());
+    assert(p == q);
+    return p == s.data() + s.size() ? -1 : p - s.data();
+}
+
+bool throws_range_error(const std::string& s) {
+    try {
+        utf8_to_utf16(s);
+    } catch (const std::range_error&) {
+        return true;
+    }
+    return false;
+}
+
+void test_validate() {
+    assert(invalid_at("") == -1);
+    assert(invalid_at("plain ascii") == -1);
+    assert(invalid_at("\xc2\x80 \xdf\xbf \xe0\xa0\x80 \xed\x9f\xbf "
+                      "\xee\x80\x80 \xf0\x90\x80\x80 \xf4\x8f\xbf\xbf") == -1);
+    assert(invalid_at("ab\x80") == 2);           // lone continuation
+    assert(invalid_at("\xc0\xaf") == 0);         // overlong
+    assert(invalid_at("x\xe0\x9f\xbf") == 1);    // overlong
+    assert(invalid_at("\xed\xa0\x80") == 0);     // surrogate
+    assert(invalid_at("\xf4\x90\x80\x80") == 0); // beyond U+10FFFF
+    assert(invalid_at("\xf5\x80\x80\x80") == 0);
+    assert(invalid_at("abc\xe2\x82") == 3);      // truncated
+    assert(invalid_at("\xe2\x82z") == 0);
+
+    // Errors at every position relative to the 32-byte blocks, including
+    // sequences that straddle them.
+    const std::string errors[] = {"\x80", "\xc3", "\xe2\x82", "\xf0\x9f\x98",
+                                  "\xc0\x80", "\xed\xbf\xbf", "\xff"};
+    const std::string valid[] = {"a", "\xc3\xa9", "\xe2\x82\xac",
+                                 "\xf0\x9f\x98\x80"};
+    for (const std::string& bad : errors) {
+        for (std::size_t n = 0; n != 100; ++n) {
+            std::string s;
+            while (s.size() < n)
+                s += valid[s.size() % 4];
+            const std::ptrdiff_t at = static_cast<std::ptrdiff_t>(s.size());
+            assert(invalid_at(s) == -1);
+            assert(invalid_at(s + bad) == at);
+            assert(invalid_at(s + bad + std::string(70, 'x')) == at);
+            assert(invalid_at(s + bad + valid[n % 4] + "tail") == at);
+        }
+    }
+}
+
+void test_convert() {
+    const std::string utf8 = "x\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80!";
+    const std::u16string utf16 = u"xé€\U0001f600!";
+    const std::u32string utf32 = U"xé€\U0001f600!";
+    assert(utf8_to_utf16(utf8) == utf16);
+    assert(utf8_to_utf32(utf8) == utf32);
+    assert(utf16_to_utf8(utf16) == utf8);
+    assert(utf32_to_utf8(utf32) == utf8);
+    assert(utf8_to_utf16<std::uint16_t>("ok").size() == 2);
+    assert(utf8_to_utf16("").empty() && utf16_to_utf8(std::u16string())
+           .empty());
+
+    // long ASCII runs go through the vectorized paths
+    std::string ascii;
+    for (int i = 0; i != 200; ++i)
+        ascii += static_cast<char>(' ' + i % 95);
+    const std::string mixed = ascii + utf8 + ascii + utf8;
+    assert(utf16_to_utf8(utf8_to_utf16(mixed)) == mixed);
+    assert(utf32_to_utf8(utf8_to_utf32(mixed)) == mixed);
+
+    // strict mode reports the offending position
+    char16_t buf[16];
+    const char* bad = "ab\xe2\x82zz";
+    const utf_result<char, char16_t> r = utf8_to_utf16(bad, bad + 6, buf);
+    assert(r.ec == std::errc::illegal_byte_sequence && r.ptr == bad + 2);
+    assert(r.out == buf + 2 && buf[1] == u'b');
+    assert(throws_range_error(bad) && !throws_range_error("fine"));
+
+    // replacement follows the maximal subpart rule
+    assert(utf8_to_utf32("a\xe2\x82z\xc0\xaf\xf0\x9f", utf_errors::replace)
+           == U"a�z���");
+    const std::u16string lone = {u'a', 0xd800, u'b', 0xdc00};
+    assert(utf16_to_utf8(lone, utf_errors::replace)
+           == "a\xef\xbf\xbd" "b\xef\xbf\xbd");
+    char out[16];
+    const utf_result<char16_t, char> s =
+        utf16_to_utf8(lone.data(), lone.data() + 4, out);
+    assert(s.ec == std::errc::illegal_byte_sequence
+           && s.ptr == lone.data() + 1);
+    const std::u32string big = {U'a', 0x110000, 0xdfff};
+    assert(utf32_to_utf8(big, utf_errors::replace)
+           == "a\xef\xbf\xbd\xef\xbf\xbd");
+
+    // every scalar value round-trips
+    std::u32string all;
+    for (char32_t c = 1; c != 0x110000; ++c)
+        if (c < 0xd800 || c > 0xdfff)
+            all += c;
+    const std::string all8 = utf32_to_utf8(all);
+    assert(utf8_valid(all8));
+    assert(utf8_to_utf32(all8) == all);
+    assert(utf8_to_utf16(all8).size() == all.size() + 0x100000);
+    assert(utf16_to_utf8(utf8_to_utf16(all8)) == all8);
+}
+
+// Checks that iterating forward, iterating backward, and skipping ahead all
+// agree with the replacing converter.
+void check_iterate(const std::string& s) {
+    const std::u32string expected = utf8_to_utf32(s, utf_errors::replace);
+    const utf8_range r = utf8_chars(s);
+    assert(std::u32string(r.begin(), r.end()) == expected);
+    assert(std::u32string(r.rbegin(), r.rend())
+           == std::u32string(expected.rbegin(), expected.rend()));
+    const char* first = s.data();
+    const char* last = first + s.size();
+    std::size_t n = 0;
+    for (utf8_iterator i = r.begin(); i != r.end(); ++i, ++n)
+        assert(utf8_advance(first, last, n) == i.base());
+    assert(utf8_advance(first, last, n) == last);
+    assert(utf8_advance(first, last, n + 5) == last);
+    assert(utf8_length(s) == _priv::scalar_utf8_count_leads(first, last));
+    if (utf8_valid(s))
+        assert(utf8_length(s) == expected.size());
+}
+
+void test_iterate() {
+    check_iterate("");
+    check_iterate("a");
+    check_iterate("\xff");
+    check_iterate("\x80\x80");
+    check_iterate("a\xe4\xb8\x96" "b");
+    check_iterate("\xe4\xb8\xe4\xb8\x96");     // truncated, then valid
+    check_iterate("\xf0\x9f\x98\x80\x80");     // stray continuation
+    check_iterate("\xe0\x80\x80\xed\xa0\x80"); // overlong, surrogate
+
+    const std::string s = "x\xc3\xa9\xe4\xb8\x96\xf0\x9f\x98\x80";
+    utf8_iterator i = utf8_chars(s).begin();
+    assert(*i++ == U'x');
+    assert(*i == 0xe9 && i.base() == s.data() + 1);
+    assert(*++i == 0x4e16);
+    assert(*++i == 0x1f600);
+    assert(++i == utf8_chars(s).end());
+    assert(*--i == 0x1f600);
+    assert(*i-- == 0x1f600 && *i == 0x4e16);
+    assert(utf8_chars(s).size() == 4);
+    assert(utf8_chars(s).back() == 0x1f600);
+    assert(utf8_length(s) == 4);
+
+    // long runs cross the SIMD block boundaries and the counter flushes
+    std::string big;
+    for (int k = 0; k != 1000; ++k)
+        big += k % 7 ? "ascii text " : "\xc3\xa9\xe4\xb8\x96 ";
+    check_iterate(big);
+    assert(utf8_length(big) == utf8_to_utf32(big).size());
+}
+
+// Compares validation against the scalar decoder on random mutations of
+// valid text.
+void test_random(std::uint32_t seed) {
+    const std::string base = utf32_to_utf8(std::u32string(
+        U"Grüße, 世界! \U0001f600 plain ascii text here"));
+    for (int round = 0; round != 2000; ++round) {
+        std::string s;
+        for (int i = 0; i != 4; ++i)
+            s += base;
+        for (int k = 0; k != round % 3; ++k) {
+            seed = seed * 1664525u + 1013904223u;
+            s[(seed >> 8) % s.size()] = static_cast<char>(seed >> 24);
+        }
+        seed = seed * 1664525u + 1013904223u;
+        s.resize((seed >> 8) % s.size());
+        invalid_at(s);
+        const std::u16string w = utf8_to_utf16(s, utf_errors::replace);
+        assert(utf8_valid(utf16_to_utf8(w)));
+        check_iterate(s);
+    }
+}
+
+}
+
+int main() {
+    test_validate();
+    test_convert();
+    test_iterate();
+    for (std::uint32_t seed = 0; seed != 10; ++seed)
+        test_random(seed);
+    return 0;
+}
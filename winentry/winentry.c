@@ -1,6 +1,7 @@
 /* Link with: (kernel32.lib) user32.lib shell32.lib */
 #include <errno.h>
 #include <stdio.h>
+#include <wchar.h>
 #ifdef _WIN32
 #include <fcntl.h>
 #include <io.h>
@@ -11,6 +12,7 @@
 #endif
 #include "winentry.h"
 #ifdef __cplusplus
+#include <calico/utf.hpp>
 extern "C" {
 #endif
 
@@ -124,42 +126,49 @@ static void console_deinit(void) {
     SetConsoleOutputCP(prev_console_output_cp);
 }
 
-/* Creates an argument vector in UTF-8 by converting from UTF-16. */
+/* Converts `len` UTF-16 code units to UTF-8, replacing unpaired surrogates
+   with U+FFFD.  The destination must have room for `3 * len` bytes.  Returns
+   the number of bytes written. */
+static int utf16_to_utf8(char *dst, const wchar_t *src, int len) {
+#ifdef __cplusplus
+    return (int) (cal::utf16_to_utf8(src, src + len, dst,
+                                     cal::utf_errors::replace).out - dst);
+#else
+    return len ? WideCharToMultiByte(CP_UTF8, 0, src, len,
+                                     dst, 3 * len, 0, 0) : 0;
+#endif
+}
+
+/* Creates an argument vector in UTF-8 by converting from UTF-16.  Each
+   argument is converted once into space reserved for the worst case (3 bytes
+   per UTF-16 code unit), after which the block is shrunk in place. */
 static int argv_create(int argc) {
     wchar_t **argvw = wmain_args.argv;
-    int i, *lens, total_len = 0, argn = argc + 1;
-
-    /* store the UTF-8 lengths in an array */
-    lens = (int *) HeapAlloc(heap, 0, argc * sizeof(*lens));
-    if (!lens)
-        return (int) GetLastError();
+    int i, total_len = 0, argn = argc + 1;
+    char *p;
+    void *shrunk;
 
-    /* query the lengths required */
-    for (i = 0; i != argc; ++i) {
-        int len = WideCharToMultiByte(CP_UTF8, 0, argvw[i], -1, 0, 0, 0, 0);
-        lens[i] = len;
-        total_len += len;
-    }
+    for (i = 0; i != argc; ++i)
+        total_len += 3 * (int) wcslen(argvw[i]) + 1;
 
     /* store argv as a single chunk: `argv argv[0] ... argv[argc - 1]` */
     argv = (char **) HeapAlloc(heap, 0, argn * sizeof(*argv) +
                                         total_len * sizeof(**argv));
-    if (!argv) {
-        HeapFree(heap, 0, lens);
+    if (!argv)
         return (int) GetLastError();
-    }
-    argv[0] = (char *) &argv[argn];
+    p = (char *) &argv[argn];
     for (i = 0; i != argc; ++i) {
-
-        /* find the appropriate offset within the array */
-        int len = lens[i];
-        argv[i + 1] = argv[i] + len;
-
-        /* convert to UTF-8 */
-        WideCharToMultiByte(CP_UTF8, 0, argvw[i], -1, argv[i], len, 0, 0);
+        argv[i] = p;
+        p += utf16_to_utf8(p, argvw[i], (int) wcslen(argvw[i]));
+        *p++ = '\0';
     }
     argv[argc] = 0;                     /* required by the standard */
-    HeapFree(heap, 0, lens);
+
+    /* release the unused space; the pointers remain valid since the block
+       is not allowed to move */
+    shrunk = HeapReAlloc(heap, HEAP_REALLOC_IN_PLACE_ONLY, argv,
+                         (SIZE_T) (p - (char *) argv));
+    (void) shrunk;
     return 0;
 }
 